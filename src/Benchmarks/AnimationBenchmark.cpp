@@ -0,0 +1,85 @@
+#include "Benchmarks.h"
+#include "../ECS/Systems.h"
+#include "../Renderer/AnimatedSprite.h"
+#include "../Renderer/ShaderProgram.h"
+#include "../Renderer/SpriteBatch.h"
+#include "../Renderer/Texture2D.h"
+#include "../Resources/ResourceManager.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace Benchmarks {
+    namespace {
+        const size_t ANIMATED_ENTITIES_COUNT = 100000;
+        const size_t ANIMATED_SPRITES_COUNT = 10000;
+        const unsigned int REPETITIONS = 5;
+        const float DELTA_TIME = 1.f / 60.f;
+    }
+
+    /* Animation of 100k entities (playback, then playback with extraction and render) and of animated sprite objects */
+    bool runAnimation(ResourceManager& resourceManager) {
+        if (!resourceManager.loadManifest("res/manifest.txt")) {
+            return false;
+        }
+        std::shared_ptr <Renderer::Texture2D> pAtlas = resourceManager.getTexture("DefaultTextureAtlas");
+        std::shared_ptr <Renderer::ShaderProgram> pBatchShaderProgram = resourceManager.getShaderProgram("SpriteBatchShaderProgram");
+        std::shared_ptr <Renderer::ShaderProgram> pSpriteShaderProgram = resourceManager.getShaderProgram("SpriteShaderProgram");
+        const Renderer::AnimationLibrary& animations = resourceManager.getAnimationLibrary();
+        const Renderer::AnimationClipId clipId = animations.getClipId("BrickCycle");
+        if (!pAtlas || !pBatchShaderProgram || !pSpriteShaderProgram || clipId == Renderer::INVALID_ANIMATION_CLIP_ID) {
+            return false;
+        }
+        const Renderer::AnimationClip& clip = animations.getClip(clipId);
+
+        /* Entities start at random points of the clip and play at different speeds, so frames change at different times */
+        std::mt19937 random(1);
+        std::uniform_real_distribution<float> coordinate(0.f, 1000.f);
+        std::uniform_real_distribution<float> phase(0.f, clip.duration());
+        std::uniform_real_distribution<float> speed(0.5f, 2.f);
+
+        ECS::World world;
+        world.reserve(ECS::componentMask<ECS::Transform, ECS::SpriteRef, ECS::Animation>(), ANIMATED_ENTITIES_COUNT);
+        for (size_t i = 0; i < ANIMATED_ENTITIES_COUNT; ++i) {
+            world.create(ECS::Transform{ glm::vec2(coordinate(random), coordinate(random)), glm::vec2(16.f), 0.f },
+                         ECS::SpriteRef{ pAtlas.get(), 0 },
+                         ECS::Animation{ clipId, phase(random), speed(random) });
+        }
+
+        report("animation", "ecs playback", measure(REPETITIONS, [&world, &animations]() {
+            ECS::updateAnimations(world, animations, DELTA_TIME);
+        }), ANIMATED_ENTITIES_COUNT);
+
+        Renderer::SpriteBatch spriteBatch(pBatchShaderProgram);
+        pBatchShaderProgram->use();
+        pBatchShaderProgram->setMatrix4("projectionMat", glm::ortho(0.f, 1000.f, 0.f, 1000.f, -100.f, 100.f));
+        report("animation", "ecs playback, extraction and render", measure(REPETITIONS, [&world, &animations, &spriteBatch]() {
+            ECS::updateAnimations(world, animations, DELTA_TIME);
+            ECS::extractSprites(world, spriteBatch);
+            spriteBatch.render();
+            glFinish();
+        }), ANIMATED_ENTITIES_COUNT);
+        std::cout << "animation/draw calls: " << spriteBatch.drawCalls() << std::endl;
+
+        /* Sprite objects rewrite their texture coordinates buffer on every frame change */
+        std::vector <std::unique_ptr <Renderer::AnimatedSprite>> sprites;
+        sprites.reserve(ANIMATED_SPRITES_COUNT);
+        for (size_t i = 0; i < ANIMATED_SPRITES_COUNT; ++i) {
+            sprites.push_back(std::make_unique<Renderer::AnimatedSprite>(pAtlas, "brick", pSpriteShaderProgram,
+                                                                         glm::vec2(coordinate(random), coordinate(random)), glm::vec2(16.f)));
+            sprites.back()->play(&clip, speed(random));
+            sprites.back()->update(phase(random));
+        }
+        report("animation", "animated sprites playback", measure(REPETITIONS, [&sprites]() {
+            for (const std::unique_ptr <Renderer::AnimatedSprite>& pSprite : sprites) {
+                pSprite->update(DELTA_TIME);
+            }
+            glFinish();
+        }), ANIMATED_SPRITES_COUNT);
+        return true;
+    }
+}
@@ -0,0 +1,107 @@
+#include "Benchmarks.h"
+#include "../Renderer/ShaderProgram.h"
+#include "../Renderer/Texture2D.h"
+#include "../Renderer/TileMapRenderer.h"
+#include "../Resources/ResourceManager.h"
+#include "../Scene/AutoTiler.h"
+#include "../System/JobSystem.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace Benchmarks {
+    namespace {
+        const int MAP_SIZE = 1024;              // Cells per side, 1M cells
+        const float TILE_SIZE = 1.f;
+        const unsigned int HITS_COUNT = 10000;
+        const unsigned int REPETITIONS = 3;
+        const Scene::TileMap::TileType BRICK = 1;
+        const Scene::TileMap::TileType CONCRETE = 2;
+    }
+
+    /*
+    Auto-tiling of a 1024x1024 map of brick walls and concrete blocks: a full retile on one thread and split
+    between the worker threads, a full upload of the cell images, and single brick hits that retile 3x3 cells
+    and upload only the changed ones. After the hits the images must match a full retile
+    */
+    bool runAutoTile(ResourceManager& resourceManager) {
+        if (!resourceManager.loadManifest("res/manifest.txt")) {
+            return false;
+        }
+        std::shared_ptr <Renderer::Texture2D> pAtlas = resourceManager.getTexture("DefaultTextureAtlas");
+        std::shared_ptr <Renderer::ShaderProgram> pShaderProgram = resourceManager.getShaderProgram("TileMapShaderProgram");
+        if (!pAtlas || !pShaderProgram) {
+            return false;
+        }
+
+        Scene::TileMap tileMap(MAP_SIZE, MAP_SIZE, glm::vec2(TILE_SIZE));
+        tileMap.fillWithBlocks(1, BRICK, CONCRETE);
+        Scene::AutoTiler autoTiler(tileMap);
+        autoTiler.setEdgeImages(BRICK, Scene::AutoTiler::EdgeImages::fromAtlas(*pAtlas, "brick"));
+        autoTiler.setImage(CONCRETE, static_cast<Scene::AutoTiler::CellImage>(pAtlas->getSubTextureId("concrete")));
+
+        const size_t cellsCount = static_cast<size_t>(MAP_SIZE) * MAP_SIZE;
+        report("autotile", "full retile (calling thread)", measure(REPETITIONS, [&autoTiler]() {
+            autoTiler.retile(glm::ivec2(0), glm::ivec2(MAP_SIZE - 1));
+        }), cellsCount);
+        report("autotile", "full retile (parallel)", measure(REPETITIONS, [&autoTiler]() {
+            autoTiler.retileAll();
+        }), cellsCount);
+        std::cout << "autotile/worker threads: " << System::JobSystem::instance().threadCount() << std::endl;
+
+        Renderer::TileMapRenderer renderer(pAtlas, pShaderProgram, MAP_SIZE, MAP_SIZE, glm::vec2(TILE_SIZE));
+        report("autotile", "full upload", measure(REPETITIONS, [&renderer, &autoTiler]() {
+            renderer.upload(autoTiler.images());
+            glFinish();
+        }), cellsCount);
+        renderer.takeUploadedBytes();
+        autoTiler.clearDirtyRects();
+
+        /* A hit destroys a brick, a hit on an empty cell builds one, so the map keeps its density */
+        std::mt19937 random(1);
+        std::uniform_int_distribution<int> cell(0, MAP_SIZE - 1);
+        size_t changedImagesCount = 0;
+        const double hitsMilliseconds = measure(1, [&]() {
+            for (unsigned int hit = 0; hit < HITS_COUNT; ++hit) {
+                const int column = cell(random);
+                const int row = cell(random);
+                const Scene::TileMap::TileType type = tileMap.getTile(column, row);
+                if (type == CONCRETE) {
+                    continue;
+                }
+                autoTiler.setTile(column, row, type == BRICK ? Scene::TileMap::EMPTY_TILE : BRICK);
+                changedImagesCount += autoTiler.lastChangedImagesCount();
+                glm::ivec2 first, last;
+                while (autoTiler.takeDirtyRect(first, last)) {
+                    renderer.uploadRegion(autoTiler.images(), first, last);
+                }
+            }
+            glFinish();
+        });
+        report("autotile", "brick hit (retile 3x3 and upload)", hitsMilliseconds, HITS_COUNT);
+        std::cout << "autotile/changed images per hit: " << static_cast<double>(changedImagesCount) / HITS_COUNT
+                  << ", uploaded bytes per hit: " << static_cast<double>(renderer.takeUploadedBytes()) / HITS_COUNT
+                  << " (full upload: " << cellsCount * sizeof(Scene::AutoTiler::CellImage) << ")" << std::endl;
+
+        /* Local retiles must leave the same images as a full retile */
+        const std::vector <Scene::AutoTiler::CellImage> images(autoTiler.images(), autoTiler.images() + cellsCount);
+        autoTiler.retileAll();
+        if (!std::equal(images.begin(), images.end(), autoTiler.images())) {
+            std::cerr << "autotile: images after the hits differ from a full retile" << std::endl;
+            return false;
+        }
+
+        pShaderProgram->use();
+        pShaderProgram->setMatrix4("projectionMat", glm::ortho(0.f, MAP_SIZE * TILE_SIZE, 0.f, MAP_SIZE * TILE_SIZE, -100.f, 100.f));
+        report("autotile", "render (one draw call)", measure(REPETITIONS, [&renderer]() {
+            renderer.render();
+            glFinish();
+        }), cellsCount);
+        return true;
+    }
+}
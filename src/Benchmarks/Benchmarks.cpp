@@ -0,0 +1,73 @@
+#include "Benchmarks.h"
+
+#include <chrono>
+#include <iostream>
+#include <limits>
+
+namespace Benchmarks {
+    namespace {
+        /* Benchmark names and functions */
+        struct Benchmark {
+            const char* name;
+            bool (*function)(ResourceManager& resourceManager);
+        };
+
+        const Benchmark BENCHMARKS[] = {
+            { "entities", runEntities },
+            { "scene", runScene },
+            { "animation", runAnimation },
+            { "particles", runParticles },
+            { "gpu-particles", runGpuParticles },
+            { "text", runText },
+            { "atlas", runDynamicAtlas },
+            { "collision", runCollision },
+            { "broadphase", runBroadPhase },
+            { "autotile", runAutoTile },
+            { "terrain", runTerrain },
+            { "layers", runLayers },
+            { "capture", runCapture },
+            { "resources", runResources },
+        };
+    }
+
+    /* Run a benchmark by name */
+    bool run(const std::string& benchmarkName, ResourceManager& resourceManager) {
+        bool isFound = false;
+        bool isSuccessful = true;
+        for (const Benchmark& benchmark : BENCHMARKS) {
+            if (benchmarkName == "all" || benchmarkName == benchmark.name) {
+                isFound = true;
+                isSuccessful = benchmark.function(resourceManager) && isSuccessful;
+            }
+        }
+        if (!isFound) {
+            std::cerr << "Unknown benchmark: " << benchmarkName << ". Available benchmarks: all";
+            for (const Benchmark& benchmark : BENCHMARKS) {
+                std::cerr << ", " << benchmark.name;
+            }
+            std::cerr << std::endl;
+        }
+        return isFound && isSuccessful;
+    }
+
+    /* Best time of several runs of the function in milliseconds */
+    double measure(const unsigned int repetitions, const std::function<void()>& function) {
+        double bestMilliseconds = std::numeric_limits<double>::max();
+        for (unsigned int i = 0; i < repetitions; ++i) {
+            const auto startTime = std::chrono::steady_clock::now();
+            function();
+            const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+            bestMilliseconds = milliseconds < bestMilliseconds ? milliseconds : bestMilliseconds;
+        }
+        return bestMilliseconds;
+    }
+
+    /* Print the result of a benchmark case */
+    void report(const std::string& benchmarkName, const std::string& caseName, const double milliseconds, const size_t itemsCount) {
+        std::cout << benchmarkName << "/" << caseName << ": " << milliseconds << " ms";
+        if (itemsCount != 0) {
+            std::cout << ", " << milliseconds * 1e6 / static_cast<double>(itemsCount) << " ns per item (" << itemsCount << " items)";
+        }
+        std::cout << std::endl;
+    }
+}
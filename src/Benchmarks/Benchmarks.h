@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+class ResourceManager;
+
+/*
+Microbenchmarks of engine modules, run with `--benchmark <name>` (`--benchmark all` runs every benchmark).
+They run after the GL context is created, so benchmarks may use GL and load resources
+*/
+namespace Benchmarks {
+    /* Run a benchmark by name. Returns false if there is no such benchmark or it failed */
+    bool run(const std::string& benchmarkName, ResourceManager& resourceManager);
+
+    /* Best time of several runs of the function in milliseconds */
+    double measure(const unsigned int repetitions, const std::function<void()>& function);
+    /* Print the result of a benchmark case with the time per item */
+    void report(const std::string& benchmarkName, const std::string& caseName, const double milliseconds, const size_t itemsCount);
+
+    /* Benchmarks of the modules */
+    bool runEntities(ResourceManager& resourceManager);
+    bool runScene(ResourceManager& resourceManager);
+    bool runAnimation(ResourceManager& resourceManager);
+    bool runParticles(ResourceManager& resourceManager);
+    bool runGpuParticles(ResourceManager& resourceManager);
+    bool runText(ResourceManager& resourceManager);
+    bool runDynamicAtlas(ResourceManager& resourceManager);
+    bool runCollision(ResourceManager& resourceManager);
+    bool runBroadPhase(ResourceManager& resourceManager);
+    bool runAutoTile(ResourceManager& resourceManager);
+    bool runTerrain(ResourceManager& resourceManager);
+    bool runLayers(ResourceManager& resourceManager);
+    bool runCapture(ResourceManager& resourceManager);
+    bool runResources(ResourceManager& resourceManager);
+}
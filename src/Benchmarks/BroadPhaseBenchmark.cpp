@@ -0,0 +1,114 @@
+#include "Benchmarks.h"
+#include "../ECS/Systems.h"
+#include "../Physics/BroadPhase.h"
+#include "../Scene/TileMap.h"
+#include "../System/FrameArena.h"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+
+namespace Benchmarks {
+    namespace {
+        const size_t MOVERS_COUNT = 10000;
+        const int MAP_SIZE = 256;               // Cells per side
+        const float TILE_SIZE = 16.f;
+        const unsigned int FRAMES_COUNT = 300;
+        const float DELTA_TIME = 1.f / 60.f;
+    }
+
+    /*
+    10k movers (tank-sized 12..28 units, up to 120 units per second) on a 256x256 map with 20% solid tiles:
+    per frame the colliders follow the transforms, the broad phase finds mover pairs and tile contacts.
+    The first frame sorts the axis from scratch, later frames only repair the order
+    */
+    bool runBroadPhase(ResourceManager&) {
+        std::mt19937 random(1);
+        std::uniform_real_distribution<float> coordinate(0.f, MAP_SIZE * TILE_SIZE);
+        std::uniform_real_distribution<float> size(12.f, 28.f);
+        std::uniform_real_distribution<float> speed(-120.f, 120.f);
+
+        Scene::TileMap tileMap(MAP_SIZE, MAP_SIZE, glm::vec2(TILE_SIZE));
+        for (int row = 0; row < MAP_SIZE; ++row) {
+            for (int column = 0; column < MAP_SIZE; ++column) {
+                if (random() % 5 == 0) {
+                    tileMap.setTile(column, row, 1 + random() % 2);     // Brick or concrete
+                }
+            }
+        }
+
+        ECS::World world;
+        Physics::BroadPhase broadPhase;
+        world.reserve(ECS::componentMask<ECS::Transform, ECS::Velocity, ECS::Collider>(), MOVERS_COUNT);
+        for (size_t i = 0; i < MOVERS_COUNT; ++i) {
+            const float side = size(random);
+            const ECS::Transform transform{ glm::vec2(coordinate(random), coordinate(random)), glm::vec2(side), 0.f };
+            const Physics::BodyHandle body = broadPhase.addBody(Physics::spriteBounds(transform.position, transform.size), i);
+            world.create(transform, ECS::Velocity{ glm::vec2(speed(random), speed(random)), 0.f }, ECS::Collider{ body });
+        }
+
+        System::FrameArena& arena = *System::FrameArena::forCurrentThread();
+        size_t pairsCount = 0;
+        size_t contactsCount = 0;
+        double firstFrameMilliseconds = 0.0;
+        double totalMilliseconds = 0.0;
+        double worstMilliseconds = 0.0;
+        size_t swapsCount = 0;
+        size_t testedPairsCount = 0;
+        for (unsigned int frame = 0; frame < FRAMES_COUNT; ++frame) {
+            arena.reset();
+            ECS::integrateMotion(world, DELTA_TIME);
+
+            const auto startTime = std::chrono::steady_clock::now();
+            ECS::updateColliders(world, broadPhase);
+            System::FrameVector <Physics::BodyPair> pairs;
+            broadPhase.findPairs(pairs);
+            System::FrameVector <Physics::TileContact> contacts;
+            broadPhase.findTileContacts(tileMap, contacts);
+            const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+            if (frame == 0) {
+                firstFrameMilliseconds = milliseconds;
+                continue;
+            }
+            totalMilliseconds += milliseconds;
+            worstMilliseconds = std::max(worstMilliseconds, milliseconds);
+            pairsCount += pairs.size();
+            contactsCount += contacts.size();
+            swapsCount += broadPhase.sortSwapsCount();
+            testedPairsCount += broadPhase.testedPairsCount();
+        }
+        const unsigned int steadyFrames = FRAMES_COUNT - 1;
+        report("broadphase", "first frame", firstFrameMilliseconds, MOVERS_COUNT);
+        report("broadphase", "frame", totalMilliseconds / steadyFrames, MOVERS_COUNT);
+        std::cout << "broadphase/worst frame: " << worstMilliseconds << " ms, per frame: " << pairsCount / steadyFrames << " pairs of "
+                  << testedPairsCount / steadyFrames << " tested, " << contactsCount / steadyFrames << " tile contacts, "
+                  << swapsCount / steadyFrames << " sort swaps, arena high-water mark " << arena.highWaterMark() << " bytes" << std::endl;
+
+        /* The sweep must find exactly the pairs that testing every pair finds */
+        arena.reset();
+        System::FrameVector <Physics::BodyPair> pairs;
+        broadPhase.findPairs(pairs);
+        std::vector <Physics::Aabb> bounds;
+        world.forEach<ECS::Transform>([&bounds](const ECS::Transform& transform) {
+            bounds.push_back(Physics::spriteBounds(transform.position, transform.size));
+        });
+        size_t bruteForcePairsCount = 0;
+        const double bruteForceMilliseconds = measure(1, [&bounds, &bruteForcePairsCount]() {
+            bruteForcePairsCount = 0;
+            for (size_t i = 0; i < bounds.size(); ++i) {
+                for (size_t j = i + 1; j < bounds.size(); ++j) {
+                    bruteForcePairsCount += bounds[i].min.x <= bounds[j].max.x && bounds[j].min.x <= bounds[i].max.x
+                                         && bounds[i].min.y <= bounds[j].max.y && bounds[j].min.y <= bounds[i].max.y ? 1 : 0;
+                }
+            }
+        });
+        report("broadphase", "all pairs", bruteForceMilliseconds, MOVERS_COUNT);
+        arena.reset();
+        if (pairs.size() != bruteForcePairsCount) {
+            std::cerr << "broadphase: sweep found " << pairs.size() << " pairs, testing all pairs found " << bruteForcePairsCount << std::endl;
+            return false;
+        }
+        return true;
+    }
+}
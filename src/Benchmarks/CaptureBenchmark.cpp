@@ -0,0 +1,158 @@
+#include "Benchmarks.h"
+#include "../Renderer/FrameCapture.h"
+#include "../Renderer/ShaderProgram.h"
+#include "../Renderer/Sprite.h"
+#include "../Renderer/Texture2D.h"
+#include "../Resources/ResourceManager.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace Benchmarks {
+    namespace {
+        const int FRAME_WIDTH = 1920;
+        const int FRAME_HEIGHT = 1080;
+        const unsigned int SPRITES_COUNT = 100;
+        const unsigned int FRAMES_COUNT = 60;
+        const unsigned int REPETITIONS = 3;
+        const char* const STREAM_PATH = "capture_benchmark.ppm";
+    }
+
+    /*
+    Capture of 1080p frames of 100 sprites rendered into a framebuffer: without capture, with a glReadPixels
+    into client memory every frame, and with the pixel pack buffer ring streaming PPM images from the writer thread.
+    A frame read through the ring must match the one read directly
+    */
+    bool runCapture(ResourceManager& resourceManager) {
+        if (!resourceManager.loadManifest("res/manifest.txt")) {
+            return false;
+        }
+        std::shared_ptr <Renderer::ShaderProgram> pSpriteShaderProgram = resourceManager.getShaderProgram("SpriteShaderProgram");
+        std::shared_ptr <Renderer::Sprite> pSprite = resourceManager.getSprite("Sprite");
+        if (!pSpriteShaderProgram || !pSprite) {
+            return false;
+        }
+
+        /* Frames are rendered into a texture of the capture size, whatever the window size is */
+        Renderer::Texture2D target(FRAME_WIDTH, FRAME_HEIGHT, nullptr, 4, GL_NEAREST);
+        GLuint framebuffer = 0;
+        glGenFramebuffers(1, &framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target.id(), 0);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            std::cerr << "capture: the framebuffer is incomplete" << std::endl;
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glDeleteFramebuffers(1, &framebuffer);
+            return false;
+        }
+        GLint previousViewport[4];
+        glGetIntegerv(GL_VIEWPORT, previousViewport);
+        glViewport(0, 0, FRAME_WIDTH, FRAME_HEIGHT);
+        pSpriteShaderProgram->use();
+        pSpriteShaderProgram->setMatrix4("projectionMat", glm::ortho(0.f, static_cast<float>(FRAME_WIDTH), 0.f, static_cast<float>(FRAME_HEIGHT), -100.f, 100.f));
+
+        std::mt19937 random(1);
+        std::uniform_real_distribution<float> x(0.f, FRAME_WIDTH - 100.f);
+        std::uniform_real_distribution<float> y(0.f, FRAME_HEIGHT - 100.f);
+        const auto renderFrame = [&]() {
+            glClear(GL_COLOR_BUFFER_BIT);
+            for (unsigned int i = 0; i < SPRITES_COUNT; ++i) {
+                pSprite->setPosition(glm::vec2(x(random), y(random)));
+                pSprite->render();
+            }
+        };
+
+        const double frameMilliseconds = measure(REPETITIONS, [&]() {
+            for (unsigned int frame = 0; frame < FRAMES_COUNT; ++frame) {
+                renderFrame();
+            }
+            glFinish();
+        });
+        report("capture", "1080p frame (no capture)", frameMilliseconds, FRAMES_COUNT);
+
+        std::vector <uint8_t> clientPixels(static_cast<size_t>(FRAME_WIDTH) * FRAME_HEIGHT * 4);
+        report("capture", "1080p frame (glReadPixels into client memory)", measure(REPETITIONS, [&]() {
+            for (unsigned int frame = 0; frame < FRAMES_COUNT; ++frame) {
+                renderFrame();
+                glReadPixels(0, 0, FRAME_WIDTH, FRAME_HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE, clientPixels.data());
+            }
+            glFinish();
+        }), FRAMES_COUNT);
+
+        /* The writer drops frames it can't keep up with, so the disk speed does not limit the frame time */
+        Renderer::FrameCapture::Statistics statistics;
+        double captureMilliseconds = 0.0;
+        double ringFrameMilliseconds = 0.0;
+        {
+            Renderer::FrameCapture frameCapture(STREAM_PATH, Renderer::FrameCapture::Format::PPM_STREAM, glm::ivec2(FRAME_WIDTH, FRAME_HEIGHT));
+            ringFrameMilliseconds = measure(REPETITIONS, [&]() {
+                captureMilliseconds = 0.0;
+                for (unsigned int frame = 0; frame < FRAMES_COUNT; ++frame) {
+                    renderFrame();
+                    const auto startTime = std::chrono::steady_clock::now();
+                    frameCapture.capture(framebuffer);
+                    captureMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+                }
+                glFinish();
+            });
+            report("capture", "1080p frame (pixel pack buffer ring)", ringFrameMilliseconds, FRAMES_COUNT);
+            frameCapture.finish();
+            statistics = frameCapture.statistics();
+        }
+        /* The writer thread encodes while frames are rendered, on few cores it takes frame time from the renderer */
+        std::cout << "capture/overhead per frame: " << (ringFrameMilliseconds - frameMilliseconds) / FRAMES_COUNT << " ms (target: 1 ms), "
+                  << "capture() per frame: " << captureMilliseconds / FRAMES_COUNT << " ms (last run)" << std::endl;
+        std::cout << "capture/" << statistics.capturedFrames << " frames captured, " << statistics.writtenFrames << " written, "
+                  << statistics.droppedFrames << " dropped" << std::endl;
+        std::remove(STREAM_PATH);
+        if (statistics.writtenFrames != statistics.capturedFrames) {
+            std::cerr << "capture: " << statistics.capturedFrames - statistics.writtenFrames << " captured frames were not written" << std::endl;
+            glDeleteFramebuffers(1, &framebuffer);
+            return false;
+        }
+
+        /* One frame through the ring and the writer, compared with the pixels read directly (rows from the bottom) */
+        renderFrame();
+        glReadPixels(0, 0, FRAME_WIDTH, FRAME_HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE, clientPixels.data());
+        {
+            Renderer::FrameCapture frameCapture(STREAM_PATH, Renderer::FrameCapture::Format::PPM_STREAM, glm::ivec2(FRAME_WIDTH, FRAME_HEIGHT));
+            frameCapture.capture(framebuffer);
+        }
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers(1, &framebuffer);
+        glViewport(previousViewport[0], previousViewport[1], previousViewport[2], previousViewport[3]);
+
+        std::ifstream stream(STREAM_PATH, std::ios::binary);
+        const std::string header = "P6\n" + std::to_string(FRAME_WIDTH) + " " + std::to_string(FRAME_HEIGHT) + "\n255\n";
+        const std::vector <char> data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+        stream.close();
+        std::remove(STREAM_PATH);
+        if (data.size() != header.size() + static_cast<size_t>(FRAME_WIDTH) * FRAME_HEIGHT * 3 || !std::equal(header.begin(), header.end(), data.begin())) {
+            std::cerr << "capture: the captured stream has " << data.size() << " bytes, not one " << FRAME_WIDTH << "x" << FRAME_HEIGHT << " image" << std::endl;
+            return false;
+        }
+        const uint8_t* streamPixels = reinterpret_cast<const uint8_t*>(data.data() + header.size());
+        for (int row = 0; row < FRAME_HEIGHT; ++row) {
+            for (int column = 0; column < FRAME_WIDTH; ++column) {
+                const uint8_t* pixel = streamPixels + (static_cast<size_t>(FRAME_HEIGHT - 1 - row) * FRAME_WIDTH + column) * 3;
+                const uint8_t* directPixel = clientPixels.data() + (static_cast<size_t>(row) * FRAME_WIDTH + column) * 4;
+                if (pixel[0] != directPixel[0] || pixel[1] != directPixel[1] || pixel[2] != directPixel[2]) {
+                    std::cerr << "capture: pixel " << column << ", " << row << " of the captured frame differs" << std::endl;
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+}
@@ -0,0 +1,108 @@
+#include "Benchmarks.h"
+#include "../Physics/CollisionMask.h"
+#include "../Resources/ResourceManager.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace Benchmarks {
+    namespace {
+        const size_t PAIRS_COUNT = 1000000;
+        const unsigned int REPETITIONS = 5;
+
+        /* Pair of masks at an offset */
+        struct MaskPair {
+            const Physics::CollisionMask* pA;
+            const Physics::CollisionMask* pB;
+            int offsetX;
+            int offsetY;
+        };
+
+        /* Reference test pixel by pixel */
+        bool overlapsPerPixel(const Physics::CollisionMask& a, const Physics::CollisionMask& b, const int offsetX, const int offsetY) {
+            for (int y = std::max(0, offsetY); y < std::min(a.height, b.height + offsetY); ++y) {
+                for (int x = std::max(0, offsetX); x < std::min(a.width, b.width + offsetX); ++x) {
+                    if (a.isOpaque(x, y) && b.isOpaque(x - offsetX, y - offsetY)) {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        /* Random pairs of the masks at offsets where their rectangles overlap */
+        std::vector <MaskPair> makePairs(const Physics::CollisionMaskSet& masks) {
+            std::mt19937 random(1);
+            std::vector <MaskPair> pairs(PAIRS_COUNT);
+            for (MaskPair& pair : pairs) {
+                pair.pA = &masks.getMask(random() % masks.masksCount());
+                pair.pB = &masks.getMask(random() % masks.masksCount());
+                pair.offsetX = static_cast<int>(random() % (pair.pA->width + pair.pB->width - 1)) - pair.pB->width + 1;
+                pair.offsetY = static_cast<int>(random() % (pair.pA->height + pair.pB->height - 1)) - pair.pB->height + 1;
+            }
+            return pairs;
+        }
+
+        /* Time the pair tests with the bit-packed and the per-pixel test, checking that they agree */
+        bool measurePairs(const std::string& caseName, const std::vector <MaskPair>& pairs) {
+            size_t hitsCount = 0;
+            const double milliseconds = measure(REPETITIONS, [&pairs, &hitsCount]() {
+                hitsCount = 0;
+                for (const MaskPair& pair : pairs) {
+                    hitsCount += Physics::overlaps(*pair.pA, *pair.pB, pair.offsetX, pair.offsetY) ? 1 : 0;
+                }
+            });
+            report("collision", caseName, milliseconds, pairs.size());
+
+            size_t referenceHitsCount = 0;
+            const double referenceMilliseconds = measure(1, [&pairs, &referenceHitsCount]() {
+                referenceHitsCount = 0;
+                for (const MaskPair& pair : pairs) {
+                    referenceHitsCount += overlapsPerPixel(*pair.pA, *pair.pB, pair.offsetX, pair.offsetY) ? 1 : 0;
+                }
+            });
+            report("collision", caseName + " per pixel", referenceMilliseconds, pairs.size());
+            std::cout << "collision/" << caseName << ": " << pairs.size() / milliseconds / 1000.0 << " million pair tests per second, "
+                      << hitsCount << " overlapping pairs" << std::endl;
+            if (hitsCount != referenceHitsCount) {
+                std::cerr << "collision/" << caseName << ": " << hitsCount << " overlaps, the per pixel test found " << referenceHitsCount << std::endl;
+                return false;
+            }
+            return true;
+        }
+    }
+
+    /* Pixel-perfect overlap tests of 1M random pairs: 16x16 atlas tiles and 96x96 discs with holes (two words per row) */
+    bool runCollision(ResourceManager& resourceManager) {
+        if (!resourceManager.loadManifest("res/manifest.txt")) {
+            return false;
+        }
+        std::shared_ptr <const Physics::CollisionMaskSet> pTileMasks = resourceManager.getCollisionMasks("DefaultTextureAtlas");
+        if (!pTileMasks) {
+            std::cerr << "collision: DefaultTextureAtlas has no collision masks" << std::endl;
+            return false;
+        }
+        bool isSuccessful = measurePairs("atlas tiles", makePairs(*pTileMasks));
+
+        /* Rings of different thickness, so that many rectangle overlaps are not pixel overlaps */
+        const int size = 96;
+        const int discsCount = 4;
+        std::vector <unsigned char> pixels(static_cast<size_t>(size) * discsCount * size * 4, 0);
+        for (int disc = 0; disc < discsCount; ++disc) {
+            const float innerRadius = 10.f + 8.f * disc;
+            for (int y = 0; y < size; ++y) {
+                for (int x = 0; x < size; ++x) {
+                    const float distance = std::hypot(x + 0.5f - size / 2.f, y + 0.5f - size / 2.f);
+                    pixels[(static_cast<size_t>(y) * size * discsCount + disc * size + x) * 4 + 3] = distance < size / 2.f && distance >= innerRadius ? 255 : 0;
+                }
+            }
+        }
+        const Physics::CollisionMaskSet ringMasks(pixels.data(), size * discsCount, size, 4, size, size);
+        isSuccessful = measurePairs("96x96 rings", makePairs(ringMasks)) && isSuccessful;
+        return isSuccessful;
+    }
+}
@@ -0,0 +1,87 @@
+#include "Benchmarks.h"
+#include "../Renderer/DynamicAtlas.h"
+
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace Benchmarks {
+    namespace {
+        const unsigned int PAGE_SIZE = 1024;
+        const unsigned int MAX_PAGES = 4;
+        const size_t FRAMES_COUNT = 500;
+        const size_t ALLOCATIONS_PER_FRAME = 64;
+        const unsigned int REPETITIONS = 3;
+    }
+
+    /*
+    Runtime-generated images churning through a 4-page atlas: every frame 64 images of 8..48 pixels are added
+    and 1/32 of the live ones are released. The pages fill up, so the least recently used pages get evicted.
+    Measured with and without uploading the pixels to separate the allocator from the texture updates
+    */
+    bool runDynamicAtlas(ResourceManager&) {
+        const uint64_t savedFrame = Renderer::Texture2D::currentFrame();
+        const std::vector <unsigned char> pixels(48 * 48 * 4, 255);
+        std::vector <Renderer::AtlasRegionHandle> liveRegions;
+        size_t failedCount = 0;
+        size_t evictionsCount = 0;
+        float occupancy = 0.f;
+
+        auto churn = [&](const unsigned char* pPixels) {
+            Renderer::DynamicAtlas atlas(PAGE_SIZE, MAX_PAGES);
+            std::mt19937 random(1);
+            std::uniform_int_distribution <unsigned int> sizeDistribution(8, 48);
+            liveRegions.clear();
+            failedCount = 0;
+            for (size_t frame = 1; frame <= FRAMES_COUNT; ++frame) {
+                Renderer::Texture2D::setCurrentFrame(frame);
+                for (size_t i = 0; i < ALLOCATIONS_PER_FRAME; ++i) {
+                    const Renderer::AtlasRegionHandle handle = atlas.allocate(sizeDistribution(random), sizeDistribution(random), pPixels);
+                    if (handle.isValid()) {
+                        liveRegions.push_back(handle);
+                    }
+                    else {
+                        ++failedCount;
+                    }
+                }
+                for (size_t i = 0; i < liveRegions.size() / 32; ++i) {
+                    const size_t index = random() % liveRegions.size();
+                    atlas.release(liveRegions[index]);
+                    liveRegions[index] = liveRegions.back();
+                    liveRegions.pop_back();
+                }
+            }
+            glFinish();
+            evictionsCount = atlas.evictionsCount();
+            occupancy = atlas.occupancy();
+        };
+
+        report("atlas", "allocate with churn", measure(REPETITIONS, [&churn]() { churn(nullptr); }), FRAMES_COUNT * ALLOCATIONS_PER_FRAME);
+        report("atlas", "allocate and upload with churn", measure(REPETITIONS, [&churn, &pixels]() { churn(pixels.data()); }), FRAMES_COUNT * ALLOCATIONS_PER_FRAME);
+        std::cout << "atlas/evictions: " << evictionsCount << ", occupancy: " << occupancy * 100.f
+                  << "%, failed allocations: " << failedCount << std::endl;
+
+        /* Handle lookups with a mix of live and stale handles */
+        Renderer::DynamicAtlas atlas(PAGE_SIZE, MAX_PAGES);
+        Renderer::Texture2D::setCurrentFrame(FRAMES_COUNT + 1);
+        std::vector <Renderer::AtlasRegionHandle> handles;
+        for (size_t i = 0; i < 4096; ++i) {
+            handles.push_back(atlas.allocate(16, 16, nullptr));
+            if (i % 2 == 0) {
+                atlas.release(handles.back());
+            }
+        }
+        size_t liveCount = 0;
+        report("atlas", "get", measure(REPETITIONS, [&atlas, &handles, &liveCount]() {
+            liveCount = 0;
+            Renderer::DynamicAtlas::Region region;
+            for (const Renderer::AtlasRegionHandle handle : handles) {
+                liveCount += atlas.get(handle, region) ? 1 : 0;
+            }
+        }), handles.size());
+        std::cout << "atlas/live handles: " << liveCount << " of " << handles.size() << std::endl;
+
+        Renderer::Texture2D::setCurrentFrame(savedFrame);
+        return true;
+    }
+}
@@ -0,0 +1,117 @@
+#include "Benchmarks.h"
+#include "../ECS/Systems.h"
+#include "../Renderer/ShaderProgram.h"
+#include "../Renderer/SpriteBatch.h"
+#include "../Renderer/Texture2D.h"
+#include "../Resources/ResourceManager.h"
+
+#include <glm/trigonometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace Benchmarks {
+    namespace {
+        const size_t ENTITIES_COUNT = 1000000;
+        const unsigned int REPETITIONS = 5;
+        const float DELTA_TIME = 1.f / 60.f;
+
+        /* The data of a Renderer::Sprite plus a velocity: the object-per-sprite layout the entities replace */
+        struct SpriteObject {
+            std::shared_ptr <Renderer::Texture2D> pTexture;
+            std::shared_ptr <Renderer::ShaderProgram> pShaderProgram;
+            glm::vec2 position;
+            glm::vec2 size;
+            float rotation;
+            Renderer::Texture2D::SubTextureId subTextureId;
+            GLuint vao;
+            GLuint vertexCoords_vbo;
+            GLuint textureCoords_vbo;
+            glm::vec2 velocity;
+            float angularVelocity;
+        };
+    }
+
+    /* Transform update and render extraction of 1M entities against a vector of sprite objects */
+    bool runEntities(ResourceManager& resourceManager) {
+        if (!resourceManager.loadManifest("res/manifest.txt")) {
+            return false;
+        }
+        std::shared_ptr <Renderer::Texture2D> pAtlas = resourceManager.getTexture("DefaultTextureAtlas");
+        std::shared_ptr <Renderer::ShaderProgram> pShaderProgram = resourceManager.getShaderProgram("SpriteBatchShaderProgram");
+        if (!pAtlas || !pShaderProgram) {
+            return false;
+        }
+        Renderer::SpriteBatch spriteBatch(pShaderProgram);
+
+        std::mt19937 random(1);
+        std::uniform_real_distribution<float> coordinate(0.f, 1000.f);
+        std::uniform_real_distribution<float> speed(-50.f, 50.f);
+        const Renderer::Texture2D::SubTextureId tilesCount = static_cast<Renderer::Texture2D::SubTextureId>(pAtlas->subTexturesCount());
+
+        /* Entities */
+        ECS::World world;
+        world.reserve(ECS::componentMask<ECS::Transform, ECS::SpriteRef, ECS::Velocity>(), ENTITIES_COUNT);
+        for (size_t i = 0; i < ENTITIES_COUNT; ++i) {
+            const Renderer::Texture2D::SubTextureId tile = static_cast<Renderer::Texture2D::SubTextureId>(i % tilesCount);
+            world.create(ECS::Transform{ glm::vec2(coordinate(random), coordinate(random)), glm::vec2(16.f), 0.f },
+                         ECS::SpriteRef{ pAtlas.get(), tile },
+                         ECS::Velocity{ glm::vec2(speed(random), speed(random)), speed(random) });
+        }
+
+        /*
+        Sprite objects. Objects of a real scene are created at different times and end up scattered over the heap,
+        so they are visited in shuffled order
+        */
+        std::vector <std::shared_ptr <SpriteObject>> spriteObjects;
+        spriteObjects.reserve(ENTITIES_COUNT);
+        for (size_t i = 0; i < ENTITIES_COUNT; ++i) {
+            const Renderer::Texture2D::SubTextureId tile = static_cast<Renderer::Texture2D::SubTextureId>(i % tilesCount);
+            spriteObjects.push_back(std::make_shared<SpriteObject>(SpriteObject{ pAtlas, pShaderProgram,
+                glm::vec2(coordinate(random), coordinate(random)), glm::vec2(16.f), 0.f, tile, 0, 0, 0,
+                glm::vec2(speed(random), speed(random)), speed(random) }));
+        }
+        std::shuffle(spriteObjects.begin(), spriteObjects.end(), random);
+        std::vector <Renderer::SpriteBatch::Instance> objectInstances;
+        objectInstances.reserve(ENTITIES_COUNT);
+
+        report("entities", "ecs transform", measure(REPETITIONS, [&world]() {
+            ECS::integrateMotion(world, DELTA_TIME);
+        }), ENTITIES_COUNT);
+        report("entities", "sprite objects transform", measure(REPETITIONS, [&spriteObjects]() {
+            for (const std::shared_ptr <SpriteObject>& pObject : spriteObjects) {
+                pObject->position += pObject->velocity * DELTA_TIME;
+                pObject->rotation += pObject->angularVelocity * DELTA_TIME;
+            }
+        }), ENTITIES_COUNT);
+
+        report("entities", "ecs extraction", measure(REPETITIONS, [&world, &spriteBatch]() {
+            ECS::extractSprites(world, spriteBatch);
+            spriteBatch.clear();
+        }), ENTITIES_COUNT);
+        report("entities", "sprite objects extraction", measure(REPETITIONS, [&spriteObjects, &objectInstances]() {
+            objectInstances.clear();
+            for (const std::shared_ptr <SpriteObject>& pObject : spriteObjects) {
+                const Renderer::Texture2D::SubTexture2D subTexture = pObject->pTexture->getSubTexture(pObject->subTextureId);
+                objectInstances.push_back({ glm::vec4(pObject->position, pObject->size),
+                                            glm::vec4(subTexture.leftBottomUV, subTexture.rightTopUV),
+                                            glm::radians(pObject->rotation) });
+            }
+        }), ENTITIES_COUNT);
+
+        /* Full frame of the batch renderer: extraction, upload and instanced draws */
+        pShaderProgram->use();
+        pShaderProgram->setMatrix4("projectionMat", glm::ortho(0.f, 1000.f, 0.f, 1000.f, -100.f, 100.f));
+        report("entities", "ecs extraction and render", measure(REPETITIONS, [&world, &spriteBatch]() {
+            ECS::extractSprites(world, spriteBatch);
+            spriteBatch.render();
+            glFinish();
+        }), ENTITIES_COUNT);
+        std::cout << "entities/draw calls: " << spriteBatch.drawCalls() << std::endl;
+        return true;
+    }
+}
@@ -0,0 +1,67 @@
+#include "Benchmarks.h"
+#include "../Renderer/GpuParticleSystem.h"
+#include "../Renderer/ShaderProgram.h"
+#include "../Renderer/Texture2D.h"
+#include "../Resources/ResourceManager.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <iostream>
+#include <memory>
+
+namespace Benchmarks {
+    namespace {
+        const size_t GPU_PARTICLES_COUNT = 1000000;
+        const unsigned int STEPS = 10;
+        const unsigned int REPETITIONS = 3;
+        const float DELTA_TIME = 1.f / 60.f;
+    }
+
+    /* Transform feedback simulation of 1M particles: simulated particles per second, with and without rendering */
+    bool runGpuParticles(ResourceManager& resourceManager) {
+        if (!resourceManager.loadManifest("res/manifest.txt")) {
+            return false;
+        }
+        std::shared_ptr <Renderer::Texture2D> pAtlas = resourceManager.getTexture("DefaultTextureAtlas");
+        std::shared_ptr <Renderer::ShaderProgram> pSimulationShaderProgram = resourceManager.loadShaders("GpuParticleSimulationShaderProgram",
+            "res/shaders/vGpuParticleSimulation_shader.txt", "res/shaders/fGpuParticleSimulation_shader.txt", { "out_positionVelocity", "out_ageLifetime" });
+        std::shared_ptr <Renderer::ShaderProgram> pRenderShaderProgram = resourceManager.loadShaders("GpuParticleShaderProgram",
+            "res/shaders/vGpuParticle_shader.txt", "res/shaders/fParticle_shader.txt");
+        if (!pAtlas || !pSimulationShaderProgram || !pRenderShaderProgram) {
+            return false;
+        }
+
+        Renderer::ParticleEmitterSettings settings;
+        settings.position = glm::vec2(500.f, 500.f);
+        settings.positionSpread = glm::vec2(400.f, 400.f);
+        settings.minSpeed = 10.f;
+        settings.maxSpeed = 100.f;
+        settings.minLifetime = 1.f;
+        settings.maxLifetime = 3.f;
+        settings.gravity = glm::vec2(0.f, -50.f);
+        settings.drag = 0.2f;
+        settings.startSize = 4.f;
+        settings.endSize = 1.f;
+        settings.maxParticles = GPU_PARTICLES_COUNT;
+        Renderer::GpuParticleSystem particleSystem(pAtlas, pAtlas->getSubTextureId("concrete"), pSimulationShaderProgram, pRenderShaderProgram, settings);
+
+        /* glFinish makes the measured time include the GPU work, nothing is read back */
+        const double simulationMilliseconds = measure(REPETITIONS, [&particleSystem]() {
+            for (unsigned int step = 0; step < STEPS; ++step) {
+                particleSystem.update(DELTA_TIME);
+            }
+            glFinish();
+        });
+        report("gpu-particles", "simulation step", simulationMilliseconds / STEPS, particleSystem.size());
+        std::cout << "gpu-particles/simulated particles per second: " << particleSystem.size() * STEPS / (simulationMilliseconds * 0.001) << std::endl;
+
+        pRenderShaderProgram->use();
+        pRenderShaderProgram->setMatrix4("projectionMat", glm::ortho(0.f, 1000.f, 0.f, 1000.f, -100.f, 100.f));
+        report("gpu-particles", "simulation and render", measure(REPETITIONS, [&particleSystem]() {
+            particleSystem.update(DELTA_TIME);
+            particleSystem.render();
+            glFinish();
+        }), particleSystem.size());
+        return true;
+    }
+}
@@ -0,0 +1,183 @@
+#include "Benchmarks.h"
+#include "../Renderer/LayerStack.h"
+#include "../Renderer/ShaderProgram.h"
+#include "../Renderer/Sprite.h"
+#include "../Renderer/Texture2D.h"
+#include "../Renderer/TileMapRenderer.h"
+#include "../Resources/ResourceManager.h"
+#include "../Scene/AutoTiler.h"
+
+#include <glm/vec2.hpp>
+
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace Benchmarks {
+    namespace {
+        const int MAP_COLUMNS = 128;
+        const int MAP_ROWS = 64;
+        const float TILE_SIZE = 16.f;
+        const unsigned int SPRITES_COUNT = 200;
+        const unsigned int FRAMES_COUNT = 200;
+        const unsigned int REPETITIONS = 3;
+        const float PAN_SPEED = 4.f;            // Pixels per frame
+        const Scene::TileMap::TileType BRICK = 1;
+
+        /* Pixels of the viewport of the current framebuffer */
+        std::vector <uint8_t> readViewport(const glm::ivec2& size) {
+            std::vector <uint8_t> pixels(static_cast<size_t>(size.x) * size.y * 4);
+            glReadPixels(0, 0, size.x, size.y, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+            return pixels;
+        }
+    }
+
+    /*
+    A static background of a 128x64 brick map and 200 sprites (201 draw calls) drawn directly every frame,
+    from its cache while nothing changes, with one brick hit per frame redrawn in a dirty rectangle,
+    and while the camera pans across the margin. A cached frame must look the same as a directly drawn one
+    */
+    bool runLayers(ResourceManager& resourceManager) {
+        if (!resourceManager.loadManifest("res/manifest.txt")) {
+            return false;
+        }
+        std::shared_ptr <Renderer::Texture2D> pAtlas = resourceManager.getTexture("DefaultTextureAtlas");
+        std::shared_ptr <Renderer::ShaderProgram> pTileMapShaderProgram = resourceManager.getShaderProgram("TileMapShaderProgram");
+        std::shared_ptr <Renderer::ShaderProgram> pSpriteShaderProgram = resourceManager.getShaderProgram("SpriteShaderProgram");
+        std::shared_ptr <Renderer::ShaderProgram> pCompositeShaderProgram = resourceManager.getShaderProgram("LayerCompositeShaderProgram");
+        std::shared_ptr <Renderer::Sprite> pSprite = resourceManager.getSprite("Sprite");
+        if (!pAtlas || !pTileMapShaderProgram || !pSpriteShaderProgram || !pCompositeShaderProgram || !pSprite) {
+            return false;
+        }
+
+        std::mt19937 random(1);
+        Scene::TileMap tileMap(MAP_COLUMNS, MAP_ROWS, glm::vec2(TILE_SIZE));
+        for (int row = 0; row < MAP_ROWS; ++row) {
+            for (int column = 0; column < MAP_COLUMNS; ++column) {
+                if (random() % 2 == 0) {
+                    tileMap.setTile(column, row, BRICK);
+                }
+            }
+        }
+        Scene::AutoTiler autoTiler(tileMap);
+        autoTiler.setImage(BRICK, static_cast<Scene::AutoTiler::CellImage>(pAtlas->getSubTextureId("brick")));
+        autoTiler.retileAll();
+        Renderer::TileMapRenderer renderer(pAtlas, pTileMapShaderProgram, MAP_COLUMNS, MAP_ROWS, glm::vec2(TILE_SIZE));
+        renderer.upload(autoTiler.images());
+        renderer.uploadSubCellsRegion(tileMap.subCells(), glm::ivec2(0), glm::ivec2(MAP_COLUMNS - 1, MAP_ROWS - 1));
+        autoTiler.clearDirtyRects();
+
+        std::uniform_real_distribution<float> x(0.f, MAP_COLUMNS * TILE_SIZE - 100.f);
+        std::uniform_real_distribution<float> y(0.f, MAP_ROWS * TILE_SIZE - 100.f);
+        /* Sprites are a whole number of pixels per texel, so no pixel center falls on a texel edge and the cached frame can be compared exactly */
+        pSprite->setSize(glm::vec2(96.f));
+        std::vector <glm::vec2> spritePositions(SPRITES_COUNT);
+        for (glm::vec2& position : spritePositions) {
+            position = glm::floor(glm::vec2(x(random), y(random)));
+        }
+
+        GLint viewport[4];
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        const glm::ivec2 viewportSize(viewport[2], viewport[3]);
+        Renderer::LayerStack layerStack(pCompositeShaderProgram, viewportSize);
+        const size_t background = layerStack.addLayer([&](const glm::mat4& projectionMatrix) {
+            pTileMapShaderProgram->use();
+            pTileMapShaderProgram->setMatrix4("projectionMat", projectionMatrix);
+            renderer.render();
+            pSpriteShaderProgram->use();
+            pSpriteShaderProgram->setMatrix4("projectionMat", projectionMatrix);
+            for (const glm::vec2& position : spritePositions) {
+                pSprite->setPosition(position);
+                pSprite->render();
+            }
+            return SPRITES_COUNT + 1;
+        });
+
+        /* Render the frames of a case, the function prepares a frame and returns its camera position. Statistics are summed */
+        Renderer::LayerStack::FrameStatistics total;
+        const auto renderFrames = [&](const std::function<glm::vec2(unsigned int)>& prepareFrame) {
+            total = Renderer::LayerStack::FrameStatistics();
+            for (unsigned int frame = 0; frame < FRAMES_COUNT; ++frame) {
+                const glm::vec2 cameraPosition = prepareFrame(frame);
+                glClear(GL_COLOR_BUFFER_BIT);
+                layerStack.render(cameraPosition);
+                const Renderer::LayerStack::FrameStatistics& statistics = layerStack.lastFrame();
+                total.drawCalls += statistics.drawCalls;
+                total.savedDrawCalls += statistics.savedDrawCalls;
+                total.redrawnLayers += statistics.redrawnLayers;
+                total.redrawnPixels += statistics.redrawnPixels;
+                total.cachedPixels += statistics.cachedPixels;
+            }
+            glFinish();
+        };
+        const auto printTotal = [&total](const char* caseName) {
+            std::cout << "layers/" << caseName << ": " << static_cast<double>(total.drawCalls) / FRAMES_COUNT << " draw calls per frame, "
+                      << static_cast<double>(total.savedDrawCalls) / FRAMES_COUNT << " saved, "
+                      << static_cast<double>(total.redrawnPixels) / FRAMES_COUNT << " redrawn and "
+                      << static_cast<double>(total.cachedPixels) / FRAMES_COUNT << " cached pixels per frame" << std::endl;
+        };
+        const auto noChange = [](unsigned int) { return glm::vec2(0.f); };
+
+        /* Reference: the layer is drawn every frame */
+        report("layers", "direct frame", measure(REPETITIONS, [&]() { renderFrames(noChange); }), FRAMES_COUNT);
+        printTotal("direct frame");
+        glClear(GL_COLOR_BUFFER_BIT);
+        layerStack.render(glm::vec2(0.f));
+        const std::vector <uint8_t> directPixels = readViewport(viewportSize);
+
+        layerStack.setStatic(background, true);
+        report("layers", "cached frame (nothing changes)", measure(REPETITIONS, [&]() { renderFrames(noChange); }), FRAMES_COUNT);
+        printTotal("cached frame (nothing changes)");
+        glClear(GL_COLOR_BUFFER_BIT);
+        layerStack.render(glm::vec2(0.f));
+        const std::vector <uint8_t> cachedPixels = readViewport(viewportSize);
+        size_t differentPixelsCount = 0;
+        for (size_t i = 0; i < directPixels.size(); i += 4) {
+            for (size_t channel = 0; channel < 4; ++channel) {
+                if (std::abs(directPixels[i + channel] - cachedPixels[i + channel]) > 1) {
+                    ++differentPixelsCount;
+                    break;
+                }
+            }
+        }
+        if (differentPixelsCount != 0) {
+            std::cerr << "layers: " << differentPixelsCount << " pixels of the cached frame differ from the direct frame" << std::endl;
+            return false;
+        }
+
+        /* A brick is hit every frame: only its cell is redrawn, with all of the draw calls of the layer */
+        std::uniform_int_distribution<int> column(0, MAP_COLUMNS - 1);
+        std::uniform_int_distribution<int> row(0, MAP_ROWS - 1);
+        report("layers", "cached frame (one brick hit)", measure(REPETITIONS, [&]() {
+            renderFrames([&](unsigned int) {
+                const int hitColumn = column(random);
+                const int hitRow = row(random);
+                autoTiler.setTile(hitColumn, hitRow, tileMap.getTile(hitColumn, hitRow) == BRICK ? Scene::TileMap::EMPTY_TILE : BRICK);
+                glm::ivec2 first, last;
+                while (autoTiler.takeDirtyRect(first, last)) {
+                    renderer.uploadRegion(autoTiler.images(), first, last);
+                    renderer.uploadSubCellsRegion(tileMap.subCells(), first, last);
+                    layerStack.invalidate(background, tileMap.cellPosition(first.x, first.y), tileMap.cellPosition(last.x + 1, last.y + 1));
+                }
+                return glm::vec2(0.f);
+            });
+        }), FRAMES_COUNT);
+        printTotal("cached frame (one brick hit)");
+
+        /* The camera pans back and forth, the cache is redrawn when it leaves the margin */
+        float cameraX = 0.f;
+        report("layers", "cached frame (panning)", measure(REPETITIONS, [&]() {
+            renderFrames([&cameraX](unsigned int frame) {
+                cameraX += (frame / 100) % 2 == 0 ? PAN_SPEED : -PAN_SPEED;
+                return glm::vec2(cameraX, 0.f);
+            });
+        }), FRAMES_COUNT);
+        printTotal("cached frame (panning)");
+        std::cout << "layers/cache memory: " << layerStack.gpuSizeInBytes() << " bytes" << std::endl;
+        return true;
+    }
+}
@@ -0,0 +1,63 @@
+#include "Benchmarks.h"
+#include "../Renderer/ParticleEmitter.h"
+#include "../Renderer/ShaderProgram.h"
+#include "../Renderer/Texture2D.h"
+#include "../Resources/ResourceManager.h"
+#include "../System/JobSystem.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <iostream>
+#include <memory>
+
+namespace Benchmarks {
+    namespace {
+        const size_t PARTICLES_COUNT = 1000000;
+        const unsigned int REPETITIONS = 5;
+        const float DELTA_TIME = 1.f / 60.f;
+    }
+
+    /* Simulation and rendering of 1M live particles against the 60 Hz frame budget */
+    bool runParticles(ResourceManager& resourceManager) {
+        if (!resourceManager.loadManifest("res/manifest.txt")) {
+            return false;
+        }
+        std::shared_ptr <Renderer::Texture2D> pAtlas = resourceManager.getTexture("DefaultTextureAtlas");
+        std::shared_ptr <Renderer::ShaderProgram> pShaderProgram = resourceManager.getShaderProgram("ParticleShaderProgram");
+        if (!pAtlas || !pShaderProgram) {
+            return false;
+        }
+
+        /* Lifetimes are long enough for no particle to die during the measurement, so the count stays at 1M */
+        Renderer::ParticleEmitterSettings settings;
+        settings.position = glm::vec2(500.f, 500.f);
+        settings.positionSpread = glm::vec2(400.f, 400.f);
+        settings.minSpeed = 10.f;
+        settings.maxSpeed = 100.f;
+        settings.minLifetime = 100.f;
+        settings.maxLifetime = 200.f;
+        settings.gravity = glm::vec2(0.f, -50.f);
+        settings.drag = 0.2f;
+        settings.startSize = 4.f;
+        settings.endSize = 1.f;
+        settings.maxParticles = PARTICLES_COUNT;
+        Renderer::ParticleEmitter emitter(pAtlas, pAtlas->getSubTextureId("concrete"), pShaderProgram, settings);
+        emitter.emit(PARTICLES_COUNT);
+        std::cout << "particles/worker threads: " << System::JobSystem::instance().threadCount() << std::endl;
+
+        report("particles", "simulation", measure(REPETITIONS, [&emitter]() {
+            emitter.update(DELTA_TIME);
+        }), emitter.size());
+
+        pShaderProgram->use();
+        pShaderProgram->setMatrix4("projectionMat", glm::ortho(0.f, 1000.f, 0.f, 1000.f, -100.f, 100.f));
+        const double frameMilliseconds = measure(REPETITIONS, [&emitter]() {
+            emitter.update(DELTA_TIME);
+            emitter.render();
+            glFinish();
+        });
+        report("particles", "simulation and render", frameMilliseconds, emitter.size());
+        std::cout << "particles/fits 60 Hz frame: " << (frameMilliseconds <= 1000.0 / 60.0 ? "yes" : "no") << std::endl;
+        return true;
+    }
+}
@@ -0,0 +1,88 @@
+#include "Benchmarks.h"
+#include "../Renderer/Texture2D.h"
+#include "../Resources/ResourceManager.h"
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace Benchmarks {
+    namespace {
+        const size_t RESOURCES_COUNT = 100000;
+        const unsigned int REPETITIONS = 5;
+        /* Every benchmark texture aliases the image of the default atlas, so registering them uploads nothing */
+        const char* TEXTURE_PATH = "res/textures/map_16x16.png";
+    }
+
+    /*
+    Texture lookups among 100k registered textures: by name (ordered map search and string compares, plus the shared_ptr copy)
+    against by handle (slot array index and generation check), and by stale handles that must resolve to nullptr
+    */
+    bool runResources(ResourceManager& resourceManager) {
+        std::vector <std::string> names(RESOURCES_COUNT);
+        for (size_t i = 0; i < RESOURCES_COUNT; ++i) {
+            names[i] = "ResourceBenchmarkTexture" + std::to_string(i);
+        }
+        bool isRegistered = true;
+        const double registerMilliseconds = measure(1, [&resourceManager, &names, &isRegistered]() {
+            for (const std::string& name : names) {
+                isRegistered = resourceManager.loadTexture(name, TEXTURE_PATH) != nullptr && isRegistered;
+            }
+        });
+        if (!isRegistered) {
+            std::cerr << "resources: can not register the textures" << std::endl;
+            return false;
+        }
+        report("resources", "register", registerMilliseconds, names.size());
+
+        /* Lookups in random order, as resources are used by a frame */
+        std::mt19937 random(1);
+        std::shuffle(names.begin(), names.end(), random);
+        std::vector <TextureHandle> handles(RESOURCES_COUNT);
+        std::vector <TextureHandle> staleHandles(RESOURCES_COUNT);
+        for (size_t i = 0; i < RESOURCES_COUNT; ++i) {
+            handles[i] = resourceManager.getTextureHandle(names[i]);
+            /* A handle of an earlier generation of the slot, as kept by a user of a released resource */
+            staleHandles[i] = handles[i];
+            staleHandles[i].generation += 1;
+        }
+
+        size_t foundCount = 0;
+        const double nameMilliseconds = measure(REPETITIONS, [&resourceManager, &names, &foundCount]() {
+            foundCount = 0;
+            for (const std::string& name : names) {
+                foundCount += resourceManager.getTexture(name) ? 1 : 0;
+            }
+        });
+        report("resources", "get by name", nameMilliseconds, names.size());
+        const size_t foundByNameCount = foundCount;
+
+        const double handleMilliseconds = measure(REPETITIONS, [&resourceManager, &handles, &foundCount]() {
+            foundCount = 0;
+            for (const TextureHandle handle : handles) {
+                foundCount += resourceManager.getTexture(handle) ? 1 : 0;
+            }
+        });
+        report("resources", "get by handle", handleMilliseconds, handles.size());
+        const size_t foundByHandleCount = foundCount;
+
+        const double staleMilliseconds = measure(REPETITIONS, [&resourceManager, &staleHandles, &foundCount]() {
+            foundCount = 0;
+            for (const TextureHandle handle : staleHandles) {
+                foundCount += resourceManager.getTexture(handle) ? 1 : 0;
+            }
+        });
+        report("resources", "get by stale handle", staleMilliseconds, staleHandles.size());
+        std::cout << "resources: handle lookups are " << nameMilliseconds / handleMilliseconds << " times faster than name lookups" << std::endl;
+
+        if (foundByNameCount != RESOURCES_COUNT || foundByHandleCount != RESOURCES_COUNT || foundCount != 0) {
+            std::cerr << "resources: found " << foundByNameCount << " textures by name and " << foundByHandleCount << " by handle of "
+                      << RESOURCES_COUNT << ", " << foundCount << " by stale handles" << std::endl;
+            return false;
+        }
+        return true;
+    }
+}
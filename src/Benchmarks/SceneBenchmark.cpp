@@ -0,0 +1,53 @@
+#include "Benchmarks.h"
+#include "../Scene/SceneGraph.h"
+
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace Benchmarks {
+    namespace {
+        const size_t NODES_COUNT = 100000;
+        const size_t MOVING_NODES_COUNT = NODES_COUNT / 100;
+        const unsigned int REPETITIONS = 10;
+    }
+
+    /* World transform updates of 100k nodes when 1% of them move */
+    bool runScene(ResourceManager&) {
+        /* Random tree: every node goes under one of the nodes created before it */
+        std::mt19937 random(1);
+        Scene::SceneGraph sceneGraph;
+        std::vector <Scene::NodeHandle> nodes;
+        nodes.reserve(NODES_COUNT);
+        nodes.push_back(sceneGraph.createNode());
+        for (size_t i = 1; i < NODES_COUNT; ++i) {
+            const Scene::NodeHandle parent = i < 100 ? Scene::NodeHandle{} : nodes[std::uniform_int_distribution<size_t>(0, i - 1)(random)];
+            nodes.push_back(sceneGraph.createNode(parent, Scene::LocalTransform{ glm::vec2(1.f, 0.f), glm::vec2(1.f), 1.f }));
+        }
+
+        report("scene", "full update", measure(1, [&sceneGraph]() {
+            sceneGraph.update();
+        }), NODES_COUNT);
+
+        std::vector <Scene::NodeHandle> movingNodes;
+        for (size_t i = 0; i < MOVING_NODES_COUNT; ++i) {
+            movingNodes.push_back(nodes[std::uniform_int_distribution<size_t>(0, NODES_COUNT - 1)(random)]);
+        }
+        float angle = 0.f;
+        size_t updatedNodesCount = 0;
+        report("scene", "1% moving", measure(REPETITIONS, [&]() {
+            angle += 1.f;
+            for (const Scene::NodeHandle node : movingNodes) {
+                sceneGraph.setLocalRotation(node, angle);
+            }
+            sceneGraph.update();
+            updatedNodesCount = sceneGraph.updatedNodesCount();
+        }), NODES_COUNT);
+        std::cout << "scene/world matrices recomputed per frame: " << updatedNodesCount << " of " << NODES_COUNT << std::endl;
+
+        report("scene", "no changes", measure(REPETITIONS, [&sceneGraph]() {
+            sceneGraph.update();
+        }), NODES_COUNT);
+        return true;
+    }
+}
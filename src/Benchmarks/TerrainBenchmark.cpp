@@ -0,0 +1,150 @@
+#include "Benchmarks.h"
+#include "../Renderer/ShaderProgram.h"
+#include "../Renderer/Texture2D.h"
+#include "../Renderer/TileMapRenderer.h"
+#include "../Resources/ResourceManager.h"
+#include "../Scene/AutoTiler.h"
+
+#include <glm/common.hpp>
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace Benchmarks {
+    namespace {
+        const int MAP_SIZE = 1024;              // Cells per side, 1M cells and 16M sub-cells
+        const float TILE_SIZE = 16.f;
+        const unsigned int HITS_COUNT = 100000;
+        const unsigned int QUERIES_COUNT = 1000000;
+        const unsigned int REPETITIONS = 3;
+        const Scene::TileMap::TileType BRICK = 1;
+
+        /* Reference query: test every sub-cell of every cell under the rectangle */
+        bool overlapsSolidSubCells(const Scene::TileMap& tileMap, const glm::vec2& min, const glm::vec2& max) {
+            glm::ivec2 first, last;
+            if (!tileMap.getCellRange(min, max, first, last)) {
+                return false;
+            }
+            const glm::vec2 subCellSize = tileMap.tileSize() / static_cast<float>(Scene::TileMap::SUB_CELLS);
+            for (int row = first.y; row <= last.y; ++row) {
+                for (int column = first.x; column <= last.x; ++column) {
+                    const Scene::TileMap::SubCellMask subCells = tileMap.getSubCells(column, row);
+                    for (int bit = 0; bit < Scene::TileMap::SUB_CELLS * Scene::TileMap::SUB_CELLS; ++bit) {
+                        if (!((subCells >> bit) & 1)) {
+                            continue;
+                        }
+                        const glm::vec2 subCellMin = tileMap.cellPosition(column, row)
+                                                   + glm::vec2(bit % Scene::TileMap::SUB_CELLS, bit / Scene::TileMap::SUB_CELLS) * subCellSize;
+                        if (glm::all(glm::lessThanEqual(subCellMin, max)) && glm::all(glm::lessThan(min, subCellMin + subCellSize))) {
+                            return true;
+                        }
+                    }
+                }
+            }
+            return false;
+        }
+    }
+
+    /*
+    Destructible terrain of a 1024x1024 brick map with 4x4 sub-cells per tile: shells chip strips of sub-cells
+    and every hit uploads only the changed cells, collision queries test the same sub-cell masks.
+    Query results are checked against a per-sub-cell reference
+    */
+    bool runTerrain(ResourceManager& resourceManager) {
+        if (!resourceManager.loadManifest("res/manifest.txt")) {
+            return false;
+        }
+        std::shared_ptr <Renderer::Texture2D> pAtlas = resourceManager.getTexture("DefaultTextureAtlas");
+        std::shared_ptr <Renderer::ShaderProgram> pShaderProgram = resourceManager.getShaderProgram("TileMapShaderProgram");
+        if (!pAtlas || !pShaderProgram) {
+            return false;
+        }
+
+        std::mt19937 random(1);
+        Scene::TileMap tileMap(MAP_SIZE, MAP_SIZE, glm::vec2(TILE_SIZE));
+        for (int row = 0; row < MAP_SIZE; ++row) {
+            for (int column = 0; column < MAP_SIZE; ++column) {
+                if (random() % 2 == 0) {
+                    tileMap.setTile(column, row, BRICK);
+                }
+            }
+        }
+        Scene::AutoTiler autoTiler(tileMap);
+        autoTiler.setImage(BRICK, static_cast<Scene::AutoTiler::CellImage>(pAtlas->getSubTextureId("brick")));
+        autoTiler.retileAll();
+        Renderer::TileMapRenderer renderer(pAtlas, pShaderProgram, MAP_SIZE, MAP_SIZE, glm::vec2(TILE_SIZE));
+        renderer.upload(autoTiler.images());
+        renderer.uploadSubCellsRegion(tileMap.subCells(), glm::ivec2(0), glm::ivec2(MAP_SIZE - 1));
+        renderer.takeUploadedBytes();
+        autoTiler.clearDirtyRects();
+        std::cout << "terrain/tile map: " << tileMap.sizeInBytes() << " bytes for " << static_cast<size_t>(MAP_SIZE) * MAP_SIZE * 16
+                  << " sub-cells" << std::endl;
+
+        /* A shell is a quarter of a tile thick and as wide as a tile, it hits a horizontal or vertical strip of sub-cells */
+        std::uniform_real_distribution<float> coordinate(0.f, MAP_SIZE * TILE_SIZE);
+        const glm::vec2 horizontalShell(TILE_SIZE, TILE_SIZE * 0.25f - 0.01f);
+        const glm::vec2 verticalShell(TILE_SIZE * 0.25f - 0.01f, TILE_SIZE);
+        size_t chippedCellsCount = 0;
+        const double hitsMilliseconds = measure(1, [&]() {
+            for (unsigned int hit = 0; hit < HITS_COUNT; ++hit) {
+                const glm::vec2 min(coordinate(random), coordinate(random));
+                chippedCellsCount += autoTiler.chipRect(min, min + (hit % 2 == 0 ? horizontalShell : verticalShell));
+                glm::ivec2 first, last;
+                while (autoTiler.takeDirtyRect(first, last)) {
+                    renderer.uploadRegion(autoTiler.images(), first, last);
+                    renderer.uploadSubCellsRegion(tileMap.subCells(), first, last);
+                }
+            }
+            glFinish();
+        });
+        report("terrain", "shell hit (chip and upload)", hitsMilliseconds, HITS_COUNT);
+        std::cout << "terrain/chipped cells per hit: " << static_cast<double>(chippedCellsCount) / HITS_COUNT
+                  << ", uploaded bytes per hit: " << static_cast<double>(renderer.takeUploadedBytes()) / HITS_COUNT << std::endl;
+
+        /* Tank-sized queries: the sub-cell test only runs for chipped tiles */
+        std::uniform_real_distribution<float> size(8.f, 24.f);
+        std::vector <glm::vec2> queries(QUERIES_COUNT * 2);
+        for (unsigned int i = 0; i < QUERIES_COUNT; ++i) {
+            queries[i * 2] = glm::vec2(coordinate(random), coordinate(random));
+            queries[i * 2 + 1] = queries[i * 2] + glm::vec2(size(random), size(random));
+        }
+        const auto overlapsSolid = [&tileMap](const glm::vec2& min, const glm::vec2& max) {
+            glm::ivec2 first, last;
+            if (!tileMap.getCellRange(min, max, first, last)) {
+                return false;
+            }
+            for (int row = first.y; row <= last.y; ++row) {
+                for (int column = first.x; column <= last.x; ++column) {
+                    if (tileMap.isSolid(column, row) && tileMap.overlapsSolid(column, row, min, max)) {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        };
+        size_t hitsCount = 0;
+        report("terrain", "collision query (sub-cell masks)", measure(REPETITIONS, [&]() {
+            hitsCount = 0;
+            for (unsigned int i = 0; i < QUERIES_COUNT; ++i) {
+                hitsCount += overlapsSolid(queries[i * 2], queries[i * 2 + 1]);
+            }
+        }), QUERIES_COUNT);
+        std::vector <uint8_t> referenceHits(QUERIES_COUNT);
+        report("terrain", "collision query (per sub-cell reference)", measure(1, [&]() {
+            for (unsigned int i = 0; i < QUERIES_COUNT; ++i) {
+                referenceHits[i] = overlapsSolidSubCells(tileMap, queries[i * 2], queries[i * 2 + 1]);
+            }
+        }), QUERIES_COUNT);
+        for (unsigned int i = 0; i < QUERIES_COUNT; ++i) {
+            if (referenceHits[i] != overlapsSolid(queries[i * 2], queries[i * 2 + 1])) {
+                std::cerr << "terrain: query " << i << " differs from the per sub-cell reference" << std::endl;
+                return false;
+            }
+        }
+        std::cout << "terrain/queries hitting solid sub-cells: " << hitsCount << std::endl;
+        return true;
+    }
+}
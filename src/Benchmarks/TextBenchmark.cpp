@@ -0,0 +1,73 @@
+#include "Benchmarks.h"
+#include "../Renderer/Font.h"
+#include "../Renderer/ShaderProgram.h"
+#include "../Renderer/TextBatch.h"
+#include "../Resources/ResourceManager.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Benchmarks {
+    namespace {
+        const size_t STRINGS_COUNT = 5000;
+        const unsigned int REPETITIONS = 5;
+    }
+
+    /* Overlay of 5000 strings (about 100k glyphs): cached layouts against laying out every string again */
+    bool runText(ResourceManager& resourceManager) {
+        if (!resourceManager.loadManifest("res/manifest.txt")) {
+            return false;
+        }
+        std::shared_ptr <Renderer::Font> pFont = resourceManager.getFont("DefaultFont");
+        std::shared_ptr <Renderer::ShaderProgram> pShaderProgram = resourceManager.getShaderProgram("TextShaderProgram");
+        if (!pFont || !pShaderProgram) {
+            return false;
+        }
+        pShaderProgram->use();
+        pShaderProgram->setMatrix4("projectionMat", glm::ortho(0.f, 1000.f, 0.f, 1000.f, -100.f, 100.f));
+        Renderer::TextBatch textBatch(pShaderProgram);
+
+        std::vector <std::string> strings;
+        size_t charactersCount = 0;
+        for (size_t i = 0; i < STRINGS_COUNT; ++i) {
+            strings.push_back("entity " + std::to_string(i) + ": hp 100/100");
+            charactersCount += strings.back().size();
+        }
+        auto addStrings = [&textBatch, &pFont, &strings]() {
+            for (size_t i = 0; i < strings.size(); ++i) {
+                textBatch.add(*pFont, strings[i], glm::vec2(static_cast<float>(i % 5) * 200.f, 1000.f - static_cast<float>(i / 5 % 60) * 16.f));
+            }
+        };
+
+        /* Layouts are computed on the first run and reused afterwards */
+        report("text", "cached layout", measure(REPETITIONS, [&textBatch, &addStrings]() {
+            addStrings();
+            textBatch.clear();
+        }), charactersCount);
+        std::cout << "text/layout hits: " << textBatch.layoutHits() << ", misses: " << textBatch.layoutMisses() << std::endl;
+
+        /* Every string differs from the previous run by the appended frame number, so every layout is a miss */
+        unsigned int run = 0;
+        report("text", "new layout", measure(REPETITIONS, [&textBatch, &pFont, &strings, &run]() {
+            const std::string suffix = " #" + std::to_string(run++);
+            for (size_t i = 0; i < strings.size(); ++i) {
+                textBatch.add(*pFont, strings[i] + suffix, glm::vec2(static_cast<float>(i % 5) * 200.f, 1000.f - static_cast<float>(i / 5 % 60) * 16.f));
+            }
+            textBatch.clear();
+        }), charactersCount);
+        std::cout << "text/layout hits: " << textBatch.layoutHits() << ", misses: " << textBatch.layoutMisses() << std::endl;
+
+        report("text", "cached layout and render", measure(REPETITIONS, [&textBatch, &addStrings]() {
+            addStrings();
+            textBatch.render();
+            glFinish();
+        }), charactersCount);
+        std::cout << "text/glyphs: " << textBatch.glyphsCount() << ", draw calls: " << textBatch.drawCalls()
+                  << ", font pages: " << pFont->pagesCount() << std::endl;
+        return true;
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "../Renderer/Texture2D.h"
+#include "../Physics/BroadPhase.h"
+
+#include <glm/vec2.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+
+namespace ECS {
+    /* Placement of an entity in the world. Same conventions as Renderer::Sprite: position of the lower left corner, rotation in degrees */
+    struct Transform {
+        glm::vec2 position = glm::vec2(0.f);
+        glm::vec2 size = glm::vec2(1.f);
+        float rotation = 0.f;
+    };
+
+    /* Image of an entity: a subtexture of a texture owned by the resource manager */
+    struct SpriteRef {
+        const Renderer::Texture2D* pTexture = nullptr;
+        Renderer::Texture2D::SubTextureId subTextureId = Renderer::Texture2D::INVALID_SUBTEXTURE_ID;
+    };
+
+    /* Linear velocity in units per second and angular velocity in degrees per second */
+    struct Velocity {
+        glm::vec2 linear = glm::vec2(0.f);
+        float angular = 0.f;
+    };
+
+    /* Playback state of an animation clip (see Renderer::AnimationLibrary) */
+    struct Animation {
+        uint32_t clip = 0;      // Renderer::AnimationClipId
+        float time = 0.f;       // Time in the clip, kept wrapped into the clip range
+        float speed = 1.f;
+    };
+
+    /* Draw order: lower layers are drawn first */
+    struct Layer {
+        int32_t order = 0;
+    };
+
+    /* Body of the entity in a Physics::BroadPhase, its bounds follow the Transform (see updateColliders) */
+    struct Collider {
+        Physics::BodyHandle body;
+    };
+
+    /* All component types. The position of a type in the list is its bit in a ComponentMask */
+    typedef std::tuple<Transform, SpriteRef, Velocity, Animation, Layer, Collider> ComponentTypes;
+    typedef uint32_t ComponentMask;
+
+    /* Position of a type in a tuple */
+    template <typename T, typename Tuple>
+    struct TypeIndex;
+    template <typename T, typename... Types>
+    struct TypeIndex<T, std::tuple<T, Types...>> {
+        static constexpr size_t value = 0;
+    };
+    template <typename T, typename U, typename... Types>
+    struct TypeIndex<T, std::tuple<U, Types...>> {
+        static constexpr size_t value = 1 + TypeIndex<T, std::tuple<Types...>>::value;
+    };
+
+    /* Bit of a component type in a ComponentMask */
+    template <typename Component>
+    constexpr ComponentMask componentBit() {
+        return ComponentMask(1) << TypeIndex<Component, ComponentTypes>::value;
+    }
+
+    /* Mask of a set of component types */
+    template <typename... Components>
+    constexpr ComponentMask componentMask() {
+        return (ComponentMask(0) | ... | componentBit<Components>());
+    }
+}
@@ -0,0 +1,80 @@
+#include "Systems.h"
+#include "../Renderer/SpriteBatch.h"
+#include "../Renderer/Animation.h"
+#include "../Physics/BroadPhase.h"
+
+#include <glm/trigonometric.hpp>
+
+namespace ECS {
+    /* Move and rotate entities with a Transform and a Velocity */
+    void integrateMotion(World& world, const float deltaTime) {
+        world.forEachChunk<Transform, Velocity>([deltaTime](const size_t count, Transform* transforms, const Velocity* velocities) {
+            for (size_t i = 0; i < count; ++i) {
+                transforms[i].position += velocities[i].linear * deltaTime;
+                transforms[i].rotation += velocities[i].angular * deltaTime;
+            }
+        });
+    }
+
+    /* Advance the Animation of entities and show the current frame of the clip in their SpriteRef */
+    void updateAnimations(World& world, const Renderer::AnimationLibrary& animations, const float deltaTime) {
+        world.forEachChunk<Animation, SpriteRef>([&animations, deltaTime](const size_t count, Animation* states, SpriteRef* sprites) {
+            /* Entities usually come in runs playing the same clip, so the clip is only looked up when it changes */
+            uint32_t clipId = Renderer::INVALID_ANIMATION_CLIP_ID;
+            const Renderer::AnimationClip* pClip = nullptr;
+            for (size_t i = 0; i < count; ++i) {
+                Animation& state = states[i];
+                if (state.clip != clipId) {
+                    clipId = state.clip;
+                    pClip = clipId < animations.clipsCount() ? &animations.getClip(clipId) : nullptr;
+                }
+                if (!pClip) {
+                    continue;
+                }
+                state.time = pClip->wrapTime(state.time + state.speed * deltaTime);
+                sprites[i].subTextureId = pClip->frameAt(state.time);
+            }
+        });
+    }
+
+    /* Move the broad phase bodies of entities with a Collider to the bounds of their Transform */
+    void updateColliders(const World& world, Physics::BroadPhase& broadPhase) {
+        world.forEachChunk<Transform, Collider>([&broadPhase](const size_t count, const Transform* transforms, const Collider* colliders) {
+            for (size_t i = 0; i < count; ++i) {
+                broadPhase.setBounds(colliders[i].body, Physics::spriteBounds(transforms[i].position, transforms[i].size, transforms[i].rotation));
+            }
+        });
+    }
+
+    /* Put all entities with a Transform and a SpriteRef into the sprite batch */
+    void extractSprites(const World& world, Renderer::SpriteBatch& spriteBatch) {
+        world.forEachArchetype<Transform, SpriteRef>([&spriteBatch](const Archetype& archetype) {
+            const size_t count = archetype.size();
+            const Transform* transforms = archetype.data<Transform>();
+            const SpriteRef* sprites = archetype.data<SpriteRef>();
+            const Layer* layers = archetype.has<Layer>() ? archetype.data<Layer>() : nullptr;
+
+            /* Rows with the same texture and layer are appended to the batch as one range */
+            size_t begin = 0;
+            while (begin < count) {
+                const Renderer::Texture2D* pTexture = sprites[begin].pTexture;
+                const int32_t layer = layers ? layers[begin].order : 0;
+                size_t end = begin + 1;
+                while (end < count && sprites[end].pTexture == pTexture && (layers ? layers[end].order : 0) == layer) {
+                    ++end;
+                }
+                if (pTexture) {
+                    Renderer::SpriteBatch::Instance* instances = spriteBatch.append(pTexture, layer, end - begin);
+                    for (size_t i = begin; i < end; ++i) {
+                        const Renderer::Texture2D::SubTexture2D subTexture = pTexture->getSubTexture(sprites[i].subTextureId);
+                        Renderer::SpriteBatch::Instance& instance = instances[i - begin];
+                        instance.positionSize = glm::vec4(transforms[i].position, transforms[i].size);
+                        instance.uvRect = glm::vec4(subTexture.leftBottomUV, subTexture.rightTopUV);
+                        instance.rotation = glm::radians(transforms[i].rotation);
+                    }
+                }
+                begin = end;
+            }
+        });
+    }
+}
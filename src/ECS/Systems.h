@@ -0,0 +1,26 @@
+#pragma once
+
+#include "World.h"
+
+namespace Renderer {
+    class SpriteBatch;
+    class AnimationLibrary;
+}
+
+namespace Physics {
+    class BroadPhase;
+}
+
+namespace ECS {
+    /* Move and rotate entities with a Transform and a Velocity */
+    void integrateMotion(World& world, const float deltaTime);
+
+    /* Advance the Animation of entities and show the current frame of the clip in their SpriteRef */
+    void updateAnimations(World& world, const Renderer::AnimationLibrary& animations, const float deltaTime);
+
+    /* Move the broad phase bodies of entities with a Collider to the bounds of their Transform */
+    void updateColliders(const World& world, Physics::BroadPhase& broadPhase);
+
+    /* Put all entities with a Transform and a SpriteRef into the sprite batch (Layer is optional, the default layer is 0) */
+    void extractSprites(const World& world, Renderer::SpriteBatch& spriteBatch);
+}
@@ -0,0 +1,123 @@
+#include "World.h"
+
+#include <utility>
+
+namespace ECS {
+    namespace {
+        /* Call function(column, bit) for every component column of an archetype */
+        template <typename Columns, typename Function, size_t... Indices>
+        void forEachColumn(Columns& columns, Function&& function, std::index_sequence<Indices...>) {
+            (function(std::get<Indices>(columns), ComponentMask(1) << Indices), ...);
+        }
+        template <typename Columns, typename Function>
+        void forEachColumn(Columns& columns, Function&& function) {
+            forEachColumn(columns, std::forward<Function>(function), std::make_index_sequence<std::tuple_size<Columns>::value>());
+        }
+    }
+
+    /* Add a row with default components and return its index */
+    size_t Archetype::appendRow(const Entity entity) {
+        const ComponentMask mask = m_mask;
+        forEachColumn(m_columns, [mask](auto& column, const ComponentMask bit) {
+            if (mask & bit) {
+                column.emplace_back();
+            }
+        });
+        m_entities.push_back(entity);
+        return m_entities.size() - 1;
+    }
+
+    /* Remove a row by moving the last row into it */
+    Entity Archetype::removeRow(const size_t row) {
+        const ComponentMask mask = m_mask;
+        forEachColumn(m_columns, [mask, row](auto& column, const ComponentMask bit) {
+            if (mask & bit) {
+                column[row] = std::move(column.back());
+                column.pop_back();
+            }
+        });
+        const bool isLastRow = row + 1 == m_entities.size();
+        m_entities[row] = m_entities.back();
+        m_entities.pop_back();
+        return isLastRow ? Entity{} : m_entities[row];
+    }
+
+    /* Copy the components the archetypes have in common from a row of another archetype */
+    void Archetype::copyRow(const size_t row, const Archetype& source, const size_t sourceRow) {
+        const ComponentMask commonMask = m_mask & source.m_mask;
+        forEachColumn(m_columns, [&source, commonMask, row, sourceRow](auto& column, const ComponentMask bit) {
+            if (commonMask & bit) {
+                typedef typename std::decay_t<decltype(column)>::value_type Component;
+                column[row] = std::get<std::vector <Component>>(source.m_columns)[sourceRow];
+            }
+        });
+    }
+
+    /* Reserve memory for rows */
+    void Archetype::reserve(const size_t rowCount) {
+        const ComponentMask mask = m_mask;
+        forEachColumn(m_columns, [mask, rowCount](auto& column, const ComponentMask bit) {
+            if (mask & bit) {
+                column.reserve(rowCount);
+            }
+        });
+        m_entities.reserve(rowCount);
+    }
+
+    /* Create an entity with default components of the mask */
+    Entity World::create(const ComponentMask mask) {
+        const uint32_t archetypeIndex = getArchetype(mask);
+        const Entity entity = m_entities.insert(EntityLocation{ archetypeIndex, 0 });
+        m_entities.get(entity)->row = static_cast<uint32_t>(m_archetypes[archetypeIndex]->appendRow(entity));
+        return entity;
+    }
+
+    /* Destroy an entity */
+    bool World::destroy(const Entity entity) {
+        const EntityLocation* pLocation = m_entities.get(entity);
+        if (!pLocation) {
+            return false;
+        }
+        removeRow(pLocation->archetype, pLocation->row);
+        return m_entities.erase(entity);
+    }
+
+    /* Reserve memory for entities of a component set */
+    void World::reserve(const ComponentMask mask, const size_t entityCount) {
+        m_archetypes[getArchetype(mask)]->reserve(entityCount);
+    }
+
+    /* Find or create the archetype of a component set */
+    uint32_t World::getArchetype(const ComponentMask mask) {
+        auto it = m_archetypeIndices.find(mask);
+        if (it != m_archetypeIndices.end()) {
+            return it->second;
+        }
+        const uint32_t archetypeIndex = static_cast<uint32_t>(m_archetypes.size());
+        m_archetypes.push_back(std::make_unique<Archetype>(mask));
+        m_archetypeIndices.emplace(mask, archetypeIndex);
+        return archetypeIndex;
+    }
+
+    /* Move an entity to the archetype of another component set */
+    void World::setMask(const Entity entity, const ComponentMask mask) {
+        EntityLocation location = *m_entities.get(entity);
+        const uint32_t archetypeIndex = getArchetype(mask);
+        if (archetypeIndex == location.archetype) {
+            return;
+        }
+        Archetype& archetype = *m_archetypes[archetypeIndex];
+        const size_t row = archetype.appendRow(entity);
+        archetype.copyRow(row, *m_archetypes[location.archetype], location.row);
+        removeRow(location.archetype, location.row);
+        *m_entities.get(entity) = EntityLocation{ archetypeIndex, static_cast<uint32_t>(row) };
+    }
+
+    /* Remove a row and fix the location of the entity moved into it */
+    void World::removeRow(const uint32_t archetypeIndex, const uint32_t row) {
+        const Entity movedEntity = m_archetypes[archetypeIndex]->removeRow(row);
+        if (movedEntity.isValid()) {
+            m_entities.get(movedEntity)->row = row;
+        }
+    }
+}
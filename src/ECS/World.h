@@ -0,0 +1,172 @@
+#pragma once
+
+#include "Components.h"
+#include "../System/HandlePool.h"
+
+#include <memory>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace ECS {
+    struct EntityTag {};
+    /* Stable entity ID: stays valid while the entity moves between rows and archetypes, becomes stale when the entity is destroyed */
+    typedef System::Handle<EntityTag> Entity;
+
+    /*
+    Storage of all entities that have the same set of components. Every component type has its own dense array
+    (structure of arrays) and row i of every array belongs to entity i, so systems iterate plain arrays
+    */
+    class Archetype {
+    public:
+        explicit Archetype(const ComponentMask mask) : m_mask(mask) {}
+
+        ComponentMask mask() const { return m_mask; }
+        template <typename Component>
+        bool has() const { return (m_mask & componentBit<Component>()) != 0; }
+
+        /* Number of entities (rows) */
+        size_t size() const { return m_entities.size(); }
+        const std::vector <Entity>& entities() const { return m_entities; }
+
+        /* Component array. Valid only if the archetype has the component, invalidated when rows are added */
+        template <typename Component>
+        Component* data() { return std::get<std::vector <Component>>(m_columns).data(); }
+        template <typename Component>
+        const Component* data() const { return std::get<std::vector <Component>>(m_columns).data(); }
+
+        /* Add a row with default components and return its index */
+        size_t appendRow(const Entity entity);
+        /* Remove a row by moving the last row into it. Returns the entity that was moved (invalid if there was none) */
+        Entity removeRow(const size_t row);
+        /* Copy the components the archetypes have in common from a row of another archetype */
+        void copyRow(const size_t row, const Archetype& source, const size_t sourceRow);
+        /* Reserve memory for rows */
+        void reserve(const size_t rowCount);
+
+    private:
+        /* One vector per component type, vectors of absent components stay empty */
+        template <typename Types>
+        struct ColumnsOf;
+        template <typename... Components>
+        struct ColumnsOf<std::tuple<Components...>> {
+            typedef std::tuple<std::vector <Components>...> type;
+        };
+
+        ComponentMask m_mask;
+        std::vector <Entity> m_entities;
+        ColumnsOf<ComponentTypes>::type m_columns;
+    };
+
+    /* Entities grouped into archetypes by their component sets */
+    class World {
+    public:
+        /* Create an entity with default components of the mask */
+        Entity create(const ComponentMask mask);
+        /* Create an entity with the given components */
+        template <typename... Components>
+        Entity create(const Components&... components) {
+            const Entity entity = create(componentMask<Components...>());
+            ((*get<Components>(entity) = components), ...);
+            return entity;
+        }
+        /* Destroy an entity. Its ID and all copies of it become stale */
+        bool destroy(const Entity entity);
+        bool isAlive(const Entity entity) const { return m_entities.contains(entity); }
+
+        /* Get a component of an entity. Returns nullptr for stale entities and absent components */
+        template <typename Component>
+        Component* get(const Entity entity) {
+            const EntityLocation* pLocation = m_entities.get(entity);
+            if (!pLocation || !m_archetypes[pLocation->archetype]->has<Component>()) {
+                return nullptr;
+            }
+            return m_archetypes[pLocation->archetype]->data<Component>() + pLocation->row;
+        }
+
+        /* Add a component to an entity (the entity moves to another archetype) */
+        template <typename Component>
+        Component* add(const Entity entity, const Component& component = Component()) {
+            const EntityLocation* pLocation = m_entities.get(entity);
+            if (!pLocation) {
+                return nullptr;
+            }
+            setMask(entity, m_archetypes[pLocation->archetype]->mask() | componentBit<Component>());
+            Component* pComponent = get<Component>(entity);
+            *pComponent = component;
+            return pComponent;
+        }
+        /* Remove a component from an entity (the entity moves to another archetype) */
+        template <typename Component>
+        bool remove(const Entity entity) {
+            const EntityLocation* pLocation = m_entities.get(entity);
+            if (!pLocation || !m_archetypes[pLocation->archetype]->has<Component>()) {
+                return false;
+            }
+            setMask(entity, m_archetypes[pLocation->archetype]->mask() & ~componentBit<Component>());
+            return true;
+        }
+
+        /* Call function(count, arrays...) for every non-empty archetype that has all the components */
+        template <typename... Components, typename Function>
+        void forEachChunk(Function&& function) {
+            const ComponentMask mask = componentMask<Components...>();
+            for (const std::unique_ptr <Archetype>& pArchetype : m_archetypes) {
+                if ((pArchetype->mask() & mask) == mask && pArchetype->size() != 0) {
+                    function(pArchetype->size(), pArchetype->data<Components>()...);
+                }
+            }
+        }
+        template <typename... Components, typename Function>
+        void forEachChunk(Function&& function) const {
+            const ComponentMask mask = componentMask<Components...>();
+            for (const std::unique_ptr <Archetype>& pArchetype : m_archetypes) {
+                if ((pArchetype->mask() & mask) == mask && pArchetype->size() != 0) {
+                    function(pArchetype->size(), static_cast<const Archetype&>(*pArchetype).data<Components>()...);
+                }
+            }
+        }
+        /* Call function(components...) for every entity that has all the components */
+        template <typename... Components, typename Function>
+        void forEach(Function&& function) {
+            forEachChunk<Components...>([&function](const size_t count, Components*... arrays) {
+                for (size_t i = 0; i < count; ++i) {
+                    function(arrays[i]...);
+                }
+            });
+        }
+        /* Call function(archetype) for every non-empty archetype that has all the components (for optional components) */
+        template <typename... Components, typename Function>
+        void forEachArchetype(Function&& function) const {
+            const ComponentMask mask = componentMask<Components...>();
+            for (const std::unique_ptr <Archetype>& pArchetype : m_archetypes) {
+                if ((pArchetype->mask() & mask) == mask && pArchetype->size() != 0) {
+                    function(static_cast<const Archetype&>(*pArchetype));
+                }
+            }
+        }
+
+        /* Reserve memory for entities of a component set */
+        void reserve(const ComponentMask mask, const size_t entityCount);
+        /* Number of live entities */
+        size_t size() const { return m_entities.size(); }
+
+    private:
+        struct EntityLocation {
+            uint32_t archetype = 0;
+            uint32_t row = 0;
+        };
+
+        /* Find or create the archetype of a component set */
+        uint32_t getArchetype(const ComponentMask mask);
+        /* Move an entity to the archetype of another component set */
+        void setMask(const Entity entity, const ComponentMask mask);
+        /* Remove a row and fix the location of the entity moved into it */
+        void removeRow(const uint32_t archetypeIndex, const uint32_t row);
+
+        System::HandlePool <EntityLocation, EntityTag> m_entities;
+        /* Archetypes are never removed, so their indices stay valid */
+        std::vector <std::unique_ptr <Archetype>> m_archetypes;
+        std::unordered_map <ComponentMask, uint32_t> m_archetypeIndices;
+    };
+}
@@ -0,0 +1,94 @@
+#include "CallCounter.h"
+
+#include <glad/glad.h>
+
+namespace Harness {
+    namespace CallCounter {
+        namespace {
+            /* GL calls are made from the thread of the context only */
+            Counters gCounters;
+
+/* Wrapper of a GL function that increments a counter and forwards the call to the driver function GLAD loaded */
+#define COUNTED_GL_CALL(name, counter, parameters, arguments) \
+            decltype(glad_##name) original_##name = nullptr; \
+            void APIENTRY counted_##name parameters { \
+                ++gCounters.counter; \
+                original_##name arguments; \
+            }
+
+            COUNTED_GL_CALL(glDrawArrays, drawCalls, (GLenum mode, GLint first, GLsizei count), (mode, first, count))
+            COUNTED_GL_CALL(glDrawElements, drawCalls, (GLenum mode, GLsizei count, GLenum type, const void* indices), (mode, count, type, indices))
+            COUNTED_GL_CALL(glDrawArraysInstanced, drawCalls, (GLenum mode, GLint first, GLsizei count, GLsizei instances), (mode, first, count, instances))
+            COUNTED_GL_CALL(glDrawElementsInstanced, drawCalls, (GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instances),
+                            (mode, count, type, indices, instances))
+
+            COUNTED_GL_CALL(glUseProgram, stateChanges, (GLuint program), (program))
+            COUNTED_GL_CALL(glActiveTexture, stateChanges, (GLenum unit), (unit))
+            COUNTED_GL_CALL(glBindTexture, stateChanges, (GLenum target, GLuint texture), (target, texture))
+            COUNTED_GL_CALL(glBindBuffer, stateChanges, (GLenum target, GLuint buffer), (target, buffer))
+            COUNTED_GL_CALL(glBindBufferBase, stateChanges, (GLenum target, GLuint index, GLuint buffer), (target, index, buffer))
+            COUNTED_GL_CALL(glBindVertexArray, stateChanges, (GLuint vertexArray), (vertexArray))
+            COUNTED_GL_CALL(glBindFramebuffer, stateChanges, (GLenum target, GLuint framebuffer), (target, framebuffer))
+            COUNTED_GL_CALL(glEnable, stateChanges, (GLenum capability), (capability))
+            COUNTED_GL_CALL(glDisable, stateChanges, (GLenum capability), (capability))
+            COUNTED_GL_CALL(glBlendFunc, stateChanges, (GLenum source, GLenum destination), (source, destination))
+            COUNTED_GL_CALL(glViewport, stateChanges, (GLint x, GLint y, GLsizei width, GLsizei height), (x, y, width, height))
+            COUNTED_GL_CALL(glScissor, stateChanges, (GLint x, GLint y, GLsizei width, GLsizei height), (x, y, width, height))
+
+            COUNTED_GL_CALL(glUniform1i, uniformUpdates, (GLint location, GLint x), (location, x))
+            COUNTED_GL_CALL(glUniform1ui, uniformUpdates, (GLint location, GLuint x), (location, x))
+            COUNTED_GL_CALL(glUniform1f, uniformUpdates, (GLint location, GLfloat x), (location, x))
+            COUNTED_GL_CALL(glUniform2i, uniformUpdates, (GLint location, GLint x, GLint y), (location, x, y))
+            COUNTED_GL_CALL(glUniform2f, uniformUpdates, (GLint location, GLfloat x, GLfloat y), (location, x, y))
+            COUNTED_GL_CALL(glUniform4f, uniformUpdates, (GLint location, GLfloat x, GLfloat y, GLfloat z, GLfloat w), (location, x, y, z, w))
+            COUNTED_GL_CALL(glUniformMatrix4fv, uniformUpdates, (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value),
+                            (location, count, transpose, value))
+
+#undef COUNTED_GL_CALL
+        }
+
+        /* Install the wrappers */
+        void install() {
+/* Keep the driver function and put the wrapper in its place, once */
+#define INSTALL_COUNTED_GL_CALL(name) \
+            if (!original_##name) { \
+                original_##name = glad_##name; \
+                glad_##name = counted_##name; \
+            }
+
+            INSTALL_COUNTED_GL_CALL(glDrawArrays)
+            INSTALL_COUNTED_GL_CALL(glDrawElements)
+            INSTALL_COUNTED_GL_CALL(glDrawArraysInstanced)
+            INSTALL_COUNTED_GL_CALL(glDrawElementsInstanced)
+            INSTALL_COUNTED_GL_CALL(glUseProgram)
+            INSTALL_COUNTED_GL_CALL(glActiveTexture)
+            INSTALL_COUNTED_GL_CALL(glBindTexture)
+            INSTALL_COUNTED_GL_CALL(glBindBuffer)
+            INSTALL_COUNTED_GL_CALL(glBindBufferBase)
+            INSTALL_COUNTED_GL_CALL(glBindVertexArray)
+            INSTALL_COUNTED_GL_CALL(glBindFramebuffer)
+            INSTALL_COUNTED_GL_CALL(glEnable)
+            INSTALL_COUNTED_GL_CALL(glDisable)
+            INSTALL_COUNTED_GL_CALL(glBlendFunc)
+            INSTALL_COUNTED_GL_CALL(glViewport)
+            INSTALL_COUNTED_GL_CALL(glScissor)
+            INSTALL_COUNTED_GL_CALL(glUniform1i)
+            INSTALL_COUNTED_GL_CALL(glUniform1ui)
+            INSTALL_COUNTED_GL_CALL(glUniform1f)
+            INSTALL_COUNTED_GL_CALL(glUniform2i)
+            INSTALL_COUNTED_GL_CALL(glUniform2f)
+            INSTALL_COUNTED_GL_CALL(glUniform4f)
+            INSTALL_COUNTED_GL_CALL(glUniformMatrix4fv)
+
+#undef INSTALL_COUNTED_GL_CALL
+            gCounters = Counters();
+        }
+
+        /* Get the counters since the last call and reset them */
+        Counters take() {
+            const Counters counters = gCounters;
+            gCounters = Counters();
+            return counters;
+        }
+    }
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Harness {
+    /*
+    Counts the OpenGL calls of the engine by replacing the GLAD function pointers with counting wrappers
+    that forward to the driver. The engine code is not changed, so the counts are those of the real renderers
+    */
+    namespace CallCounter {
+        struct Counters {
+            uint64_t drawCalls = 0;         // glDrawArrays, glDrawElements and their instanced variants
+            uint64_t stateChanges = 0;      // Program, texture, buffer, vertex array and framebuffer bindings, capabilities, blending, viewport
+            uint64_t uniformUpdates = 0;    // glUniform* calls
+        };
+
+        /* Install the wrappers, GLAD must be loaded */
+        void install();
+        /* Get the counters since the last call and reset them */
+        Counters take();
+    }
+}
@@ -0,0 +1,451 @@
+#include "Scenes.h"
+#include "../Renderer/Font.h"
+#include "../Renderer/LayerStack.h"
+#include "../Renderer/ShaderProgram.h"
+#include "../Renderer/Sprite.h"
+#include "../Renderer/SpriteBatch.h"
+#include "../Renderer/TextBatch.h"
+#include "../Renderer/Texture2D.h"
+#include "../Renderer/TileMapRenderer.h"
+#include "../Resources/ResourceManager.h"
+#include "../Scene/AutoTiler.h"
+
+#include <glad/glad.h>
+#include <glm/common.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+
+namespace Harness {
+    namespace {
+        const Scene::TileMap::TileType BRICK = 1;
+        const Scene::TileMap::TileType CONCRETE = 2;
+
+        /* The distributions of the standard library differ between implementations, the engine of the generator does not */
+        int randomInt(std::mt19937& random, const int count) {
+            return static_cast<int>(random() % static_cast<uint32_t>(count));
+        }
+
+        glm::mat4 frameProjection(const glm::ivec2& frameSize) {
+            return glm::ortho(0.f, static_cast<float>(frameSize.x), 0.f, static_cast<float>(frameSize.y), -100.f, 100.f);
+        }
+
+        /* Textured triangle of main.cpp */
+        class Triangle {
+        public:
+            Triangle() {
+                const GLfloat vertices[] = {
+                    0.0f, 50.f, 0.0f,
+                    50.f, -50.f, 0.0f,
+                   -50.f, -50.f, 0.0f
+                };
+                const GLfloat texCoordinates[] = {
+                    0.5f, 1.0f,
+                    1.0f, 0.0f,
+                    0.0f, 0.0f
+                };
+                glGenBuffers(1, &m_vertices_vbo);
+                glBindBuffer(GL_ARRAY_BUFFER, m_vertices_vbo);
+                glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+                glGenBuffers(1, &m_texCoordinates_vbo);
+                glBindBuffer(GL_ARRAY_BUFFER, m_texCoordinates_vbo);
+                glBufferData(GL_ARRAY_BUFFER, sizeof(texCoordinates), texCoordinates, GL_STATIC_DRAW);
+
+                glGenVertexArrays(1, &m_vao);
+                glBindVertexArray(m_vao);
+                glEnableVertexAttribArray(0);
+                glBindBuffer(GL_ARRAY_BUFFER, m_vertices_vbo);
+                glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+                glEnableVertexAttribArray(1);
+                glBindBuffer(GL_ARRAY_BUFFER, m_texCoordinates_vbo);
+                glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+                glBindVertexArray(0);
+                glBindBuffer(GL_ARRAY_BUFFER, 0);
+            }
+
+            ~Triangle() {
+                glDeleteVertexArrays(1, &m_vao);
+                glDeleteBuffers(1, &m_texCoordinates_vbo);
+                glDeleteBuffers(1, &m_vertices_vbo);
+            }
+
+            Triangle(const Triangle&) = delete;
+            Triangle& operator = (const Triangle&) = delete;
+
+            GLuint vao() const { return m_vao; }
+
+        private:
+            GLuint m_vertices_vbo = 0;
+            GLuint m_texCoordinates_vbo = 0;
+            GLuint m_vao = 0;
+        };
+
+        /* Auto-tiled map of brick walls and concrete blocks with its renderer, shared by the tile map scenes */
+        struct TerrainMap {
+            TerrainMap(std::shared_ptr <Renderer::Texture2D> pAtlas, std::shared_ptr <Renderer::ShaderProgram> pShaderProgram, const int columns, const int rows, const float tileSize)
+                : tileMap(columns, rows, glm::vec2(tileSize))
+                , autoTiler(tileMap)
+                , renderer(std::move(pAtlas), std::move(pShaderProgram), columns, rows, glm::vec2(tileSize)) {
+            }
+
+            /* Upload the changed cells and get the rectangle around them in world coordinates */
+            bool uploadChanges(glm::vec2& min, glm::vec2& max) {
+                bool isChanged = false;
+                glm::ivec2 first, last;
+                while (autoTiler.takeDirtyRect(first, last)) {
+                    renderer.uploadRegion(autoTiler.images(), first, last);
+                    renderer.uploadSubCellsRegion(tileMap.subCells(), first, last);
+                    min = isChanged ? glm::min(min, tileMap.cellPosition(first.x, first.y)) : tileMap.cellPosition(first.x, first.y);
+                    max = isChanged ? glm::max(max, tileMap.cellPosition(last.x + 1, last.y + 1)) : tileMap.cellPosition(last.x + 1, last.y + 1);
+                    isChanged = true;
+                }
+                return isChanged;
+            }
+
+            Scene::TileMap tileMap;
+            Scene::AutoTiler autoTiler;
+            Renderer::TileMapRenderer renderer;
+        };
+
+        std::shared_ptr <TerrainMap> createTerrainMap(ResourceManager& resourceManager, const int columns, const int rows, const float tileSize) {
+            std::shared_ptr <Renderer::Texture2D> pAtlas = resourceManager.getTexture("DefaultTextureAtlas");
+            std::shared_ptr <Renderer::ShaderProgram> pShaderProgram = resourceManager.getShaderProgram("TileMapShaderProgram");
+            if (!pAtlas || !pShaderProgram) {
+                return nullptr;
+            }
+            auto pTerrain = std::make_shared<TerrainMap>(pAtlas, pShaderProgram, columns, rows, tileSize);
+
+            pTerrain->tileMap.fillWithBlocks(1, BRICK, CONCRETE);
+            pTerrain->autoTiler.setEdgeImages(BRICK, Scene::AutoTiler::EdgeImages::fromAtlas(*pAtlas, "brick"));
+            pTerrain->autoTiler.setImage(CONCRETE, static_cast<Scene::AutoTiler::CellImage>(pAtlas->getSubTextureId("concrete")));
+            pTerrain->autoTiler.retileAll();
+            pTerrain->renderer.upload(pTerrain->autoTiler.images());
+            pTerrain->autoTiler.clearDirtyRects();
+            return pTerrain;
+        }
+
+        /* Shell hits of a frame: a horizontal or vertical strip of sub-cells is chipped at a random place */
+        void hitTerrain(TerrainMap& terrain, std::mt19937& random, const unsigned int hitsCount) {
+            const glm::vec2 tileSize = terrain.tileMap.tileSize();
+            const glm::ivec2 mapSize(terrain.tileMap.columns(), terrain.tileMap.rows());
+            for (unsigned int hit = 0; hit < hitsCount; ++hit) {
+                const glm::vec2 min(static_cast<float>(randomInt(random, mapSize.x * 4)) * tileSize.x * 0.25f,
+                                    static_cast<float>(randomInt(random, mapSize.y * 4)) * tileSize.y * 0.25f);
+                const glm::vec2 shell = hit % 2 == 0 ? glm::vec2(tileSize.x, tileSize.y * 0.25f) : glm::vec2(tileSize.x * 0.25f, tileSize.y);
+                terrain.autoTiler.chipRect(min + 0.01f, min + shell - 0.01f);
+            }
+        }
+
+        /* The triangles and the sprite of main.cpp */
+        FrameFunction createTrianglesAndSprite(ResourceManager& resourceManager, const glm::ivec2& frameSize) {
+            std::shared_ptr <Renderer::ShaderProgram> pDefaultShaderProgram = resourceManager.getShaderProgram("DefaultShaderProgram");
+            std::shared_ptr <Renderer::ShaderProgram> pSpriteShaderProgram = resourceManager.getShaderProgram("SpriteShaderProgram");
+            std::shared_ptr <Renderer::Texture2D> pDefaultTexture = resourceManager.getTexture("DefaultTexture");
+            std::shared_ptr <Renderer::Sprite> pSprite = resourceManager.getSprite("Sprite");
+            if (!pDefaultShaderProgram || !pSpriteShaderProgram || !pDefaultTexture || !pSprite) {
+                return nullptr;
+            }
+            pDefaultShaderProgram->use();
+            pDefaultShaderProgram->setTexture("tex", 0);
+            pDefaultShaderProgram->setMatrix4("projectionMat", frameProjection(frameSize));
+            pSpriteShaderProgram->use();
+            pSpriteShaderProgram->setTexture("tex", 0);
+            pSpriteShaderProgram->setMatrix4("projectionMat", frameProjection(frameSize));
+
+            auto pTriangle = std::make_shared<Triangle>();
+            const GLint modelMatrixLocation = pDefaultShaderProgram->getUniformLocation("modelMat");
+            const glm::mat4 modelMatrix_1 = glm::translate(glm::mat4(1.f), glm::vec3(100.f, 50.f, 0.f));
+            const glm::mat4 modelMatrix_2 = glm::translate(glm::mat4(1.f), glm::vec3(540.f, 50.f, 0.f));
+            return [=](const unsigned int) {
+                pDefaultShaderProgram->use();
+                glBindVertexArray(pTriangle->vao());
+                pDefaultTexture->bind();
+                pDefaultShaderProgram->setMatrix4(modelMatrixLocation, modelMatrix_1);
+                glDrawArrays(GL_TRIANGLES, 0, 3);
+                pDefaultShaderProgram->setMatrix4(modelMatrixLocation, modelMatrix_2);
+                glDrawArrays(GL_TRIANGLES, 0, 3);
+                glBindVertexArray(0);
+
+                pSpriteShaderProgram->use();
+                pSprite->setSize(glm::vec2(100.f));
+                pSprite->setPosition(glm::vec2(300.f, 100.f));
+                pSprite->render();
+            };
+        }
+
+        /* 1000 sprites drawn one by one, one draw call each, drifting every frame */
+        FrameFunction createSprites(ResourceManager& resourceManager, const glm::ivec2& frameSize) {
+            const unsigned int SPRITES_COUNT = 1000;
+            std::shared_ptr <Renderer::ShaderProgram> pSpriteShaderProgram = resourceManager.getShaderProgram("SpriteShaderProgram");
+            std::shared_ptr <Renderer::Sprite> pSprite = resourceManager.getSprite("Sprite");
+            if (!pSpriteShaderProgram || !pSprite) {
+                return nullptr;
+            }
+            pSpriteShaderProgram->use();
+            pSpriteShaderProgram->setTexture("tex", 0);
+            pSpriteShaderProgram->setMatrix4("projectionMat", frameProjection(frameSize));
+
+            std::mt19937 random(1);
+            auto pPositions = std::make_shared<std::vector <glm::ivec2>>(SPRITES_COUNT);
+            for (glm::ivec2& position : *pPositions) {
+                position = glm::ivec2(randomInt(random, frameSize.x), randomInt(random, frameSize.y));
+            }
+            return [=](const unsigned int frame) {
+                pSpriteShaderProgram->use();
+                pSprite->setSize(glm::vec2(100.f));
+                for (size_t i = 0; i < pPositions->size(); ++i) {
+                    const glm::ivec2 position = ((*pPositions)[i] + glm::ivec2(static_cast<int>(frame) * (1 + static_cast<int>(i % 3)), 0)) % frameSize;
+                    pSprite->setPosition(glm::vec2(position) - 50.f);
+                    pSprite->render();
+                }
+            };
+        }
+
+        /* 20000 spinning atlas tiles drawn with the instanced sprite batch */
+        FrameFunction createSpriteBatch(ResourceManager& resourceManager, const glm::ivec2& frameSize) {
+            const unsigned int SPRITES_COUNT = 20000;
+            std::shared_ptr <Renderer::ShaderProgram> pShaderProgram = resourceManager.getShaderProgram("SpriteBatchShaderProgram");
+            std::shared_ptr <Renderer::Texture2D> pAtlas = resourceManager.getTexture("DefaultTextureAtlas");
+            if (!pShaderProgram || !pAtlas) {
+                return nullptr;
+            }
+            pShaderProgram->use();
+            pShaderProgram->setTexture("tex", 0);
+            pShaderProgram->setMatrix4("projectionMat", frameProjection(frameSize));
+
+            auto pSpriteBatch = std::make_shared<Renderer::SpriteBatch>(pShaderProgram);
+            std::mt19937 random(1);
+            auto pPositions = std::make_shared<std::vector <glm::ivec2>>(SPRITES_COUNT);
+            for (glm::ivec2& position : *pPositions) {
+                position = glm::ivec2(randomInt(random, frameSize.x), randomInt(random, frameSize.y));
+            }
+            const int tilesCount = static_cast<int>(pAtlas->subTexturesCount());
+            return [=](const unsigned int frame) {
+                for (size_t i = 0; i < pPositions->size(); ++i) {
+                    pSpriteBatch->add(pAtlas.get(), static_cast<int32_t>(i % 4), glm::vec2((*pPositions)[i] - 8), glm::vec2(16.f),
+                                      static_cast<float>((frame * 3 + i) % 360), static_cast<Renderer::Texture2D::SubTextureId>(i % tilesCount));
+                }
+                pSpriteBatch->render();
+            };
+        }
+
+        /* A 256x256 auto-tiled map scrolled under the camera, with shells chipping it every frame */
+        FrameFunction createTileMap(ResourceManager& resourceManager, const glm::ivec2& frameSize) {
+            std::shared_ptr <Renderer::ShaderProgram> pShaderProgram = resourceManager.getShaderProgram("TileMapShaderProgram");
+            std::shared_ptr <TerrainMap> pTerrain = createTerrainMap(resourceManager, 256, 256, 16.f);
+            if (!pShaderProgram || !pTerrain) {
+                return nullptr;
+            }
+            auto pRandom = std::make_shared<std::mt19937>(2);
+            return [=](const unsigned int frame) {
+                hitTerrain(*pTerrain, *pRandom, 64);
+                glm::vec2 min, max;
+                pTerrain->uploadChanges(min, max);
+
+                const glm::vec2 camera(static_cast<float>(frame * 4 % 2048), static_cast<float>(frame * 2 % 2048));
+                pShaderProgram->use();
+                pShaderProgram->setMatrix4("projectionMat", glm::ortho(camera.x, camera.x + frameSize.x, camera.y, camera.y + frameSize.y, -100.f, 100.f));
+                pTerrain->renderer.render();
+            };
+        }
+
+        /* A tile map and 300 sprites cached as a static layer under a dynamic sprite batch, shells redraw only the hit cells */
+        FrameFunction createLayers(ResourceManager& resourceManager, const glm::ivec2& frameSize) {
+            const unsigned int STATIC_SPRITES_COUNT = 300;
+            const unsigned int DYNAMIC_SPRITES_COUNT = 500;
+            std::shared_ptr <Renderer::ShaderProgram> pTileMapShaderProgram = resourceManager.getShaderProgram("TileMapShaderProgram");
+            std::shared_ptr <Renderer::ShaderProgram> pSpriteShaderProgram = resourceManager.getShaderProgram("SpriteShaderProgram");
+            std::shared_ptr <Renderer::ShaderProgram> pSpriteBatchShaderProgram = resourceManager.getShaderProgram("SpriteBatchShaderProgram");
+            std::shared_ptr <Renderer::ShaderProgram> pCompositeShaderProgram = resourceManager.getShaderProgram("LayerCompositeShaderProgram");
+            std::shared_ptr <Renderer::Texture2D> pAtlas = resourceManager.getTexture("DefaultTextureAtlas");
+            std::shared_ptr <Renderer::Sprite> pSprite = resourceManager.getSprite("Sprite");
+            std::shared_ptr <TerrainMap> pTerrain = createTerrainMap(resourceManager, frameSize.x / 16, frameSize.y / 16, 16.f);
+            if (!pTileMapShaderProgram || !pSpriteShaderProgram || !pSpriteBatchShaderProgram || !pCompositeShaderProgram || !pAtlas || !pSprite || !pTerrain) {
+                return nullptr;
+            }
+            pSpriteShaderProgram->use();
+            pSpriteShaderProgram->setTexture("tex", 0);
+            pSpriteBatchShaderProgram->use();
+            pSpriteBatchShaderProgram->setTexture("tex", 0);
+
+            std::mt19937 random(1);
+            auto pStaticPositions = std::make_shared<std::vector <glm::vec2>>(STATIC_SPRITES_COUNT);
+            for (glm::vec2& position : *pStaticPositions) {
+                position = glm::vec2(randomInt(random, frameSize.x - 96), randomInt(random, frameSize.y - 96));
+            }
+            auto pDynamicPositions = std::make_shared<std::vector <glm::ivec2>>(DYNAMIC_SPRITES_COUNT);
+            for (glm::ivec2& position : *pDynamicPositions) {
+                position = glm::ivec2(randomInt(random, frameSize.x), randomInt(random, frameSize.y));
+            }
+
+            auto pLayerStack = std::make_shared<Renderer::LayerStack>(pCompositeShaderProgram, frameSize);
+            const size_t background = pLayerStack->addLayer([=](const glm::mat4& projectionMatrix) {
+                pTileMapShaderProgram->use();
+                pTileMapShaderProgram->setMatrix4("projectionMat", projectionMatrix);
+                pTerrain->renderer.render();
+                pSpriteShaderProgram->use();
+                pSpriteShaderProgram->setMatrix4("projectionMat", projectionMatrix);
+                /* A whole number of pixels per texel, so the cached pixels are the same as the drawn ones */
+                pSprite->setSize(glm::vec2(96.f));
+                for (const glm::vec2& position : *pStaticPositions) {
+                    pSprite->setPosition(position);
+                    pSprite->render();
+                }
+                return STATIC_SPRITES_COUNT + 1;
+            }, true);
+            auto pSpriteBatch = std::make_shared<Renderer::SpriteBatch>(pSpriteBatchShaderProgram);
+            pLayerStack->addLayer([=](const glm::mat4& projectionMatrix) {
+                pSpriteBatchShaderProgram->use();
+                pSpriteBatchShaderProgram->setMatrix4("projectionMat", projectionMatrix);
+                pSpriteBatch->render();
+                return pSpriteBatch->drawCalls();
+            });
+
+            auto pRandom = std::make_shared<std::mt19937>(2);
+            const int tilesCount = static_cast<int>(pAtlas->subTexturesCount());
+            return [=](const unsigned int frame) {
+                hitTerrain(*pTerrain, *pRandom, 1);
+                glm::vec2 min, max;
+                if (pTerrain->uploadChanges(min, max)) {
+                    pLayerStack->invalidate(background, min, max);
+                }
+                for (size_t i = 0; i < pDynamicPositions->size(); ++i) {
+                    const glm::ivec2 position = ((*pDynamicPositions)[i] + glm::ivec2(0, static_cast<int>(frame) * 2)) % frameSize;
+                    pSpriteBatch->add(pAtlas.get(), 0, glm::vec2(position), glm::vec2(16.f), 0.f, static_cast<Renderer::Texture2D::SubTextureId>(i % tilesCount));
+                }
+                pLayerStack->render(glm::vec2(0.f));
+            };
+        }
+
+        /* 30 lines of text changing every frame, drawn with the text batch */
+        FrameFunction createText(ResourceManager& resourceManager, const glm::ivec2& frameSize) {
+            const int LINES_COUNT = 30;
+            std::shared_ptr <Renderer::ShaderProgram> pShaderProgram = resourceManager.getShaderProgram("TextShaderProgram");
+            std::shared_ptr <Renderer::Font> pFont = resourceManager.getFont("DefaultFont");
+            if (!pShaderProgram || !pFont) {
+                return nullptr;
+            }
+            pShaderProgram->use();
+            pShaderProgram->setMatrix4("projectionMat", frameProjection(frameSize));
+
+            auto pTextBatch = std::make_shared<Renderer::TextBatch>(pShaderProgram);
+            auto pLine = std::make_shared<std::string>();
+            return [=](const unsigned int frame) {
+                for (int line = 0; line < LINES_COUNT; ++line) {
+                    *pLine = "Frame " + std::to_string(frame) + ", line " + std::to_string(line) + ": the quick brown fox jumps over the lazy dog";
+                    const float y = static_cast<float>(frameSize.y) - 8.f - static_cast<float>(line) * static_cast<float>(frameSize.y) / LINES_COUNT;
+                    pTextBatch->add(*pFont, *pLine, glm::vec2(8.f, y), glm::vec4(1.f, 1.f, 0.6f, 1.f));
+                }
+                pTextBatch->render();
+            };
+        }
+
+        /* Texture memory budget of a scene, the budget is lifted when the scene is destroyed */
+        class TextureMemoryBudget {
+        public:
+            TextureMemoryBudget(ResourceManager& resourceManager, const size_t budgetBytes)
+                : m_resourceManager(resourceManager) {
+                m_resourceManager.setTextureMemoryBudget(budgetBytes);
+            }
+            ~TextureMemoryBudget() { m_resourceManager.setTextureMemoryBudget(0); }
+
+            TextureMemoryBudget(const TextureMemoryBudget&) = delete;
+            TextureMemoryBudget& operator = (const TextureMemoryBudget&) = delete;
+
+        private:
+            ResourceManager& m_resourceManager;
+        };
+
+        /*
+        Four images under a budget that fits two of them: every frame draws the pair that was not drawn in the frame before,
+        so the resource manager evicts the other pair at the beginning of the frame and the drawn pair is reloaded on bind
+        */
+        FrameFunction createTextureBudget(ResourceManager& resourceManager, const glm::ivec2& frameSize) {
+            const size_t TEXTURES_COUNT = 4;
+            std::shared_ptr <Renderer::ShaderProgram> pShaderProgram = resourceManager.getShaderProgram("SpriteBatchShaderProgram");
+            if (!pShaderProgram) {
+                return nullptr;
+            }
+            /* Images resident before the scene (e.g. the atlas pinned by sprites) stay within the budget */
+            const size_t residentBytes = resourceManager.getTextureResidencyStatistics().residentBytes;
+            auto pTextures = std::make_shared<std::vector <std::shared_ptr <Renderer::Texture2D>>>();
+            for (size_t i = 0; i < TEXTURES_COUNT; ++i) {
+                const std::string index = std::to_string(i);
+                pTextures->push_back(resourceManager.loadTexture("ResidencyTexture" + index, "res/textures/residency_" + index + ".png"));
+                if (!pTextures->back()) {
+                    return nullptr;
+                }
+            }
+            pShaderProgram->use();
+            pShaderProgram->setTexture("tex", 0);
+            pShaderProgram->setMatrix4("projectionMat", frameProjection(frameSize));
+
+            auto pBudget = std::make_shared<TextureMemoryBudget>(resourceManager, residentBytes + 2 * pTextures->front()->imageSizeInBytes());
+            auto pSpriteBatch = std::make_shared<Renderer::SpriteBatch>(pShaderProgram);
+            const glm::vec2 size(static_cast<float>(frameSize.y) / 2.f);
+            /* The budget is captured, so it is lifted with the scene */
+            return [pTextures, pSpriteBatch, pBudget, frameSize, size](const unsigned int frame) {
+                const size_t first = frame % 2 * 2;
+                for (size_t i = 0; i < 2; ++i) {
+                    const glm::vec2 position(static_cast<float>(frameSize.x) / 2.f - size.x + static_cast<float>(i) * size.x, size.y / 2.f);
+                    pSpriteBatch->add((*pTextures)[first + i].get(), 0, position, size, 0.f, Renderer::Texture2D::INVALID_SUBTEXTURE_ID);
+                }
+                pSpriteBatch->render();
+            };
+        }
+
+        /* Scene names, setup functions and expected texture residency */
+        struct SceneDescription {
+            const char* name;
+            FrameFunction (*create)(ResourceManager& resourceManager, const glm::ivec2& frameSize);
+            TextureResidency textureResidency;
+        };
+
+        const SceneDescription SCENES[] = {
+            { "triangles-and-sprite", createTrianglesAndSprite, {} },
+            { "sprites", createSprites, {} },
+            { "sprite-batch", createSpriteBatch, {} },
+            { "tilemap", createTileMap, {} },
+            { "layers", createLayers, {} },
+            { "text", createText, {} },
+            { "texture-budget", createTextureBudget, { 2, 2 } },
+        };
+    }
+
+    /* Names of the scenes in the order they run */
+    std::vector <std::string> sceneNames() {
+        std::vector <std::string> names;
+        for (const SceneDescription& scene : SCENES) {
+            names.emplace_back(scene.name);
+        }
+        return names;
+    }
+
+    /* Texture images a scene evicts and reloads per frame */
+    TextureResidency expectedTextureResidency(const std::string& sceneName) {
+        for (const SceneDescription& scene : SCENES) {
+            if (sceneName == scene.name) {
+                return scene.textureResidency;
+            }
+        }
+        return TextureResidency{};
+    }
+
+    /* Create the objects of a scene and return its frame function */
+    FrameFunction createScene(const std::string& sceneName, ResourceManager& resourceManager, const glm::ivec2& frameSize) {
+        for (const SceneDescription& scene : SCENES) {
+            if (sceneName == scene.name) {
+                FrameFunction frameFunction = scene.create(resourceManager, frameSize);
+                if (!frameFunction) {
+                    std::cerr << "Can not set up the scene " << sceneName << std::endl;
+                }
+                return frameFunction;
+            }
+        }
+        std::cerr << "Unknown scene: " << sceneName << std::endl;
+        return nullptr;
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <glm/vec2.hpp>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+class ResourceManager;
+
+/*
+Scripted scenes of the headless harness. A scene is set up once and then draws numbered frames into the current
+framebuffer, the content of a frame only depends on its number and the frames before it, so the images are reproducible
+*/
+namespace Harness {
+    /* Draw a frame of a scene, the framebuffer is cleared before */
+    typedef std::function<void(const unsigned int frame)> FrameFunction;
+
+    /* Names of the scenes in the order they run */
+    std::vector <std::string> sceneNames();
+
+    /* Texture images a scene evicts and reloads per frame once it runs steadily, checked by the harness */
+    struct TextureResidency {
+        unsigned int evictions = 0;
+        unsigned int reloads = 0;
+    };
+    TextureResidency expectedTextureResidency(const std::string& sceneName);
+
+    /*
+    Create the objects of a scene with the projection of a frame of the size (one unit per pixel) and return its frame function.
+    Returns an empty function if there is no such scene or its resources are missing. The manifest must be loaded
+    */
+    FrameFunction createScene(const std::string& sceneName, ResourceManager& resourceManager, const glm::ivec2& frameSize);
+}
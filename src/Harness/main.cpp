@@ -0,0 +1,394 @@
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/vec2.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "CallCounter.h"
+#include "Scenes.h"
+#include "../Renderer/Texture2D.h"
+#include "../Resources/ResourceManager.h"
+#include "../Resources/stb_image.h"
+#include "../Renderer/stb_image_write.h"
+#include "../System/FrameArena.h"
+#include "../System/Hash.h"
+
+/*
+Headless regression harness: renders the scripted scenes offscreen (GLFW without a window system, EGL context,
+e.g. Mesa llvmpipe), compares a frame of every scene with its golden image, checks the texture evictions and reloads
+the scene expects and writes a JSON report of frame time percentiles, draw calls, state changes and uniform updates
+per frame and resource memory per scene, so reports of two commits can be diffed.
+
+    OpenGL_Training_Harness [--scene <name>] [--frames <count>] [--report <path>] [--golden <directory>] [--update-golden] [--tolerance <difference>]
+
+Golden images are read from (and with --update-golden written to) res/golden of the source tree unless --golden is given.
+The exit code is 0 when every scene ran, matched its golden image and evicted and reloaded the expected textures
+*/
+
+namespace {
+    /* Every scene renders into a framebuffer of this size, whatever the platform */
+    const glm::ivec2 FRAME_SIZE(640, 480);
+    /* Frames before the timed ones: caches fill up and drivers compile their shader variants */
+    const unsigned int WARM_UP_FRAMES = 10;
+    /* The compared image is the last warm-up frame, so it does not depend on the number of timed frames */
+    const unsigned int GOLDEN_FRAME = WARM_UP_FRAMES - 1;
+
+    struct Options {
+        std::vector <std::string> scenes;
+        unsigned int frames = 100;
+        std::string reportPath = "harness_report.json";
+        std::string goldenDirectory;
+        bool isUpdatingGolden = false;
+        int tolerance = 2;      // Largest difference of a channel that still matches
+    };
+
+    /* Results of a scene for the report */
+    struct SceneResult {
+        std::string name;
+        bool isSetUp = false;
+        std::vector <double> frameMilliseconds;
+        double drawCalls = 0.0;
+        double stateChanges = 0.0;
+        double uniformUpdates = 0.0;
+        uint64_t imageHash = 0;
+        std::string golden;         // "match", "mismatch", "missing" or "updated"
+        size_t differentPixels = 0;
+        double textureEvictions = 0.0;
+        double textureReloads = 0.0;
+        bool isTextureResidencyExpected = true;     // Evictions and reloads per frame are the ones the scene expects
+        ResourceManager::MemoryStatistics memory;   // After the last frame
+    };
+
+    /* Value below which the given fraction of the sorted values lies (nearest rank) */
+    double percentile(const std::vector <double>& sortedValues, const double fraction) {
+        if (sortedValues.empty()) {
+            return 0.0;
+        }
+        const size_t rank = static_cast<size_t>(fraction * static_cast<double>(sortedValues.size()) + 0.999999);
+        return sortedValues[std::min(std::max(rank, static_cast<size_t>(1)), sortedValues.size()) - 1];
+    }
+
+    /* Pixels of the current framebuffer with the rows from the top, like in image files */
+    std::vector <uint8_t> readFrame() {
+        const size_t rowSizeInBytes = static_cast<size_t>(FRAME_SIZE.x) * 4;
+        std::vector <uint8_t> bottomUpPixels(rowSizeInBytes * FRAME_SIZE.y);
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        glReadPixels(0, 0, FRAME_SIZE.x, FRAME_SIZE.y, GL_RGBA, GL_UNSIGNED_BYTE, bottomUpPixels.data());
+        std::vector <uint8_t> pixels(bottomUpPixels.size());
+        for (int row = 0; row < FRAME_SIZE.y; ++row) {
+            std::copy_n(bottomUpPixels.begin() + (FRAME_SIZE.y - 1 - row) * rowSizeInBytes, rowSizeInBytes, pixels.begin() + row * rowSizeInBytes);
+        }
+        return pixels;
+    }
+
+    /* Compare a frame with the golden image of the scene, or replace the golden image */
+    void checkGoldenImage(const Options& options, const std::vector <uint8_t>& pixels, SceneResult& result) {
+        const std::string goldenPath = options.goldenDirectory + "/" + result.name + ".png";
+        if (options.isUpdatingGolden) {
+            if (!stbi_write_png(goldenPath.c_str(), FRAME_SIZE.x, FRAME_SIZE.y, 4, pixels.data(), FRAME_SIZE.x * 4)) {
+                std::cerr << "Can not write the golden image " << goldenPath << std::endl;
+                result.golden = "missing";
+                return;
+            }
+            result.golden = "updated";
+            return;
+        }
+
+        int width = 0;
+        int height = 0;
+        int channels = 0;
+        /* The flag is per thread and the resource manager leaves it set for textures, image files are top-down */
+        stbi_set_flip_vertically_on_load_thread(0);
+        stbi_uc* goldenPixels = stbi_load(goldenPath.c_str(), &width, &height, &channels, 4);
+        if (!goldenPixels) {
+            result.golden = "missing";
+        }
+        else if (width != FRAME_SIZE.x || height != FRAME_SIZE.y) {
+            result.golden = "mismatch";
+            result.differentPixels = pixels.size() / 4;
+        }
+        else {
+            for (size_t i = 0; i < pixels.size(); i += 4) {
+                for (size_t channel = 0; channel < 4; ++channel) {
+                    if (std::abs(static_cast<int>(pixels[i + channel]) - static_cast<int>(goldenPixels[i + channel])) > options.tolerance) {
+                        ++result.differentPixels;
+                        break;
+                    }
+                }
+            }
+            result.golden = result.differentPixels == 0 ? "match" : "mismatch";
+        }
+        stbi_image_free(goldenPixels);
+
+        /* The rendered image is kept next to the report to look at the difference */
+        if (result.golden != "match") {
+            const std::string actualPath = result.name + ".actual.png";
+            stbi_write_png(actualPath.c_str(), FRAME_SIZE.x, FRAME_SIZE.y, 4, pixels.data(), FRAME_SIZE.x * 4);
+        }
+    }
+
+    /* Set up a scene, render its warm-up and timed frames and check its golden image */
+    SceneResult runScene(const std::string& sceneName, const Options& options, ResourceManager& resourceManager) {
+        SceneResult result;
+        result.name = sceneName;
+        const Harness::FrameFunction frameFunction = Harness::createScene(sceneName, resourceManager, FRAME_SIZE);
+        if (!frameFunction) {
+            return result;
+        }
+        result.isSetUp = true;
+
+        /* Frames begin like in the demo: the resource manager evicts texture images over the budget, the frame arenas are reset at the end */
+        auto renderFrame = [&frameFunction, &resourceManager](const unsigned int frame) {
+            resourceManager.beginFrame();
+            glClear(GL_COLOR_BUFFER_BIT);
+            frameFunction(frame);
+            System::FrameArena::resetAll();
+        };
+        for (unsigned int frame = 0; frame < WARM_UP_FRAMES; ++frame) {
+            renderFrame(frame);
+        }
+        glFinish();
+        const std::vector <uint8_t> pixels = readFrame();
+        result.imageHash = System::hashBytes(pixels.data(), pixels.size());
+        checkGoldenImage(options, pixels, result);
+
+        /* Every frame is finished before the next one starts, so a frame time covers the CPU and the GPU work */
+        Harness::CallCounter::take();
+        result.frameMilliseconds.reserve(options.frames);
+        unsigned int textureEvictions = 0;
+        unsigned int textureReloads = 0;
+        for (unsigned int frame = WARM_UP_FRAMES; frame < WARM_UP_FRAMES + options.frames; ++frame) {
+            const auto startTime = std::chrono::steady_clock::now();
+            renderFrame(frame);
+            glFinish();
+            result.frameMilliseconds.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count());
+            const ResourceManager::TextureResidencyStatistics& residency = resourceManager.getTextureResidencyStatistics();
+            textureEvictions += residency.evictions;
+            textureReloads += residency.reloads;
+        }
+        const Harness::CallCounter::Counters counters = Harness::CallCounter::take();
+        const double frames = static_cast<double>(std::max(options.frames, 1u));
+        result.drawCalls = static_cast<double>(counters.drawCalls) / frames;
+        result.stateChanges = static_cast<double>(counters.stateChanges) / frames;
+        result.uniformUpdates = static_cast<double>(counters.uniformUpdates) / frames;
+        result.textureEvictions = static_cast<double>(textureEvictions) / frames;
+        result.textureReloads = static_cast<double>(textureReloads) / frames;
+        const Harness::TextureResidency expectedResidency = Harness::expectedTextureResidency(sceneName);
+        result.isTextureResidencyExpected = textureEvictions == expectedResidency.evictions * options.frames
+            && textureReloads == expectedResidency.reloads * options.frames;
+        result.memory = resourceManager.getMemoryStatistics();
+        std::sort(result.frameMilliseconds.begin(), result.frameMilliseconds.end());
+        return result;
+    }
+
+    /* String as a JSON string literal: quotes, backslashes and control characters are escaped */
+    std::string toJsonString(const std::string& text) {
+        std::string json = "\"";
+        for (const char c : text) {
+            if (c == '"' || c == '\\') {
+                json += '\\';
+                json += c;
+            }
+            else if (static_cast<unsigned char>(c) < 0x20) {
+                char escape[7];
+                std::snprintf(escape, sizeof(escape), "\\u%04x", static_cast<unsigned int>(c));
+                json += escape;
+            }
+            else {
+                json += c;
+            }
+        }
+        return json + '"';
+    }
+
+    /* Write the results as JSON */
+    bool writeReport(const std::string& path, const std::string& renderer, const Options& options, const std::vector <SceneResult>& results) {
+        std::ofstream stream(path);
+        if (!stream.is_open()) {
+            std::cerr << "Can not write the report " << path << std::endl;
+            return false;
+        }
+        char hash[17];
+        stream << "{\n"
+               << "  \"renderer\": " << toJsonString(renderer) << ",\n"
+               << "  \"frameSize\": [" << FRAME_SIZE.x << ", " << FRAME_SIZE.y << "],\n"
+               << "  \"frames\": " << options.frames << ",\n"
+               << "  \"scenes\": [";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const SceneResult& result = results[i];
+            std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(result.imageHash));
+            stream << (i == 0 ? "\n" : ",\n")
+                   << "    {\n"
+                   << "      \"name\": " << toJsonString(result.name) << ",\n"
+                   << "      \"setUp\": " << (result.isSetUp ? "true" : "false") << ",\n"
+                   << "      \"frameTimeMs\": { \"p50\": " << percentile(result.frameMilliseconds, 0.5)
+                   << ", \"p90\": " << percentile(result.frameMilliseconds, 0.9)
+                   << ", \"p99\": " << percentile(result.frameMilliseconds, 0.99)
+                   << ", \"max\": " << percentile(result.frameMilliseconds, 1.0) << " },\n"
+                   << "      \"drawCallsPerFrame\": " << result.drawCalls << ",\n"
+                   << "      \"stateChangesPerFrame\": " << result.stateChanges << ",\n"
+                   << "      \"uniformUpdatesPerFrame\": " << result.uniformUpdates << ",\n"
+                   << "      \"textureEvictionsPerFrame\": " << result.textureEvictions << ",\n"
+                   << "      \"textureReloadsPerFrame\": " << result.textureReloads << ",\n"
+                   << "      \"textureResidency\": \"" << (result.isTextureResidencyExpected ? "expected" : "unexpected") << "\",\n"
+                   << "      \"imageHash\": \"" << hash << "\",\n"
+                   << "      \"golden\": \"" << result.golden << "\",\n"
+                   << "      \"differentPixels\": " << result.differentPixels << ",\n"
+                   << "      \"memory\": { \"cpuBytes\": " << result.memory.cpuBytes()
+                   << ", \"gpuBytes\": " << result.memory.gpuBytes()
+                   << ", \"textureGpuBytes\": " << result.memory.textureGpuBytes
+                   << ", \"fontGpuBytes\": " << result.memory.fontGpuBytes
+                   << ", \"textures\": " << result.memory.textureCount
+                   << ", \"sprites\": " << result.memory.spriteCount << " }\n"
+                   << "    }";
+        }
+        stream << "\n  ]\n}\n";
+        return true;
+    }
+
+    /* Parse the command line. Returns false on an unknown or incomplete option */
+    bool parseOptions(const int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string option = argv[i];
+            const bool hasValue = i + 1 < argc;
+            if (option == "--update-golden") {
+                options.isUpdatingGolden = true;
+            }
+            else if (option == "--scene" && hasValue) {
+                options.scenes.emplace_back(argv[++i]);
+            }
+            else if (option == "--frames" && hasValue) {
+                options.frames = static_cast<unsigned int>(std::max(std::atoi(argv[++i]), 1));
+            }
+            else if (option == "--report" && hasValue) {
+                options.reportPath = argv[++i];
+            }
+            else if (option == "--golden" && hasValue) {
+                options.goldenDirectory = argv[++i];
+            }
+            else if (option == "--tolerance" && hasValue) {
+                options.tolerance = std::max(std::atoi(argv[++i]), 0);
+            }
+            else {
+                std::cerr << "Unknown option or missing value: " << option << std::endl;
+                return false;
+            }
+        }
+        /* Golden images are updated in the source tree, the copy next to the executable is overwritten by every build */
+        if (options.goldenDirectory.empty()) {
+#ifdef HARNESS_GOLDEN_DIRECTORY
+            options.goldenDirectory = HARNESS_GOLDEN_DIRECTORY;
+#else
+            const std::string executablePath = argv[0];
+            const size_t foundLastSlash = executablePath.find_last_of("/\\");
+            options.goldenDirectory = (foundLastSlash == std::string::npos ? std::string(".") : executablePath.substr(0, foundLastSlash)) + "/res/golden";
+#endif
+        }
+        if (options.scenes.empty()) {
+            options.scenes = Harness::sceneNames();
+        }
+        return true;
+    }
+
+    /*
+    Load the resources and run the scenes into an offscreen framebuffer, the context must be current.
+    Returns the exit code: 0 if every scene matched its golden image, 1 otherwise and -1 if the harness can not run.
+    Every GL object is deleted on return, before the context is
+    */
+    int runScenes(const Options& options, const std::string& executablePath, const std::string& renderer) {
+        ResourceManager resourceManager(executablePath);
+        if (!resourceManager.loadManifest("res/manifest.txt")) {
+            std::cerr << "Can not load resources from the manifest: " << "res/manifest.txt" << std::endl;
+            return -1;
+        }
+
+        /* Scenes render into a framebuffer of the frame size, so the window (if any) does not matter */
+        Renderer::Texture2D target(FRAME_SIZE.x, FRAME_SIZE.y, nullptr, 4, GL_NEAREST);
+        GLuint framebuffer = 0;
+        glGenFramebuffers(1, &framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target.id(), 0);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            std::cerr << "The framebuffer of the scenes is incomplete" << std::endl;
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glDeleteFramebuffers(1, &framebuffer);
+            return -1;
+        }
+        glViewport(0, 0, FRAME_SIZE.x, FRAME_SIZE.y);
+        glClearColor(0, 1, 0, 1);
+
+        bool isSuccessful = true;
+        std::vector <SceneResult> results;
+        for (const std::string& sceneName : options.scenes) {
+            results.push_back(runScene(sceneName, options, resourceManager));
+            const SceneResult& result = results.back();
+            isSuccessful = isSuccessful && result.isSetUp && (result.golden == "match" || result.golden == "updated") && result.isTextureResidencyExpected;
+            std::cout << result.name << ": " << (result.isSetUp ? result.golden : "not set up");
+            if (result.isSetUp) {
+                std::cout << " (" << result.differentPixels << " different pixels), p50 " << percentile(result.frameMilliseconds, 0.5)
+                          << " ms, p99 " << percentile(result.frameMilliseconds, 0.99) << " ms, " << result.drawCalls << " draw calls and "
+                          << result.stateChanges << " state changes per frame";
+                if (!result.isTextureResidencyExpected) {
+                    std::cout << ", unexpected " << result.textureEvictions << " texture evictions and " << result.textureReloads << " reloads per frame";
+                }
+            }
+            std::cout << std::endl;
+        }
+        isSuccessful = writeReport(options.reportPath, renderer, options, results) && isSuccessful;
+
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers(1, &framebuffer);
+        return isSuccessful ? 0 : 1;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        return -1;
+    }
+
+    /* No window system is needed: the null platform of GLFW creates the context with EGL */
+    if (glfwPlatformSupported(GLFW_PLATFORM_NULL)) {
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+    }
+    if (!glfwInit()) {
+        std::cout << "glfwInit failed" << std::endl;
+        return -1;
+    }
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    if (glfwGetPlatform() == GLFW_PLATFORM_NULL) {
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+    }
+    GLFWwindow* pWindow = glfwCreateWindow(FRAME_SIZE.x, FRAME_SIZE.y, "OpenGL_Training_Harness", nullptr, nullptr);
+    if (!pWindow) {
+        std::cout << "glfwCreateWindow failed" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+    glfwMakeContextCurrent(pWindow);
+    if (!gladLoadGL()) {
+        std::cout << "Can not load GLAD" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+    const std::string renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+    std::cout << "Renderer: " << renderer << std::endl;
+    Harness::CallCounter::install();
+
+    const int exitCode = runScenes(options, argv[0], renderer);
+
+    glfwTerminate();
+    return exitCode;
+}
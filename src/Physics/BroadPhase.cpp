@@ -0,0 +1,145 @@
+#include "BroadPhase.h"
+#include "../Scene/TileMap.h"
+
+#include <glm/trigonometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace Physics {
+    namespace {
+        /* Appending more bodies than this fraction of the axis at once makes a full sort cheaper than insertion */
+        const size_t FULL_SORT_DIVISOR = 8;
+    }
+
+    /* Bounds of a sprite */
+    Aabb spriteBounds(const glm::vec2& position, const glm::vec2& size, const float rotation) {
+        if (rotation == 0.f) {
+            return Aabb{ position, position + size };
+        }
+        /* Half extents of the rotated rectangle around its center */
+        const float radians = glm::radians(rotation);
+        const float c = std::abs(std::cos(radians));
+        const float s = std::abs(std::sin(radians));
+        const glm::vec2 halfSize = 0.5f * size;
+        const glm::vec2 halfExtents(halfSize.x * c + halfSize.y * s, halfSize.x * s + halfSize.y * c);
+        const glm::vec2 center = position + halfSize;
+        return Aabb{ center - halfExtents, center + halfExtents };
+    }
+
+    /* Add a body */
+    BodyHandle BroadPhase::addBody(const Aabb& bounds, const uint64_t userData) {
+        const BodyHandle body = m_bodies.insert(Body{ bounds, userData });
+        m_axis.push_back(AxisEntry{ bounds, body });
+        ++m_addedBodiesCount;
+        return body;
+    }
+
+    /* Remove a body. Its axis entry is dropped at the next findPairs() */
+    bool BroadPhase::removeBody(const BodyHandle body) {
+        if (!m_bodies.erase(body)) {
+            return false;
+        }
+        ++m_removedBodiesCount;
+        return true;
+    }
+
+    /* Update the bounds of a moved body */
+    bool BroadPhase::setBounds(const BodyHandle body, const Aabb& bounds) {
+        Body* pBody = m_bodies.get(body);
+        if (!pBody) {
+            return false;
+        }
+        pBody->bounds = bounds;
+        return true;
+    }
+
+    const Aabb* BroadPhase::getBounds(const BodyHandle body) const {
+        const Body* pBody = m_bodies.get(body);
+        return pBody ? &pBody->bounds : nullptr;
+    }
+
+    uint64_t BroadPhase::getUserData(const BodyHandle body) const {
+        const Body* pBody = m_bodies.get(body);
+        return pBody ? pBody->userData : 0;
+    }
+
+    /* Refresh the bounds of the axis entries, drop removed bodies and sort the axis */
+    void BroadPhase::updateAxis() {
+        /* Dropping entries keeps the order of the rest, so the axis stays nearly sorted */
+        if (m_removedBodiesCount != 0) {
+            m_axis.erase(std::remove_if(m_axis.begin(), m_axis.end(), [this](const AxisEntry& entry) {
+                return !m_bodies.contains(entry.body);
+            }), m_axis.end());
+            m_removedBodiesCount = 0;
+        }
+        for (AxisEntry& entry : m_axis) {
+            entry.bounds = m_bodies.get(entry.body)->bounds;
+        }
+
+        m_sortSwapsCount = 0;
+        if (m_addedBodiesCount * FULL_SORT_DIVISOR > m_axis.size()) {
+            std::sort(m_axis.begin(), m_axis.end(), [](const AxisEntry& a, const AxisEntry& b) {
+                return a.bounds.min.x < b.bounds.min.x;
+            });
+        }
+        else {
+            /* Bodies moved a little since the last frame: each entry only travels past a few neighbours */
+            for (size_t i = 1; i < m_axis.size(); ++i) {
+                if (!(m_axis[i].bounds.min.x < m_axis[i - 1].bounds.min.x)) {
+                    continue;
+                }
+                const AxisEntry entry = m_axis[i];
+                size_t j = i;
+                do {
+                    m_axis[j] = m_axis[j - 1];
+                    --j;
+                } while (j > 0 && entry.bounds.min.x < m_axis[j - 1].bounds.min.x);
+                m_axis[j] = entry;
+                m_sortSwapsCount += i - j;
+            }
+        }
+        m_addedBodiesCount = 0;
+    }
+
+    /* Restore the order of the sweep axis and append every pair of bodies with overlapping bounds */
+    void BroadPhase::findPairs(System::FrameVector <BodyPair>& pairs) {
+        updateAxis();
+        size_t testedPairsCount = 0;
+        const size_t count = m_axis.size();
+        for (size_t i = 0; i < count; ++i) {
+            const Aabb& bounds = m_axis[i].bounds;
+            /* Bodies further on the axis start to the right, the sweep ends at the first one that starts past this body */
+            size_t j = i + 1;
+            for (; j < count && m_axis[j].bounds.min.x <= bounds.max.x; ++j) {
+                const Aabb& other = m_axis[j].bounds;
+                if (other.min.y <= bounds.max.y && bounds.min.y <= other.max.y) {
+                    pairs.push_back(BodyPair{ m_axis[i].body, m_axis[j].body });
+                }
+            }
+            testedPairsCount += j - i - 1;
+        }
+        m_testedPairsCount = testedPairsCount;
+    }
+
+    /* Append a contact for every solid tile of the map that overlaps the bounds of a body */
+    void BroadPhase::findTileContacts(const Scene::TileMap& tileMap, System::FrameVector <TileContact>& contacts) const {
+        const Scene::TileMap::TileType* tiles = tileMap.data();
+        const int columns = tileMap.columns();
+        m_bodies.forEach([&](const BodyHandle body, const Body& bodyData) {
+            glm::ivec2 first, last;
+            if (!tileMap.getCellRange(bodyData.bounds.min, bodyData.bounds.max, first, last)) {
+                return;
+            }
+            for (int row = first.y; row <= last.y; ++row) {
+                const Scene::TileMap::TileType* rowTiles = tiles + static_cast<size_t>(row) * columns;
+                for (int column = first.x; column <= last.x; ++column) {
+                    /* Chipped tiles only count where their remaining sub-cells are */
+                    if (rowTiles[column] != Scene::TileMap::EMPTY_TILE && tileMap.overlapsSolid(column, row, bodyData.bounds.min, bodyData.bounds.max)) {
+                        contacts.push_back(TileContact{ body, column, row });
+                    }
+                }
+            }
+        });
+    }
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "../System/FrameArena.h"
+#include "../System/HandlePool.h"
+
+#include <glm/vec2.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Scene {
+    class TileMap;
+}
+
+namespace Physics {
+    struct BodyTag {};
+    typedef System::Handle<BodyTag> BodyHandle;
+
+    /* Axis-aligned bounding box */
+    struct Aabb {
+        glm::vec2 min = glm::vec2(0.f);
+        glm::vec2 max = glm::vec2(0.f);
+    };
+
+    /*
+    Bounds of a sprite placed with the Renderer::Sprite conventions: position of the lower left corner,
+    rotation in degrees around the center
+    */
+    Aabb spriteBounds(const glm::vec2& position, const glm::vec2& size, const float rotation = 0.f);
+
+    /* Bodies whose bounds overlap */
+    struct BodyPair {
+        BodyHandle a;
+        BodyHandle b;
+    };
+
+    /* Body whose bounds overlap solid sub-cells of a tile */
+    struct TileContact {
+        BodyHandle body;
+        int column;
+        int row;
+    };
+
+    /*
+    Broad phase of collision detection for moving bodies: sort and sweep along the x axis. Bodies are kept sorted
+    by the left edge of their bounds, and since bodies move little between frames the order is restored
+    with an insertion sort in nearly linear time. The sweep then only compares bodies whose x ranges overlap.
+    Static tiles are not bodies: they are looked up in the tile map cells under every body, down to their sub-cells
+    */
+    class BroadPhase {
+    public:
+        /* Add a body. User data is any value that identifies the body for the caller, e.g. an entity */
+        BodyHandle addBody(const Aabb& bounds, const uint64_t userData = 0);
+        /* Remove a body. Its handle becomes stale */
+        bool removeBody(const BodyHandle body);
+        /* Update the bounds of a moved body */
+        bool setBounds(const BodyHandle body, const Aabb& bounds);
+        const Aabb* getBounds(const BodyHandle body) const;
+        /* User data of a body (0 for stale handles) */
+        uint64_t getUserData(const BodyHandle body) const;
+        size_t bodiesCount() const { return m_bodies.size(); }
+
+        /*
+        Restore the order of the sweep axis and append every pair of bodies with overlapping bounds.
+        The pairs vector is usually a System::FrameVector, so the pairs live in the frame arena
+        */
+        void findPairs(System::FrameVector <BodyPair>& pairs);
+        /* Append a contact for every tile of the map whose solid sub-cells overlap the bounds of a body */
+        void findTileContacts(const Scene::TileMap& tileMap, System::FrameVector <TileContact>& contacts) const;
+
+        /* Statistics of the last findPairs() */
+        size_t sortSwapsCount() const { return m_sortSwapsCount; }
+        size_t testedPairsCount() const { return m_testedPairsCount; }
+
+    private:
+        struct Body {
+            Aabb bounds;
+            uint64_t userData = 0;
+        };
+        /* Entry of the sweep axis. The bounds are copied in, so the sweep reads one contiguous array */
+        struct AxisEntry {
+            Aabb bounds;
+            BodyHandle body;
+        };
+
+        /* Refresh the bounds of the axis entries, drop removed bodies and sort the axis */
+        void updateAxis();
+
+        System::HandlePool <Body, BodyTag> m_bodies;
+        std::vector <AxisEntry> m_axis;
+        size_t m_addedBodiesCount = 0;      // Bodies appended to the axis since the last sort
+        size_t m_removedBodiesCount = 0;    // Removed bodies still on the axis
+        size_t m_sortSwapsCount = 0;
+        size_t m_testedPairsCount = 0;
+    };
+}
@@ -0,0 +1,137 @@
+#include "CollisionMask.h"
+
+#include <algorithm>
+
+/* SSE2 is part of x86-64, other targets use the scalar loops */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define COLLISION_MASKS_USE_SSE2
+#endif
+
+namespace Physics {
+    namespace {
+        /* Word of a mask row, zero outside of the row */
+        uint64_t getWord(const CollisionMask& mask, const int row, const int word) {
+            return word >= 0 && word < mask.wordsPerRow ? mask.rows[static_cast<size_t>(row) * mask.wordsPerRow + word] : 0;
+        }
+    }
+
+    /* Check whether opaque pixels of two masks overlap */
+    bool overlaps(const CollisionMask& a, const CollisionMask& b, const int offsetX, const int offsetY) {
+        if (a.isEmpty() || b.isEmpty()) {
+            return false;
+        }
+        /* Only the intersection of the opaque bounds is tested, in the coordinates of a */
+        const int left = std::max(a.left, b.left + offsetX);
+        const int right = std::min(a.right, b.right + offsetX);
+        const int bottom = std::max(a.bottom, b.bottom + offsetY);
+        const int top = std::min(a.top, b.top + offsetY);
+        if (left >= right || bottom >= top) {
+            return false;
+        }
+
+        /*
+        Narrow masks: one word per row. Instead of shifting b right for negative offsets, a is shifted left,
+        which tests the same pixels and keeps the loop free of a branch on the sign of the offset
+        */
+        if (a.wordsPerRow == 1 && b.wordsPerRow == 1) {
+            const int shiftA = std::max(-offsetX, 0);
+            const int shiftB = std::max(offsetX, 0);
+            int y = bottom;
+#ifdef COLLISION_MASKS_USE_SSE2
+            /* Rows are consecutive words, so one 128-bit load takes two rows */
+            const __m128i shiftA2 = _mm_cvtsi32_si128(shiftA);
+            const __m128i shiftB2 = _mm_cvtsi32_si128(shiftB);
+            const __m128i zero = _mm_setzero_si128();
+            for (; y + 2 <= top; y += 2) {
+                const __m128i rowsA = _mm_sll_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a.rows + y)), shiftA2);
+                const __m128i rowsB = _mm_sll_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b.rows + (y - offsetY))), shiftB2);
+                if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(rowsA, rowsB), zero)) != 0xFFFF) {
+                    return true;
+                }
+            }
+#endif
+            for (; y < top; ++y) {
+                if ((a.rows[y] << shiftA) & (b.rows[y - offsetY] << shiftB)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /* Wide masks: every word of a is tested against the 64 pixels of b that land on it, taken from two words of b */
+        const int firstWord = left >> 6;
+        const int lastWord = (right - 1) >> 6;
+        for (int y = bottom; y < top; ++y) {
+            const uint64_t* rowA = a.rows + static_cast<size_t>(y) * a.wordsPerRow;
+            const int rowB = y - offsetY;
+            for (int word = firstWord; word <= lastWord; ++word) {
+                const int firstBitB = word * 64 - offsetX;
+                const int wordB = firstBitB >> 6;   // Arithmetic shift rounds down for negative positions
+                const int bit = firstBitB & 63;
+                uint64_t pixelsB = getWord(b, rowB, wordB) >> bit;
+                if (bit != 0) {
+                    pixelsB |= getWord(b, rowB, wordB + 1) << (64 - bit);
+                }
+                if (rowA[word] & pixelsB) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    /* Build the masks of the tiles of an atlas image */
+    CollisionMaskSet::CollisionMaskSet(const unsigned char* pixels,
+                                       const int imageWidth,
+                                       const int imageHeight,
+                                       const int channels,
+                                       const unsigned int tileWidth,
+                                       const unsigned int tileHeight,
+                                       const unsigned char alphaThreshold) {
+        const int width = static_cast<int>(tileWidth);
+        const int height = static_cast<int>(tileHeight);
+        if (width == 0 || height == 0 || width > imageWidth || height > imageHeight) {
+            return;
+        }
+        const int columns = imageWidth / width;
+        const int rows = imageHeight / height;
+        const int wordsPerRow = (width + 63) / 64;
+        const size_t wordsPerMask = static_cast<size_t>(wordsPerRow) * height;
+        /* Alpha is the last channel of grey-alpha and RGBA images */
+        const bool hasAlpha = channels == 2 || channels == 4;
+
+        m_words.assign(wordsPerMask * columns * rows, 0);
+        m_masks.resize(static_cast<size_t>(columns) * rows);
+        for (int tile = 0; tile < columns * rows; ++tile) {
+            CollisionMask& mask = m_masks[tile];
+            uint64_t* words = m_words.data() + wordsPerMask * tile;
+            mask.rows = words;
+            mask.width = width;
+            mask.height = height;
+            mask.wordsPerRow = wordsPerRow;
+            mask.left = width;
+            mask.bottom = height;
+
+            /* Tiles are numbered from the top, image rows from the bottom */
+            const int imageX = tile % columns * width;
+            const int imageY = imageHeight - (tile / columns + 1) * height;
+            for (int y = 0; y < height; ++y) {
+                const unsigned char* pPixel = pixels + (static_cast<size_t>(imageY + y) * imageWidth + imageX) * channels;
+                for (int x = 0; x < width; ++x, pPixel += channels) {
+                    if (hasAlpha && pPixel[channels - 1] < alphaThreshold) {
+                        continue;
+                    }
+                    words[static_cast<size_t>(y) * wordsPerRow + (x >> 6)] |= uint64_t(1) << (x & 63);
+                    mask.left = std::min(mask.left, x);
+                    mask.right = std::max(mask.right, x + 1);
+                    mask.bottom = std::min(mask.bottom, y);
+                    mask.top = std::max(mask.top, y + 1);
+                }
+            }
+            if (mask.isEmpty()) {
+                mask.left = mask.right = mask.bottom = mask.top = 0;
+            }
+        }
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Physics {
+    /*
+    Opacity of a sprite image, 1 bit per pixel. Rows go from the bottom, like the decoded images and world
+    coordinates, and pixel x of a row is bit x % 64 of word x / 64. Masks are views into a CollisionMaskSet
+    */
+    struct CollisionMask {
+        const uint64_t* rows = nullptr;
+        int width = 0;
+        int height = 0;
+        int wordsPerRow = 0;
+        /* Bounds of the opaque pixels (right and top exclusive), empty for fully transparent masks */
+        int left = 0;
+        int bottom = 0;
+        int right = 0;
+        int top = 0;
+
+        bool isEmpty() const { return left >= right; }
+        bool isOpaque(const int x, const int y) const {
+            return (rows[static_cast<size_t>(y) * wordsPerRow + (x >> 6)] >> (x & 63)) & 1;
+        }
+    };
+
+    /*
+    Check whether opaque pixels of two masks overlap when the bottom left corner of b is at (offsetX, offsetY)
+    relative to the bottom left corner of a. Rows are tested 64 pixels at a time, masks up to 64 pixels wide
+    are tested two rows at a time with SSE2
+    */
+    bool overlaps(const CollisionMask& a, const CollisionMask& b, const int offsetX, const int offsetY);
+
+    /* Collision masks of all tiles of a grid atlas, in one allocation */
+    class CollisionMaskSet {
+    public:
+        /*
+        Build the masks of the tiles of an atlas image (rows from the bottom). Tiles are numbered left to right,
+        top to bottom like Texture2D grid tiles. Pixels with alpha of at least alphaThreshold are opaque,
+        images without an alpha channel are opaque everywhere
+        */
+        CollisionMaskSet(const unsigned char* pixels,
+                         const int imageWidth,
+                         const int imageHeight,
+                         const int channels,
+                         const unsigned int tileWidth,
+                         const unsigned int tileHeight,
+                         const unsigned char alphaThreshold = 128);
+
+        /* Masks point into the set, so it is neither copied nor moved */
+        CollisionMaskSet(const CollisionMaskSet&) = delete;
+        CollisionMaskSet& operator = (const CollisionMaskSet&) = delete;
+
+        /* Get the mask of a tile (a subtexture ID of the grid atlas) */
+        const CollisionMask& getMask(const uint32_t tileIndex) const { return m_masks[tileIndex]; }
+        size_t masksCount() const { return m_masks.size(); }
+        /* System memory used by the masks */
+        size_t sizeInBytes() const { return m_words.size() * sizeof(uint64_t) + m_masks.size() * sizeof(CollisionMask); }
+
+    private:
+        std::vector <uint64_t> m_words;
+        std::vector <CollisionMask> m_masks;
+    };
+}
@@ -0,0 +1,35 @@
+#include "AnimatedSprite.h"
+
+namespace Renderer {
+    /* Create an animated sprite */
+    AnimatedSprite::AnimatedSprite(const std::shared_ptr <Texture2D> pTexture,
+                                   const std::string initialSubTextureName,
+                                   const std::shared_ptr <ShaderProgram> pShaderProgram,
+                                   const glm::vec2& position,
+                                   const glm::vec2& size,
+                                   const float rotation)
+                                   : Sprite(std::move(pTexture), std::move(initialSubTextureName), std::move(pShaderProgram), position, size, rotation) {
+    }
+
+    /* Play a clip from the start */
+    void AnimatedSprite::play(const AnimationClip* pClip, const float speed) {
+        m_pClip = pClip;
+        m_time = 0.f;
+        m_speed = speed;
+        if (m_pClip) {
+            setSubTexture(m_pClip->frameAt(0.f));
+        }
+    }
+
+    /* Advance the playback and switch the frame if it changed */
+    void AnimatedSprite::update(const float deltaTime) {
+        if (!m_pClip) {
+            return;
+        }
+        m_time = m_pClip->wrapTime(m_time + deltaTime * m_speed);
+        const Texture2D::SubTextureId frame = m_pClip->frameAt(m_time);
+        if (frame != subTextureId()) {
+            setSubTexture(frame);
+        }
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Sprite.h"
+#include "Animation.h"
+
+namespace Renderer {
+    /* Sprite that plays animation clips. Frame changes only rewrite the texture coordinates of the sprite */
+    class AnimatedSprite : public Sprite {
+    public:
+        /* Create an animated sprite */
+        AnimatedSprite(const std::shared_ptr <Texture2D> pTexture,
+                       const std::string initialSubTextureName,
+                       const std::shared_ptr <ShaderProgram> pShaderProgram,
+                       const glm::vec2& position = glm::vec2(0.f),
+                       const glm::vec2& size = glm::vec2(1.f),
+                       const float rotation = 0.f);
+
+        /* Play a clip from the start. The clip must outlive the sprite (clips of an AnimationLibrary do) */
+        void play(const AnimationClip* pClip, const float speed = 1.f);
+        /* Set the playback speed (negative values play backwards) */
+        void setSpeed(const float speed) { m_speed = speed; }
+
+        /* Advance the playback and switch the frame if it changed */
+        void update(const float deltaTime);
+
+        bool isFinished() const { return m_pClip && m_pClip->isFinished(m_time); }
+
+    private:
+        const AnimationClip* m_pClip = nullptr;
+        float m_time = 0.f;
+        float m_speed = 1.f;
+    };
+}
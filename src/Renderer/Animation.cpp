@@ -0,0 +1,63 @@
+#include "Animation.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace Renderer {
+    /* Create a clip from frames and their durations */
+    AnimationClip::AnimationClip(const std::vector <Texture2D::SubTextureId>& frames, const std::vector <float>& frameDurations, const PlaybackMode mode)
+        : m_mode(mode)
+        , m_frames(frames) {
+        std::vector <float> durations(frameDurations);
+        durations.resize(m_frames.size(), durations.empty() ? 0.1f : durations.back());
+        /* Ping-pong plays the inner frames backwards after the forward pass, so the ends are not shown twice */
+        if (mode == PlaybackMode::PingPong && m_frames.size() > 2) {
+            for (size_t i = m_frames.size() - 2; i > 0; --i) {
+                m_frames.push_back(m_frames[i]);
+                durations.push_back(durations[i]);
+            }
+        }
+        if (m_frames.empty()) {
+            m_frames.push_back(Texture2D::INVALID_SUBTEXTURE_ID);
+            durations.push_back(1.f);
+        }
+
+        float endTime = 0.f;
+        bool isUniform = true;
+        for (const float duration : durations) {
+            endTime += duration;
+            m_frameEndTimes.push_back(endTime);
+            isUniform = isUniform && duration == durations.front();
+        }
+        m_duration = endTime;
+        m_inverseDuration = m_duration > 0.f ? 1.f / m_duration : 0.f;
+        m_inverseFrameDuration = isUniform && durations.front() > 0.f ? 1.f / durations.front() : 0.f;
+    }
+
+    /* Binary search over the end times of frames */
+    size_t AnimationClip::findFrame(const float wrappedTime) const {
+        return static_cast<size_t>(std::upper_bound(m_frameEndTimes.begin(), m_frameEndTimes.end(), wrappedTime) - m_frameEndTimes.begin());
+    }
+
+    /* Add a clip */
+    AnimationClipId AnimationLibrary::addClip(const std::string& clipName, AnimationClip clip) {
+        if (m_clipIds.count(clipName) != 0) {
+            std::cerr << "Animation clip already exists: " << clipName << std::endl;
+            return INVALID_ANIMATION_CLIP_ID;
+        }
+        const AnimationClipId clipId = static_cast<AnimationClipId>(m_clips.size());
+        m_clips.push_back(std::move(clip));
+        m_clipIds.emplace(clipName, clipId);
+        return clipId;
+    }
+
+    /* Get clip ID by its name */
+    AnimationClipId AnimationLibrary::getClipId(const std::string& clipName) const {
+        auto it = m_clipIds.find(clipName);
+        if (it == m_clipIds.end()) {
+            std::cerr << "Can not find the animation clip: " << clipName << std::endl;
+            return INVALID_ANIMATION_CLIP_ID;
+        }
+        return it->second;
+    }
+}
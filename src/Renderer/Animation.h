@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Texture2D.h"
+
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Renderer {
+    /* Sequence of atlas frames with their durations */
+    class AnimationClip {
+    public:
+        enum class PlaybackMode {
+            Loop,       // 0 1 2 0 1 2 ...
+            PingPong,   // 0 1 2 1 0 1 ...
+            Once        // 0 1 2 2 2 ...
+        };
+
+        /* Create a clip from frames (subtexture IDs) and their durations in seconds */
+        AnimationClip(const std::vector <Texture2D::SubTextureId>& frames, const std::vector <float>& frameDurations, const PlaybackMode mode);
+
+        /* Bring the time since the start of playback into the clip range, so that it does not grow without bound */
+        float wrapTime(const float time) const {
+            if (m_mode == PlaybackMode::Once) {
+                return time < 0.f ? 0.f : (time > m_duration ? m_duration : time);
+            }
+            return time - std::floor(time * m_inverseDuration) * m_duration;
+        }
+        /* Subtexture to show at a wrapped time */
+        Texture2D::SubTextureId frameAt(const float wrappedTime) const {
+            return m_frames[frameIndexAt(wrappedTime)];
+        }
+        /* Index of the frame at a wrapped time. Frames of equal duration are found in O(1) */
+        size_t frameIndexAt(const float wrappedTime) const {
+            size_t frameIndex = m_inverseFrameDuration != 0.f ? static_cast<size_t>(wrappedTime * m_inverseFrameDuration) : findFrame(wrappedTime);
+            return frameIndex < m_frames.size() ? frameIndex : m_frames.size() - 1;
+        }
+
+        PlaybackMode mode() const { return m_mode; }
+        /* Duration of one cycle (a ping-pong cycle goes forward and back) */
+        float duration() const { return m_duration; }
+        /* Number of frames in one cycle */
+        size_t framesCount() const { return m_frames.size(); }
+        bool isFinished(const float wrappedTime) const { return m_mode == PlaybackMode::Once && wrappedTime >= m_duration; }
+
+    private:
+        /* Binary search over the end times of frames */
+        size_t findFrame(const float wrappedTime) const;
+
+        PlaybackMode m_mode;
+        std::vector <Texture2D::SubTextureId> m_frames;     // Ping-pong clips are stored unrolled
+        std::vector <float> m_frameEndTimes;
+        float m_duration = 0.f;
+        float m_inverseDuration = 0.f;
+        float m_inverseFrameDuration = 0.f;     // Non-zero if all frames have the same duration
+    };
+
+    typedef uint32_t AnimationClipId;
+    constexpr AnimationClipId INVALID_ANIMATION_CLIP_ID = std::numeric_limits<AnimationClipId>::max();
+
+    /* Named animation clips addressed by dense IDs. Clips never move, so references to them stay valid */
+    class AnimationLibrary {
+    public:
+        /* Add a clip and return its ID. Returns INVALID_ANIMATION_CLIP_ID if the name is taken */
+        AnimationClipId addClip(const std::string& clipName, AnimationClip clip);
+        /* Get clip ID by its name. Returns INVALID_ANIMATION_CLIP_ID if there is no such clip */
+        AnimationClipId getClipId(const std::string& clipName) const;
+        bool hasClip(const std::string& clipName) const { return m_clipIds.count(clipName) != 0; }
+        /* Get clip by its ID (the ID must be valid) */
+        const AnimationClip& getClip(const AnimationClipId clipId) const { return m_clips[clipId]; }
+        size_t clipsCount() const { return m_clips.size(); }
+
+    private:
+        std::deque <AnimationClip> m_clips;
+        std::unordered_map <std::string, AnimationClipId> m_clipIds;
+    };
+}
@@ -0,0 +1,241 @@
+#include "DynamicAtlas.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+
+namespace Renderer {
+    namespace {
+        /* Empty pixels between regions, so that linear filtering does not pick up the neighbours */
+        const int REGION_PADDING = 1;
+    }
+
+    /* Create an empty atlas */
+    DynamicAtlas::DynamicAtlas(const unsigned int pageSize, const unsigned int maxPages, const GLenum filter)
+        : m_pageSize(pageSize)
+        , m_maxPages(maxPages)
+        , m_filter(filter) {
+        m_pages.reserve(maxPages);
+    }
+
+    /* Place an image into the atlas */
+    AtlasRegionHandle DynamicAtlas::allocate(const unsigned int width, const unsigned int height, const unsigned char* pixels) {
+        const int paddedWidth = static_cast<int>(width) + REGION_PADDING;
+        const int paddedHeight = static_cast<int>(height) + REGION_PADDING;
+        if (width == 0 || height == 0 || paddedWidth + REGION_PADDING > static_cast<int>(m_pageSize) || paddedHeight + REGION_PADDING > static_cast<int>(m_pageSize)) {
+            std::cerr << "Region " << width << "x" << height << " does not fit into an atlas page" << std::endl;
+            return AtlasRegionHandle();
+        }
+
+        /*
+        The most recently used page with room, and the lowest position on it. Filling recent pages first
+        leaves old pages untouched, so they age and can be evicted
+        */
+        uint32_t bestPage = UINT32_MAX;
+        size_t bestNode = 0;
+        int bestX = 0;
+        int bestY = INT32_MAX;
+        for (uint32_t page = 0; page < m_pages.size(); ++page) {
+            size_t nodeIndex;
+            int x, y;
+            if (bestPage != UINT32_MAX && m_pages[page].lastUsedFrame < m_pages[bestPage].lastUsedFrame) {
+                continue;
+            }
+            if (findPosition(m_pages[page], paddedWidth, paddedHeight, nodeIndex, x, y)
+                && (bestPage == UINT32_MAX || m_pages[page].lastUsedFrame > m_pages[bestPage].lastUsedFrame || y < bestY)) {
+                bestPage = page;
+                bestNode = nodeIndex;
+                bestX = x;
+                bestY = y;
+            }
+        }
+
+        /* No room: start a new page while the limit allows, otherwise reuse the least recently used page */
+        if (bestPage == UINT32_MAX) {
+            if (m_pages.size() < m_maxPages) {
+                addPage();
+                bestPage = static_cast<uint32_t>(m_pages.size() - 1);
+            }
+            else {
+                const uint64_t currentFrame = Texture2D::currentFrame();
+                for (uint32_t page = 0; page < m_pages.size(); ++page) {
+                    if (m_pages[page].lastUsedFrame < currentFrame
+                        && (bestPage == UINT32_MAX || m_pages[page].lastUsedFrame < m_pages[bestPage].lastUsedFrame)) {
+                        bestPage = page;
+                    }
+                }
+                if (bestPage == UINT32_MAX) {
+                    std::cerr << "All atlas pages are used in the current frame, can't place region " << width << "x" << height << std::endl;
+                    return AtlasRegionHandle();
+                }
+                clearPage(bestPage);
+                ++m_evictionsCount;
+            }
+            findPosition(m_pages[bestPage], paddedWidth, paddedHeight, bestNode, bestX, bestY);
+        }
+
+        Page& page = m_pages[bestPage];
+        addSkylineLevel(page, bestNode, bestX, bestY, paddedWidth, paddedHeight);
+        page.usedArea += static_cast<size_t>(width) * height;
+        page.lastUsedFrame = Texture2D::currentFrame();
+        if (pixels) {
+            page.pTexture->uploadRegion(bestX, bestY, width, height, pixels);
+        }
+
+        const AtlasRegionHandle handle = m_regions.insert({ bestPage, static_cast<uint32_t>(page.regions.size()), bestX, bestY, static_cast<int>(width), static_cast<int>(height) });
+        page.regions.push_back(handle);
+        return handle;
+    }
+
+    /* Free a region */
+    void DynamicAtlas::release(const AtlasRegionHandle handle) {
+        const RegionSlot* pSlot = m_regions.get(handle);
+        if (!pSlot) {
+            return;
+        }
+        const uint32_t pageIndex = pSlot->page;
+        const uint32_t indexInPage = pSlot->indexInPage;
+        Page& page = m_pages[pageIndex];
+        page.usedArea -= static_cast<size_t>(pSlot->width) * pSlot->height;
+        m_regions.erase(handle);
+        if (indexInPage + 1 != page.regions.size()) {
+            page.regions[indexInPage] = page.regions.back();
+            m_regions.get(page.regions[indexInPage])->indexInPage = indexInPage;
+        }
+        page.regions.pop_back();
+
+        /* The skyline can't reclaim holes, so the space of a page comes back when the page is empty */
+        if (page.regions.empty()) {
+            clearPage(pageIndex);
+        }
+    }
+
+    /* Get a region and mark its page as used */
+    bool DynamicAtlas::get(const AtlasRegionHandle handle, Region& region) {
+        const RegionSlot* pSlot = m_regions.get(handle);
+        if (!pSlot) {
+            return false;
+        }
+        Page& page = m_pages[pSlot->page];
+        page.lastUsedFrame = Texture2D::currentFrame();
+        region.page = pSlot->page;
+        region.pTexture = page.pTexture.get();
+        region.subTexture = Texture2D::SubTexture2D(glm::vec2(pSlot->x, pSlot->y) / static_cast<float>(m_pageSize),
+                                                    glm::vec2(pSlot->x + pSlot->width, pSlot->y + pSlot->height) / static_cast<float>(m_pageSize));
+        return true;
+    }
+
+    /* Find the lowest position for a rectangle on the page skyline */
+    bool DynamicAtlas::findPosition(const Page& page, const int width, const int height, size_t& nodeIndex, int& x, int& y) const {
+        const int pageSize = static_cast<int>(m_pageSize);
+        bool found = false;
+        int bestY = INT32_MAX;
+        int bestWidth = INT32_MAX;
+        for (size_t i = 0; i < page.skyline.size(); ++i) {
+            const int left = page.skyline[i].x;
+            if (left + width > pageSize) {
+                break;
+            }
+
+            /* The rectangle rests on the highest skyline segment under it */
+            int top = page.skyline[i].y;
+            int widthLeft = width;
+            for (size_t j = i; widthLeft > 0; ++j) {
+                top = std::max(top, page.skyline[j].y);
+                widthLeft -= page.skyline[j].width;
+            }
+            if (top + height > pageSize) {
+                continue;
+            }
+            /* Lowest position first, then the narrowest segment to leave wide segments for wide rectangles */
+            if (top < bestY || (top == bestY && page.skyline[i].width < bestWidth)) {
+                found = true;
+                nodeIndex = i;
+                x = left;
+                y = top;
+                bestY = top;
+                bestWidth = page.skyline[i].width;
+            }
+        }
+        return found;
+    }
+
+    /* Raise the skyline over a placed rectangle */
+    void DynamicAtlas::addSkylineLevel(Page& page, const size_t nodeIndex, const int x, const int y, const int width, const int height) {
+        std::vector <SkylineNode>& skyline = page.skyline;
+        skyline.insert(skyline.begin() + nodeIndex, SkylineNode{ x, y + height, width });
+
+        /* Cut the segments covered by the new one */
+        const int right = x + width;
+        size_t i = nodeIndex + 1;
+        while (i < skyline.size() && skyline[i].x < right) {
+            const int shrink = right - skyline[i].x;
+            if (shrink >= skyline[i].width) {
+                skyline.erase(skyline.begin() + i);
+            }
+            else {
+                skyline[i].x += shrink;
+                skyline[i].width -= shrink;
+                break;
+            }
+        }
+
+        /* Merge with the neighbours at the same height, the rest of the skyline is already merged */
+        if (nodeIndex + 1 < skyline.size() && skyline[nodeIndex + 1].y == skyline[nodeIndex].y) {
+            skyline[nodeIndex].width += skyline[nodeIndex + 1].width;
+            skyline.erase(skyline.begin() + nodeIndex + 1);
+        }
+        if (nodeIndex > 0 && skyline[nodeIndex - 1].y == skyline[nodeIndex].y) {
+            skyline[nodeIndex - 1].width += skyline[nodeIndex].width;
+            skyline.erase(skyline.begin() + nodeIndex);
+        }
+    }
+
+    /* Drop all regions of a page and make the page empty */
+    void DynamicAtlas::resetPage(const uint32_t pageIndex) {
+        Page& page = m_pages[pageIndex];
+        for (const AtlasRegionHandle handle : page.regions) {
+            m_regions.erase(handle);
+        }
+        page.regions.clear();
+        page.usedArea = 0;
+        page.skyline.assign(1, SkylineNode{ REGION_PADDING, REGION_PADDING, static_cast<int>(m_pageSize) - REGION_PADDING });
+    }
+
+    /* Reset a page that held regions and clear its texels */
+    void DynamicAtlas::clearPage(const uint32_t pageIndex) {
+        resetPage(pageIndex);
+        m_pages[pageIndex].pTexture->uploadRegion(0, 0, m_pageSize, m_pageSize, m_emptyPixels.data());
+    }
+
+    /* Create a new empty page */
+    void DynamicAtlas::addPage() {
+        if (m_emptyPixels.empty()) {
+            m_emptyPixels.assign(static_cast<size_t>(m_pageSize) * m_pageSize * 4, 0);
+        }
+        m_pages.emplace_back();
+        m_pages.back().pTexture = std::make_shared<Texture2D>(m_pageSize, m_pageSize, m_emptyPixels.data(), 4, m_filter, GL_CLAMP_TO_EDGE);
+        resetPage(static_cast<uint32_t>(m_pages.size() - 1));
+    }
+
+    /* Fraction of the page area covered by live regions */
+    float DynamicAtlas::occupancy() const {
+        if (m_pages.empty()) {
+            return 0.f;
+        }
+        size_t usedArea = 0;
+        for (const Page& page : m_pages) {
+            usedArea += page.usedArea;
+        }
+        return static_cast<float>(usedArea) / (static_cast<float>(m_pageSize) * m_pageSize * m_pages.size());
+    }
+
+    /* Video memory used by the pages */
+    size_t DynamicAtlas::gpuSizeInBytes() const {
+        size_t bytes = 0;
+        for (const Page& page : m_pages) {
+            bytes += page.pTexture->residentSizeInBytes();
+        }
+        return bytes;
+    }
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Texture2D.h"
+#include "../System/HandlePool.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Renderer {
+    struct AtlasRegionTag;
+    /* Generation-checked handle of a region: it turns stale when the region is released or its page is evicted */
+    typedef System::Handle<AtlasRegionTag> AtlasRegionHandle;
+
+    /*
+    Texture atlas filled at runtime. Rectangles are placed into fixed-size pages with a skyline allocator
+    and uploaded with glTexSubImage2D. When all pages are full, the least recently used page is evicted:
+    all its regions are invalidated and the page is reused. Pages used in the current frame
+    (see Texture2D::setCurrentFrame) are never evicted, so regions drawn this frame stay valid
+    */
+    class DynamicAtlas {
+    public:
+        /* Region as seen by the user: the page texture and the texture coordinates in it */
+        struct Region {
+            uint32_t page = 0;
+            const Texture2D* pTexture = nullptr;
+            Texture2D::SubTexture2D subTexture;
+        };
+
+        /* Create an empty atlas. Pages are created on demand, up to maxPages pages of pageSize x pageSize RGBA pixels */
+        DynamicAtlas(const unsigned int pageSize, const unsigned int maxPages, const GLenum filter = GL_LINEAR);
+
+        /* Prohibit copying of dynamic atlas objects */
+        DynamicAtlas(const DynamicAtlas&) = delete;
+        DynamicAtlas& operator = (const DynamicAtlas&) = delete;
+
+        /*
+        Place a width x height image (RGBA pixels, rows from the bottom) into the atlas, evicting the least recently
+        used page if necessary. Returns an invalid handle if the image is larger than a page or every page is in use
+        */
+        AtlasRegionHandle allocate(const unsigned int width, const unsigned int height, const unsigned char* pixels);
+        /* Free a region. Its space is reused once all regions of the page are released or the page is evicted */
+        void release(const AtlasRegionHandle handle);
+
+        /* Check whether the region is still in the atlas */
+        bool contains(const AtlasRegionHandle handle) const { return m_regions.contains(handle); }
+        /* Get a region and mark its page as used in the current frame. Returns false for stale handles */
+        bool get(const AtlasRegionHandle handle, Region& region);
+        /* Mark a page as used in the current frame (for users that keep the texture coordinates of regions) */
+        void touchPage(const uint32_t page) { m_pages[page].lastUsedFrame = Texture2D::currentFrame(); }
+
+        size_t pagesCount() const { return m_pages.size(); }
+        const Texture2D* getPage(const uint32_t page) const { return m_pages[page].pTexture.get(); }
+        size_t regionsCount() const { return m_regions.size(); }
+        /* Number of page evictions so far. Texture coordinates kept by users are stale once it changes */
+        uint64_t evictionsCount() const { return m_evictionsCount; }
+        /* Fraction of the page area covered by live regions */
+        float occupancy() const;
+        /* Video memory used by the pages */
+        size_t gpuSizeInBytes() const;
+
+    private:
+        /* Segment of the skyline: the pages are filled upwards and the skyline is the top edge of the filled area */
+        struct SkylineNode {
+            int x;
+            int y;
+            int width;
+        };
+        struct Page {
+            std::shared_ptr <Texture2D> pTexture;
+            std::vector <SkylineNode> skyline;
+            std::vector <AtlasRegionHandle> regions;
+            size_t usedArea = 0;
+            uint64_t lastUsedFrame = 0;
+        };
+        struct RegionSlot {
+            uint32_t page;
+            uint32_t indexInPage;   // Position in the region list of the page, for O(1) removal
+            int x;
+            int y;
+            int width;
+            int height;
+        };
+
+        /* Find the lowest position for a rectangle on the page skyline. Returns false if it does not fit */
+        bool findPosition(const Page& page, const int width, const int height, size_t& nodeIndex, int& x, int& y) const;
+        /* Raise the skyline over a placed rectangle */
+        void addSkylineLevel(Page& page, const size_t nodeIndex, const int x, const int y, const int width, const int height);
+        /* Drop all regions of a page and make the page empty */
+        void resetPage(const uint32_t page);
+        /* Reset a page that held regions and clear its texels, so that the padding of new regions is empty under linear filtering */
+        void clearPage(const uint32_t page);
+        /* Create a new empty page */
+        void addPage();
+
+        unsigned int m_pageSize;
+        unsigned int m_maxPages;
+        GLenum m_filter;
+        std::vector <Page> m_pages;
+        System::HandlePool <RegionSlot, AtlasRegionTag> m_regions;
+        uint64_t m_evictionsCount = 0;
+        std::vector <unsigned char> m_emptyPixels;  // Zeros for clearing reused pages
+    };
+}
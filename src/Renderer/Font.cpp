@@ -0,0 +1,103 @@
+#include "Font.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace Renderer {
+    /* Create a font */
+    Font::Font(std::vector <unsigned char> sheetCoverage,
+               const int sheetWidth,
+               std::unordered_map <uint32_t, GlyphSource> glyphSources,
+               const float lineHeight,
+               const float ascent,
+               const int pageSize,
+               const unsigned int maxPages)
+        : m_sheetCoverage(std::move(sheetCoverage))
+        , m_sheetWidth(sheetWidth)
+        , m_glyphSources(std::move(glyphSources))
+        , m_lineHeight(lineHeight)
+        , m_ascent(ascent)
+        , m_atlas(pageSize, maxPages, GL_LINEAR) {
+        std::fill(std::begin(m_asciiGlyphs), std::end(m_asciiGlyphs), NOT_RESIDENT);
+    }
+
+    /* Get a glyph, copying it into the atlas on the first request or after its page was evicted */
+    const Font::Glyph* Font::getGlyph(const uint32_t codepoint) {
+        uint32_t glyphIndex = NOT_RESIDENT;
+        if (codepoint < 128) {
+            glyphIndex = m_asciiGlyphs[codepoint];
+        }
+        else {
+            auto it = m_otherGlyphs.find(codepoint);
+            if (it != m_otherGlyphs.end()) {
+                glyphIndex = it->second;
+            }
+        }
+        if (glyphIndex != NOT_RESIDENT && isResident(m_glyphs[glyphIndex])) {
+            /* The page must survive the glyphs requested after this one in the same frame */
+            const Glyph& glyph = m_glyphs[glyphIndex];
+            if (glyph.region.isValid()) {
+                m_atlas.touchPage(glyph.page);
+            }
+            return &glyph;
+        }
+
+        auto sourceIt = m_glyphSources.find(codepoint);
+        if (sourceIt == m_glyphSources.end()) {
+            return codepoint != '?' ? getGlyph('?') : nullptr;
+        }
+
+        /* An evicted glyph is copied again into its old slot, so pointers handed out before stay valid */
+        if (glyphIndex == NOT_RESIDENT) {
+            Glyph glyph;
+            if (!rasterizeGlyph(codepoint, sourceIt->second, glyph)) {
+                return nullptr;
+            }
+            glyphIndex = static_cast<uint32_t>(m_glyphs.size());
+            m_glyphs.push_back(glyph);
+            if (codepoint < 128) {
+                m_asciiGlyphs[codepoint] = glyphIndex;
+            }
+            else {
+                m_otherGlyphs.emplace(codepoint, glyphIndex);
+            }
+        }
+        else if (!rasterizeGlyph(codepoint, sourceIt->second, m_glyphs[glyphIndex])) {
+            return nullptr;
+        }
+        return &m_glyphs[glyphIndex];
+    }
+
+    /* Copy a glyph into the atlas */
+    bool Font::rasterizeGlyph(const uint32_t codepoint, const GlyphSource& source, Glyph& glyph) {
+        glyph.size = glm::vec2(source.width, source.height);
+        glyph.offset = glm::vec2(source.offsetX, source.offsetY);
+        glyph.advance = static_cast<float>(source.advance);
+        glyph.region = AtlasRegionHandle();
+        if (source.width <= 0 || source.height <= 0) {
+            return true;
+        }
+
+        /* Expand the coverage into white RGBA pixels, the text color is applied when drawing */
+        m_uploadPixels.resize(static_cast<size_t>(source.width) * source.height * 4);
+        for (int row = 0; row < source.height; ++row) {
+            const unsigned char* pCoverage = m_sheetCoverage.data() + static_cast<size_t>(source.y + row) * m_sheetWidth + source.x;
+            unsigned char* pPixel = m_uploadPixels.data() + static_cast<size_t>(row) * source.width * 4;
+            for (int column = 0; column < source.width; ++column, pPixel += 4) {
+                pPixel[0] = pPixel[1] = pPixel[2] = 255;
+                pPixel[3] = pCoverage[column];
+            }
+        }
+        glyph.region = m_atlas.allocate(source.width, source.height, m_uploadPixels.data());
+
+        DynamicAtlas::Region region;
+        if (!m_atlas.get(glyph.region, region)) {
+            std::cerr << "Can't place glyph " << codepoint << " into the font atlas" << std::endl;
+            return false;
+        }
+        glyph.page = region.page;
+        glyph.leftBottomUV = region.subTexture.leftBottomUV;
+        glyph.rightTopUV = region.subTexture.rightTopUV;
+        return true;
+    }
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "DynamicAtlas.h"
+
+#include <glm/vec2.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+namespace Renderer {
+    /*
+    Bitmap font. Glyph bitmaps come from a pre-baked glyph sheet kept in system memory, a glyph is copied into
+    a dynamic atlas the first time it is requested. When the atlas is full its least recently used page is evicted
+    and the glyphs that were there are copied in again on their next request
+    */
+    class Font {
+    public:
+        /* Where a glyph is in the glyph sheet and how it is placed relative to the pen, in pixels */
+        struct GlyphSource {
+            int x = 0;              // Left bottom corner in the sheet
+            int y = 0;
+            int width = 0;
+            int height = 0;
+            int offsetX = 0;        // Left edge relative to the pen position
+            int offsetY = 0;        // Top edge relative to the baseline (up is positive)
+            int advance = 0;        // Pen advance
+        };
+
+        /* Glyph ready for drawing */
+        struct Glyph {
+            uint32_t page = 0;      // Index of the atlas page
+            AtlasRegionHandle region;   // Invalid for glyphs without a bitmap (e.g. space)
+            glm::vec2 leftBottomUV = glm::vec2(0.f);
+            glm::vec2 rightTopUV = glm::vec2(0.f);
+            glm::vec2 size = glm::vec2(0.f);
+            glm::vec2 offset = glm::vec2(0.f);  // Left top corner relative to the pen position on the baseline
+            float advance = 0.f;
+        };
+
+        /*
+        Create a font from the alpha coverage of the glyph sheet (one byte per pixel, rows of sheetWidth from the bottom),
+        the glyph sources by codepoint and the font metrics. The glyph atlas has up to maxPages pages of pageSize x pageSize
+        */
+        Font(std::vector <unsigned char> sheetCoverage,
+             const int sheetWidth,
+             std::unordered_map <uint32_t, GlyphSource> glyphSources,
+             const float lineHeight,
+             const float ascent,
+             const int pageSize = 256,
+             const unsigned int maxPages = 4);
+
+        /* Prohibit copying of font objects */
+        Font(const Font&) = delete;
+        Font& operator = (const Font&) = delete;
+
+        /*
+        Get a glyph, copying it into the atlas on the first request or after its page was evicted.
+        Codepoints missing in the font are replaced with '?'. Returns nullptr if neither is available
+        */
+        const Glyph* getGlyph(const uint32_t codepoint);
+
+        float lineHeight() const { return m_lineHeight; }
+        float ascent() const { return m_ascent; }
+
+        size_t pagesCount() const { return m_atlas.pagesCount(); }
+        const Texture2D* getPage(const uint32_t page) const { return m_atlas.getPage(page); }
+        /* Keep a page from being evicted in the current frame, for glyphs drawn from a cached layout */
+        void touchPage(const uint32_t page) { m_atlas.touchPage(page); }
+        /* Changes whenever glyphs are evicted: texture coordinates of glyphs obtained earlier are stale then */
+        uint64_t atlasGeneration() const { return m_atlas.evictionsCount(); }
+        /* Number of glyph bitmaps in the atlas */
+        size_t residentGlyphsCount() const { return m_atlas.regionsCount(); }
+        /* Video memory used by the atlas pages */
+        size_t gpuSizeInBytes() const { return m_atlas.gpuSizeInBytes(); }
+
+    private:
+        /* Copy a glyph into the atlas. Returns false if the glyph does not fit */
+        bool rasterizeGlyph(const uint32_t codepoint, const GlyphSource& source, Glyph& glyph);
+        /* Check that the glyph bitmap is still in the atlas */
+        bool isResident(const Glyph& glyph) const { return !glyph.region.isValid() || m_atlas.contains(glyph.region); }
+
+        std::vector <unsigned char> m_sheetCoverage;
+        int m_sheetWidth;
+        std::unordered_map <uint32_t, GlyphSource> m_glyphSources;
+        float m_lineHeight;
+        float m_ascent;
+
+        /* Glyphs requested so far: ASCII is looked up in a table, other codepoints in a map */
+        std::deque <Glyph> m_glyphs;    // Glyphs never move, so pointers to them stay valid
+        static constexpr uint32_t NOT_RESIDENT = UINT32_MAX;
+        uint32_t m_asciiGlyphs[128];
+        std::unordered_map <uint32_t, uint32_t> m_otherGlyphs;
+
+        DynamicAtlas m_atlas;
+        std::vector <unsigned char> m_uploadPixels;     // Staging for the RGBA pixels of a glyph
+    };
+}
@@ -0,0 +1,250 @@
+#include "FrameCapture.h"
+
+#include <glm/common.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb_image_write.h"
+
+namespace Renderer {
+    namespace {
+        /* Longest wait for a readback, in nanoseconds */
+        const GLuint64 READBACK_TIMEOUT = 1000000000;
+    }
+
+    /* Create the ring of pixel pack buffers and the writer thread */
+    FrameCapture::FrameCapture(const std::string& outputPath, const Format format, const glm::ivec2& frameSize, const unsigned int ringSize)
+        : m_outputPath(outputPath)
+        , m_format(format)
+        , m_frameSize(glm::max(frameSize, glm::ivec2(1)))
+        , m_readbacks(std::max(ringSize, 1u)) {
+        if (m_format == Format::PPM_STREAM) {
+            m_stream.open(m_outputPath, std::ios::binary);
+            if (!m_stream.is_open()) {
+                std::cerr << "Can't open the capture stream " << m_outputPath << std::endl;
+            }
+        }
+        m_queuedReadbacks.reserve(m_readbacks.size());
+        createBuffers();
+        m_writerThread = std::thread(&FrameCapture::writerLoop, this);
+    }
+
+    /* Write the captured frames, then delete the buffers and join the writer thread */
+    FrameCapture::~FrameCapture() {
+        finish();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_isStopping = true;
+        }
+        m_queueCondition.notify_all();
+        m_writerThread.join();
+        deleteBuffers();
+    }
+
+    /* Start the readback of the color buffer of a framebuffer */
+    bool FrameCapture::capture(const GLuint framebuffer) {
+        collectReadbacks(false);
+
+        /*
+        The next buffer of the ring is the oldest one. If the GPU has not finished its readback yet or the writer still has it,
+        the frame is dropped: waiting for the fence would stall the renderer and the buffer would still not be free
+        */
+        Readback& readback = m_readbacks[m_nextReadback];
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (readback.state != Readback::State::FREE) {
+            ++m_statistics.droppedFrames;
+            return false;
+        }
+        ++m_statistics.capturedFrames;
+        readback.state = Readback::State::READING;
+        lock.unlock();
+
+        readback.frameNumber = m_framesCount++;
+        m_nextReadback = (m_nextReadback + 1) % m_readbacks.size();
+
+        GLint previousFramebuffer = 0;
+        glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousFramebuffer);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+        glReadBuffer(framebuffer == 0 ? GL_BACK : GL_COLOR_ATTACHMENT0);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        /* With a pack buffer bound the pointer is an offset into it, the copy runs on the GPU after the frame */
+        glReadPixels(0, 0, m_frameSize.x, m_frameSize.y, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        readback.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, static_cast<GLuint>(previousFramebuffer));
+        return true;
+    }
+
+    /* Hand finished readbacks to the writer without starting a new one */
+    void FrameCapture::update() {
+        collectReadbacks(false);
+    }
+
+    /* Wait until every captured frame is written */
+    void FrameCapture::finish() {
+        collectReadbacks(true);
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_writtenCondition.wait(lock, [this]() { return m_queuedReadbacks.empty() && m_readbacksBeingWritten == 0; });
+        }
+        /* Unmap the written buffers */
+        collectReadbacks(false);
+        if (m_stream.is_open()) {
+            m_stream.flush();
+        }
+    }
+
+    /* Change the frame size, the pending frames are written first */
+    void FrameCapture::setFrameSize(const glm::ivec2& frameSize) {
+        const glm::ivec2 newFrameSize = glm::max(frameSize, glm::ivec2(1));
+        if (newFrameSize == m_frameSize) {
+            return;
+        }
+        finish();
+        deleteBuffers();
+        m_frameSize = newFrameSize;
+        createBuffers();
+    }
+
+    FrameCapture::Statistics FrameCapture::statistics() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_statistics;
+    }
+
+    /* Create the buffers of the frame size */
+    void FrameCapture::createBuffers() {
+        const GLsizeiptr frameSizeInBytes = static_cast<GLsizeiptr>(m_frameSize.x) * m_frameSize.y * 4;
+        for (Readback& readback : m_readbacks) {
+            glGenBuffers(1, &readback.buffer);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+            glBufferData(GL_PIXEL_PACK_BUFFER, frameSizeInBytes, nullptr, GL_STREAM_READ);
+            readback.state = Readback::State::FREE;
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        m_nextReadback = 0;
+    }
+
+    /* Delete the buffers of the ring, every buffer is free */
+    void FrameCapture::deleteBuffers() {
+        for (Readback& readback : m_readbacks) {
+            glDeleteBuffers(1, &readback.buffer);
+            readback.buffer = 0;
+        }
+    }
+
+    /* Map the finished readbacks for the writer and unmap the written ones */
+    void FrameCapture::collectReadbacks(const bool isWaiting) {
+        /* Readbacks finish in the order they were started, the oldest one is the next buffer of the ring */
+        bool isReadingFinished = true;
+        for (size_t i = 0; i < m_readbacks.size(); ++i) {
+            Readback& readback = m_readbacks[(m_nextReadback + i) % m_readbacks.size()];
+            Readback::State state;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                state = readback.state;
+            }
+
+            if (state == Readback::State::WRITTEN) {
+                glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+                glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+                glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+                readback.pixels = nullptr;
+                std::lock_guard<std::mutex> lock(m_mutex);
+                readback.state = Readback::State::FREE;
+            }
+            else if (state == Readback::State::READING && isReadingFinished) {
+                if (!isWaiting) {
+                    const GLenum status = glClientWaitSync(readback.fence, 0, 0);
+                    isReadingFinished = status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED;
+                }
+                if (isReadingFinished) {
+                    queueReadback(readback);
+                }
+            }
+        }
+    }
+
+    /* Map a finished readback and queue it for the writer */
+    void FrameCapture::queueReadback(Readback& readback) {
+        if (glClientWaitSync(readback.fence, GL_SYNC_FLUSH_COMMANDS_BIT, READBACK_TIMEOUT) == GL_TIMEOUT_EXPIRED) {
+            std::cerr << "Readback of frame " << readback.frameNumber << " timed out" << std::endl;
+        }
+        glDeleteSync(readback.fence);
+        readback.fence = nullptr;
+
+        /* The mapping stays valid for the writer thread until the buffer is unmapped, so the pixels are not copied */
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+        readback.pixels = static_cast<const uint8_t*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0,
+                                                                        static_cast<GLsizeiptr>(m_frameSize.x) * m_frameSize.y * 4, GL_MAP_READ_BIT));
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!readback.pixels) {
+            std::cerr << "Can't map the readback of frame " << readback.frameNumber << std::endl;
+            readback.state = Readback::State::FREE;
+            return;
+        }
+        readback.state = Readback::State::QUEUED;
+        m_queuedReadbacks.push_back(static_cast<size_t>(&readback - m_readbacks.data()));
+        m_queueCondition.notify_one();
+    }
+
+    /* Encode queued readbacks until the capture is destroyed */
+    void FrameCapture::writerLoop() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            m_queueCondition.wait(lock, [this]() { return m_isStopping || !m_queuedReadbacks.empty(); });
+            if (m_queuedReadbacks.empty()) {
+                return;
+            }
+            Readback& readback = m_readbacks[m_queuedReadbacks.front()];
+            m_queuedReadbacks.erase(m_queuedReadbacks.begin());
+            ++m_readbacksBeingWritten;
+
+            lock.unlock();
+            writeFrame(readback.pixels, readback.frameNumber);
+            lock.lock();
+
+            readback.state = Readback::State::WRITTEN;
+            --m_readbacksBeingWritten;
+            ++m_statistics.writtenFrames;
+            m_writtenCondition.notify_all();
+        }
+    }
+
+    /* Encode a frame of RGBA pixels, rows from the bottom */
+    void FrameCapture::writeFrame(const uint8_t* pixels, const uint64_t frameNumber) {
+        const size_t rowSizeInBytes = static_cast<size_t>(m_frameSize.x) * 4;
+        if (m_format == Format::PNG_FILES) {
+            char suffix[32];
+            std::snprintf(suffix, sizeof(suffix), "_%06llu.png", static_cast<unsigned long long>(frameNumber));
+            const std::string path = m_outputPath + suffix;
+            /* Image files start from the top row: the last row is written first with a negative stride */
+            const uint8_t* topRow = pixels + (m_frameSize.y - 1) * rowSizeInBytes;
+            if (!stbi_write_png(path.c_str(), m_frameSize.x, m_frameSize.y, 4, topRow, -static_cast<int>(rowSizeInBytes))) {
+                std::cerr << "Can't write the frame " << path << std::endl;
+            }
+            return;
+        }
+
+        if (!m_stream.is_open()) {
+            return;
+        }
+        m_rgbPixels.resize(static_cast<size_t>(m_frameSize.x) * m_frameSize.y * 3);
+        uint8_t* rgbPixel = m_rgbPixels.data();
+        for (int row = m_frameSize.y - 1; row >= 0; --row) {
+            const uint8_t* pixel = pixels + row * rowSizeInBytes;
+            for (int column = 0; column < m_frameSize.x; ++column, pixel += 4, rgbPixel += 3) {
+                rgbPixel[0] = pixel[0];
+                rgbPixel[1] = pixel[1];
+                rgbPixel[2] = pixel[2];
+            }
+        }
+        m_stream << "P6\n" << m_frameSize.x << " " << m_frameSize.y << "\n255\n";
+        m_stream.write(reinterpret_cast<const char*>(m_rgbPixels.data()), static_cast<std::streamsize>(m_rgbPixels.size()));
+    }
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/vec2.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Renderer {
+    /*
+    Asynchronous readback of frames for screenshots and footage. glReadPixels writes into a ring of pixel pack
+    buffers, so it only queues a copy on the GPU, and a fence marks when the copy is done. A buffer is mapped
+    a few frames later, once its fence is signaled, and a writer thread encodes the pixels straight from the mapping,
+    so the renderer never copies a frame. The buffer is unmapped and reused after the writer is done with it.
+    When the writer falls behind and the ring is full, frames are dropped instead of stalling the renderer.
+    Capturing a frame does not allocate
+    */
+    class FrameCapture {
+    public:
+        enum class Format {
+            PNG_FILES,      // One PNG file per frame: <outputPath>_<frame number>.png
+            PPM_STREAM      // Binary PPM images appended to the file <outputPath>, e.g. for ffmpeg -f image2pipe
+        };
+
+        /* Counters since the creation of the capture */
+        struct Statistics {
+            uint64_t capturedFrames = 0;    // Readbacks started
+            uint64_t writtenFrames = 0;     // Frames encoded by the writer thread
+            uint64_t droppedFrames = 0;     // Frames not captured because every buffer of the ring was being read back or written
+        };
+
+        /*
+        Create the ring of pixel pack buffers and the writer thread. A readback is mapped at latest ringSize frames after
+        it was started, the buffers being written count against the ring
+        */
+        FrameCapture(const std::string& outputPath, const Format format, const glm::ivec2& frameSize, const unsigned int ringSize = 4);
+
+        /* Write the captured frames, then delete the buffers and join the writer thread */
+        ~FrameCapture();
+
+        /* Prohibit copying of frame capture objects */
+        FrameCapture(const FrameCapture&) = delete;
+        FrameCapture& operator = (const FrameCapture&) = delete;
+
+        /*
+        Start the readback of the color buffer of a framebuffer (0 is the back buffer of the window), from the lower left
+        corner with the frame size. Finished readbacks are handed to the writer first. Returns false if the frame was dropped
+        */
+        bool capture(const GLuint framebuffer = 0);
+        /* Hand finished readbacks to the writer without starting a new one, call it every frame while captures are pending */
+        void update();
+        /* Wait until every captured frame is written */
+        void finish();
+
+        /* Change the frame size, the pending frames are written first */
+        void setFrameSize(const glm::ivec2& frameSize);
+        const glm::ivec2& frameSize() const { return m_frameSize; }
+
+        Statistics statistics();
+
+    private:
+        /* Pixel pack buffer of the ring */
+        struct Readback {
+            enum class State {
+                FREE,
+                READING,    // The GPU copies the frame into the buffer, the fence is signaled when it is done
+                QUEUED,     // Mapped, the writer encodes the pixels
+                WRITTEN     // Mapped, the writer is done and the buffer can be unmapped
+            };
+
+            GLuint buffer = 0;
+            GLsync fence = nullptr;
+            State state = State::FREE;
+            const uint8_t* pixels = nullptr;
+            uint64_t frameNumber = 0;
+        };
+
+        /* Create or delete the buffers of the frame size */
+        void createBuffers();
+        void deleteBuffers();
+        /* Map the finished readbacks for the writer (every pending one when waiting) and unmap the written ones */
+        void collectReadbacks(const bool isWaiting);
+        /* Map a finished readback and queue it for the writer */
+        void queueReadback(Readback& readback);
+        /* Encode queued readbacks until the capture is destroyed */
+        void writerLoop();
+        /* Encode a frame of RGBA pixels, rows from the bottom like in the framebuffer */
+        void writeFrame(const uint8_t* pixels, const uint64_t frameNumber);
+
+        std::string m_outputPath;
+        Format m_format;
+        glm::ivec2 m_frameSize;
+        std::vector <Readback> m_readbacks;
+        size_t m_nextReadback = 0;
+        uint64_t m_framesCount = 0;
+
+        /* States of the readbacks and the queue of the writer, guarded by the mutex */
+        std::vector <size_t> m_queuedReadbacks;
+        size_t m_readbacksBeingWritten = 0;
+        Statistics m_statistics;
+        std::mutex m_mutex;
+        std::condition_variable m_queueCondition;
+        std::condition_variable m_writtenCondition;
+        bool m_isStopping = false;
+
+        /* Used by the writer thread only */
+        std::ofstream m_stream;
+        std::vector <uint8_t> m_rgbPixels;
+        std::thread m_writerThread;
+    };
+}
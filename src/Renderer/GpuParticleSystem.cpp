@@ -0,0 +1,140 @@
+#include "GpuParticleSystem.h"
+#include "InstancedQuads.h"
+#include "ShaderProgram.h"
+
+#include <glm/trigonometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+namespace Renderer {
+    /* Create the state buffers */
+    GpuParticleSystem::GpuParticleSystem(std::shared_ptr <Texture2D> pTexture,
+                                         const Texture2D::SubTextureId subTextureId,
+                                         std::shared_ptr <ShaderProgram> pSimulationShaderProgram,
+                                         std::shared_ptr <ShaderProgram> pRenderShaderProgram,
+                                         const ParticleEmitterSettings& settings)
+        : m_pTexture(std::move(pTexture))
+        , m_subTextureId(subTextureId)
+        , m_pSimulationShaderProgram(std::move(pSimulationShaderProgram))
+        , m_pRenderShaderProgram(std::move(pRenderShaderProgram))
+        , m_settings(settings) {
+        m_simulationUniforms.deltaTime = m_pSimulationShaderProgram->getUniformLocation("deltaTime");
+        m_simulationUniforms.seed = m_pSimulationShaderProgram->getUniformLocation("seed");
+        m_simulationUniforms.gravity = m_pSimulationShaderProgram->getUniformLocation("gravity");
+        m_simulationUniforms.dragFactor = m_pSimulationShaderProgram->getUniformLocation("dragFactor");
+        m_simulationUniforms.emitterPosition = m_pSimulationShaderProgram->getUniformLocation("emitterPosition");
+        m_simulationUniforms.emitterSpread = m_pSimulationShaderProgram->getUniformLocation("emitterSpread");
+        m_simulationUniforms.speedDirection = m_pSimulationShaderProgram->getUniformLocation("speedDirection");
+        m_simulationUniforms.lifetimeRange = m_pSimulationShaderProgram->getUniformLocation("lifetimeRange");
+        m_renderUniforms.uvRect = m_pRenderShaderProgram->getUniformLocation("uvRect");
+        m_renderUniforms.sizeRange = m_pRenderShaderProgram->getUniformLocation("sizeRange");
+        m_renderUniforms.startColor = m_pRenderShaderProgram->getUniformLocation("startColor");
+        m_renderUniforms.endColor = m_pRenderShaderProgram->getUniformLocation("endColor");
+
+        /*
+        Particles start unborn with negative ages spread over one lifetime, so they are born at a steady rate
+        instead of in one burst. Their first state is respawned by the simulation
+        */
+        std::vector <ParticleState> initialState(m_settings.maxParticles);
+        std::mt19937 random(1);
+        std::uniform_real_distribution<float> birthDelay(0.f, std::max(m_settings.maxLifetime, 0.001f));
+        for (ParticleState& particle : initialState) {
+            particle = ParticleState{ { m_settings.position.x, m_settings.position.y, 0.f, 0.f }, { -birthDelay(random), 0.f, 0.f, 0.f } };
+        }
+
+        m_quad_vbo = createUnitQuadBuffer();
+
+        glGenBuffers(2, m_state_vbos);
+        glGenVertexArrays(2, m_simulationVaos);
+        glGenVertexArrays(2, m_renderVaos);
+        for (unsigned int i = 0; i < 2; ++i) {
+            glBindBuffer(GL_ARRAY_BUFFER, m_state_vbos[i]);
+            glBufferData(GL_ARRAY_BUFFER, initialState.size() * sizeof(ParticleState), initialState.data(), GL_DYNAMIC_COPY);
+
+            /* Simulation reads one particle per vertex */
+            glBindVertexArray(m_simulationVaos[i]);
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleState), reinterpret_cast<const void*>(offsetof(ParticleState, positionVelocity)));
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleState), reinterpret_cast<const void*>(offsetof(ParticleState, ageLifetime)));
+
+            /* Rendering reads one particle per quad instance */
+            glBindVertexArray(m_renderVaos[i]);
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleState), reinterpret_cast<const void*>(offsetof(ParticleState, positionVelocity)));
+            glVertexAttribDivisor(1, 1);
+            glEnableVertexAttribArray(2);
+            glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleState), reinterpret_cast<const void*>(offsetof(ParticleState, ageLifetime)));
+            glVertexAttribDivisor(2, 1);
+            setUnitQuadAttribute(m_quad_vbo);
+        }
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    /* Delete the buffers */
+    GpuParticleSystem::~GpuParticleSystem() {
+        glDeleteVertexArrays(2, m_renderVaos);
+        glDeleteVertexArrays(2, m_simulationVaos);
+        glDeleteBuffers(2, m_state_vbos);
+        glDeleteBuffers(1, &m_quad_vbo);
+    }
+
+    /* Advance all particles by one step on the GPU */
+    void GpuParticleSystem::update(const float deltaTime) {
+        if (size() == 0) {
+            return;
+        }
+        const unsigned int next = 1 - m_current;
+
+        m_pSimulationShaderProgram->use();
+        glUniform1f(m_simulationUniforms.deltaTime, deltaTime);
+        glUniform1ui(m_simulationUniforms.seed, ++m_seed);
+        glUniform2f(m_simulationUniforms.gravity, m_settings.gravity.x, m_settings.gravity.y);
+        glUniform1f(m_simulationUniforms.dragFactor, std::exp(-m_settings.drag * deltaTime));
+        glUniform2f(m_simulationUniforms.emitterPosition, m_settings.position.x, m_settings.position.y);
+        glUniform2f(m_simulationUniforms.emitterSpread, m_settings.positionSpread.x, m_settings.positionSpread.y);
+        glUniform4f(m_simulationUniforms.speedDirection, m_settings.minSpeed, m_settings.maxSpeed,
+                    glm::radians(m_settings.direction), glm::radians(m_settings.directionSpread));
+        glUniform2f(m_simulationUniforms.lifetimeRange, std::max(m_settings.minLifetime, 0.001f), std::max(m_settings.maxLifetime, 0.001f));
+
+        /* Nothing is rasterized: the vertex shader outputs go straight into the other state buffer */
+        glEnable(GL_RASTERIZER_DISCARD);
+        glBindVertexArray(m_simulationVaos[m_current]);
+        glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, m_state_vbos[next]);
+        glBeginTransformFeedback(GL_POINTS);
+        glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(size()));
+        glEndTransformFeedback();
+        glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+        glBindVertexArray(0);
+        glDisable(GL_RASTERIZER_DISCARD);
+
+        m_current = next;
+    }
+
+    /* Draw the particles */
+    void GpuParticleSystem::render() {
+        if (size() == 0) {
+            return;
+        }
+        const Texture2D::SubTexture2D subTexture = m_pTexture->getSubTexture(m_subTextureId);
+        m_pRenderShaderProgram->use();
+        glUniform4f(m_renderUniforms.uvRect, subTexture.leftBottomUV.x, subTexture.leftBottomUV.y, subTexture.rightTopUV.x, subTexture.rightTopUV.y);
+        glUniform2f(m_renderUniforms.sizeRange, m_settings.startSize, m_settings.endSize);
+        glUniform4f(m_renderUniforms.startColor, m_settings.startColor.r, m_settings.startColor.g, m_settings.startColor.b, m_settings.startColor.a);
+        glUniform4f(m_renderUniforms.endColor, m_settings.endColor.r, m_settings.endColor.g, m_settings.endColor.b, m_settings.endColor.a);
+        glActiveTexture(GL_TEXTURE0);
+        m_pTexture->bind();
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glBindVertexArray(m_renderVaos[m_current]);
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(size()));
+        glBindVertexArray(0);
+        glDisable(GL_BLEND);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "ParticleEmitter.h"
+#include "Texture2D.h"
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <memory>
+
+namespace Renderer {
+    class ShaderProgram;
+
+    /*
+    GPU-resident particle system. The particle state lives in two vertex buffers: every step a vertex shader reads
+    one of them and writes the advanced state into the other with transform feedback, then the buffers swap.
+    Rendering reads the current buffer as instance attributes, so particles never travel over the bus.
+    The number of particles is fixed: dead particles respawn at the emitter on the GPU
+    */
+    class GpuParticleSystem {
+    public:
+        /*
+        Create the state buffers. The simulation shader program must capture out_positionVelocity and out_ageLifetime
+        with transform feedback. Settings are the ones of ParticleEmitter, maxParticles is the number of particles
+        */
+        GpuParticleSystem(std::shared_ptr <Texture2D> pTexture,
+                          const Texture2D::SubTextureId subTextureId,
+                          std::shared_ptr <ShaderProgram> pSimulationShaderProgram,
+                          std::shared_ptr <ShaderProgram> pRenderShaderProgram,
+                          const ParticleEmitterSettings& settings);
+
+        /* Delete the buffers */
+        ~GpuParticleSystem();
+
+        /* Prohibit copying of GPU particle system objects */
+        GpuParticleSystem(const GpuParticleSystem&) = delete;
+        GpuParticleSystem& operator = (const GpuParticleSystem&) = delete;
+
+        /* Advance all particles by one step on the GPU */
+        void update(const float deltaTime);
+        /* Draw the particles with alpha blending. The render shader program must have a projectionMat uniform */
+        void render();
+
+        ParticleEmitterSettings& settings() { return m_settings; }
+        const ParticleEmitterSettings& settings() const { return m_settings; }
+        size_t size() const { return m_settings.maxParticles; }
+
+    private:
+        /* State of one particle, as read and written by the simulation shader */
+        struct ParticleState {
+            float positionVelocity[4];
+            float ageLifetime[4];
+        };
+
+        std::shared_ptr <Texture2D> m_pTexture;
+        Texture2D::SubTextureId m_subTextureId;
+        std::shared_ptr <ShaderProgram> m_pSimulationShaderProgram;
+        std::shared_ptr <ShaderProgram> m_pRenderShaderProgram;
+        ParticleEmitterSettings m_settings;
+        uint32_t m_seed = 0;
+
+        /* Uniform locations, looked up once */
+        struct SimulationUniforms {
+            GLint deltaTime;
+            GLint seed;
+            GLint gravity;
+            GLint dragFactor;
+            GLint emitterPosition;
+            GLint emitterSpread;
+            GLint speedDirection;
+            GLint lifetimeRange;
+        } m_simulationUniforms;
+        struct RenderUniforms {
+            GLint uvRect;
+            GLint sizeRange;
+            GLint startColor;
+            GLint endColor;
+        } m_renderUniforms;
+
+        /* Buffer i has a VAO that feeds it to the simulation and one that feeds it to rendering */
+        GLuint m_state_vbos[2] = { 0, 0 };
+        GLuint m_simulationVaos[2] = { 0, 0 };
+        GLuint m_renderVaos[2] = { 0, 0 };
+        GLuint m_quad_vbo = 0;
+        unsigned int m_current = 0;     // Index of the buffer with the latest state
+    };
+}
@@ -0,0 +1,108 @@
+#include "InstancedQuads.h"
+
+#include <algorithm>
+
+namespace Renderer {
+    /* Pack a color with components in [0, 1] into RGBA8 */
+    uint32_t packColor(const glm::vec4& color) {
+        return static_cast<uint32_t>(color.r * 255.f + 0.5f)
+             | static_cast<uint32_t>(color.g * 255.f + 0.5f) << 8
+             | static_cast<uint32_t>(color.b * 255.f + 0.5f) << 16
+             | static_cast<uint32_t>(color.a * 255.f + 0.5f) << 24;
+    }
+
+    /* Create a buffer with the unit quad */
+    GLuint createUnitQuadBuffer() {
+        const GLfloat quadCoords[] = {
+            0.f, 0.f,
+            1.f, 0.f,
+            0.f, 1.f,
+            1.f, 1.f
+        };
+        GLuint quadBuffer = 0;
+        glGenBuffers(1, &quadBuffer);
+        glBindBuffer(GL_ARRAY_BUFFER, quadBuffer);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(quadCoords), quadCoords, GL_STATIC_DRAW);
+        return quadBuffer;
+    }
+
+    /* Feed the unit quad to attribute 0 of the bound vertex array */
+    void setUnitQuadAttribute(const GLuint quadBuffer) {
+        glBindBuffer(GL_ARRAY_BUFFER, quadBuffer);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+    }
+
+    /* Create the buffers and the vertex array */
+    InstancedQuads::InstancedQuads(const size_t instanceSize, std::initializer_list <InstanceAttribute> attributes)
+        : m_instanceSize(instanceSize)
+        , m_attributes(attributes) {
+        glGenVertexArrays(1, &m_vao);
+        glBindVertexArray(m_vao);
+
+        m_quad_vbo = createUnitQuadBuffer();
+        setUnitQuadAttribute(m_quad_vbo);
+
+        /* Instance attributes advance once per quad instead of once per vertex */
+        glGenBuffers(1, &m_instances_vbo);
+        glBindBuffer(GL_ARRAY_BUFFER, m_instances_vbo);
+        for (const InstanceAttribute& attribute : m_attributes) {
+            glEnableVertexAttribArray(attribute.location);
+            glVertexAttribDivisor(attribute.location, 1);
+        }
+        setFirstInstance(0);
+
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindVertexArray(0);
+    }
+
+    /* Delete the buffers and the vertex array */
+    InstancedQuads::~InstancedQuads() {
+        glDeleteBuffers(1, &m_quad_vbo);
+        glDeleteBuffers(1, &m_instances_vbo);
+        glDeleteVertexArrays(1, &m_vao);
+    }
+
+    /* Orphan the instance buffer */
+    void InstancedQuads::orphan(const size_t instancesCount) {
+        glBindBuffer(GL_ARRAY_BUFFER, m_instances_vbo);
+        if (instancesCount > m_instancesCapacity) {
+            m_instancesCapacity = std::max(instancesCount, m_instancesCapacity * 2);
+        }
+        glBufferData(GL_ARRAY_BUFFER, m_instancesCapacity * m_instanceSize, nullptr, GL_STREAM_DRAW);
+    }
+
+    /* Upload instances into the orphaned buffer */
+    void InstancedQuads::upload(const size_t firstInstance, const void* pInstances, const size_t instancesCount) const {
+        glBufferSubData(GL_ARRAY_BUFFER, firstInstance * m_instanceSize, instancesCount * m_instanceSize, pInstances);
+    }
+
+    /* Bind the vertex array and the instance buffer */
+    void InstancedQuads::bind() const {
+        glBindVertexArray(m_vao);
+        glBindBuffer(GL_ARRAY_BUFFER, m_instances_vbo);
+    }
+
+    /* Draw instances starting at the index */
+    void InstancedQuads::draw(const size_t firstInstance, const size_t instancesCount) {
+        if (firstInstance != m_firstInstance) {
+            setFirstInstance(firstInstance);
+        }
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(instancesCount));
+    }
+
+    /* Unbind the vertex array and the instance buffer */
+    void InstancedQuads::unbind() const {
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    /* Point the instance attributes at the instance. The instance buffer must be bound */
+    void InstancedQuads::setFirstInstance(const size_t firstInstance) {
+        for (const InstanceAttribute& attribute : m_attributes) {
+            glVertexAttribPointer(attribute.location, attribute.componentsCount, attribute.type, attribute.isNormalized,
+                                  static_cast<GLsizei>(m_instanceSize), reinterpret_cast<const void*>(firstInstance * m_instanceSize + attribute.offset));
+        }
+        m_firstInstance = firstInstance;
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/vec4.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+namespace Renderer {
+    /* Pack a color with components in [0, 1] into RGBA8 */
+    uint32_t packColor(const glm::vec4& color);
+
+    /*
+    Create a buffer with the unit quad drawn as a triangle strip of 4 vertices,
+    its corners are also the interpolation factors of the UV rectangle
+    */
+    GLuint createUnitQuadBuffer();
+    /* Feed the unit quad to attribute 0 (vec2) of the bound vertex array. The quad buffer stays bound */
+    void setUnitQuadAttribute(const GLuint quadBuffer);
+
+    /* Vertex attribute read once per instance */
+    struct InstanceAttribute {
+        GLuint location;
+        GLint componentsCount;
+        GLenum type;
+        GLboolean isNormalized;
+        size_t offset;          // Offset of the attribute in the instance
+    };
+
+    /*
+    Instanced unit quads: the quad buffer, a stream buffer of instances and the vertex array that reads them.
+    Instances of several draws go into one buffer, which is orphaned every frame so the driver does not wait for the previous draws
+    */
+    class InstancedQuads {
+    public:
+        /* Create the buffers and the vertex array for instances of instanceSize bytes with the attributes */
+        InstancedQuads(const size_t instanceSize, std::initializer_list <InstanceAttribute> attributes);
+
+        /* Delete the buffers and the vertex array */
+        ~InstancedQuads();
+
+        /* Prohibit copying of instanced quads objects */
+        InstancedQuads(const InstancedQuads&) = delete;
+        InstancedQuads& operator = (const InstancedQuads&) = delete;
+
+        /* Orphan the instance buffer with room for at least instancesCount instances and leave it bound to GL_ARRAY_BUFFER */
+        void orphan(const size_t instancesCount);
+        /* Upload instances into the orphaned buffer, starting at the instance index */
+        void upload(const size_t firstInstance, const void* pInstances, const size_t instancesCount) const;
+
+        /* Bind the vertex array and the instance buffer for drawing */
+        void bind() const;
+        /* Draw instances starting at the index, the vertex array must be bound */
+        void draw(const size_t firstInstance, const size_t instancesCount);
+        /* Unbind the vertex array and the instance buffer */
+        void unbind() const;
+
+    private:
+        /* Point the instance attributes at the instance, which stands in for the base instance GL 3.3 does not have */
+        void setFirstInstance(const size_t firstInstance);
+
+        size_t m_instanceSize = 0;
+        std::vector <InstanceAttribute> m_attributes;
+        GLuint m_vao = 0;
+        GLuint m_quad_vbo = 0;
+        GLuint m_instances_vbo = 0;
+        size_t m_instancesCapacity = 0;
+        size_t m_firstInstance = 0;     // Instance the attributes of the vertex array point at
+    };
+}
@@ -0,0 +1,253 @@
+#include "LayerStack.h"
+#include "ShaderProgram.h"
+#include "Texture2D.h"
+
+#include <glm/common.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <iostream>
+
+namespace Renderer {
+    namespace {
+        /* Projection of a pixel-aligned rectangle of the world onto a viewport of the same size */
+        glm::mat4 pixelProjection(const glm::ivec2& origin, const glm::ivec2& size) {
+            return glm::ortho(static_cast<float>(origin.x), static_cast<float>(origin.x + size.x),
+                              static_cast<float>(origin.y), static_cast<float>(origin.y + size.y), -100.f, 100.f);
+        }
+
+        size_t area(const glm::ivec2& min, const glm::ivec2& max) {
+            const glm::ivec2 size = glm::max(max - min, glm::ivec2(0));
+            return static_cast<size_t>(size.x) * size.y;
+        }
+    }
+
+    /* Create an empty stack */
+    LayerStack::LayerStack(std::shared_ptr <ShaderProgram> pCompositeShaderProgram, const glm::ivec2& viewportSize, const int cacheMargin)
+        : m_pCompositeShaderProgram(std::move(pCompositeShaderProgram))
+        , m_viewportSize(glm::max(viewportSize, glm::ivec2(1)))
+        , m_cacheMargin(std::max(cacheMargin, 0)) {
+        m_pCompositeShaderProgram->use();
+        m_pCompositeShaderProgram->setTexture("tex", 0);
+        m_cacheOffsetLocation = m_pCompositeShaderProgram->getUniformLocation("cacheOffset");
+
+        /* Unit quad drawn as a triangle strip, the vertex shader stretches it over the viewport */
+        const GLfloat quadCoords[] = {
+            0.f, 0.f,
+            1.f, 0.f,
+            0.f, 1.f,
+            1.f, 1.f
+        };
+        glGenBuffers(1, &m_quad_vbo);
+        glBindBuffer(GL_ARRAY_BUFFER, m_quad_vbo);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(quadCoords), quadCoords, GL_STATIC_DRAW);
+        glGenVertexArrays(1, &m_vao);
+        glBindVertexArray(m_vao);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    /* Delete the caches */
+    LayerStack::~LayerStack() {
+        for (Layer& layer : m_layers) {
+            deleteCache(layer);
+        }
+        glDeleteVertexArrays(1, &m_vao);
+        glDeleteBuffers(1, &m_quad_vbo);
+    }
+
+    /* Add a layer on top of the others */
+    size_t LayerStack::addLayer(DrawFunction drawFunction, const bool isStatic) {
+        m_layers.emplace_back();
+        m_layers.back().drawFunction = std::move(drawFunction);
+        setStatic(m_layers.size() - 1, isStatic);
+        return m_layers.size() - 1;
+    }
+
+    /* Make a layer static or dynamic */
+    void LayerStack::setStatic(const size_t layerIndex, const bool isStatic) {
+        Layer& layer = m_layers[layerIndex];
+        if (layer.isStatic == isStatic) {
+            return;
+        }
+        layer.isStatic = isStatic;
+        if (isStatic) {
+            createCache(layer);
+        }
+        else {
+            deleteCache(layer);
+        }
+    }
+
+    /* Redraw a rectangle of a static layer on the next render() */
+    void LayerStack::invalidate(const size_t layerIndex, const glm::vec2& min, const glm::vec2& max) {
+        Layer& layer = m_layers[layerIndex];
+        if (!layer.isStatic || !layer.isCacheValid) {
+            return;
+        }
+        /* Pixels touched by the rectangle, in the cache */
+        const glm::ivec2 dirtyMin = glm::max(glm::ivec2(glm::floor(min)) - layer.cacheOrigin, glm::ivec2(0));
+        const glm::ivec2 dirtyMax = glm::min(glm::ivec2(glm::ceil(max)) - layer.cacheOrigin, cacheSize());
+        if (dirtyMin.x >= dirtyMax.x || dirtyMin.y >= dirtyMax.y) {
+            return;
+        }
+        const bool isDirty = layer.dirtyMin.x < layer.dirtyMax.x && layer.dirtyMin.y < layer.dirtyMax.y;
+        layer.dirtyMin = isDirty ? glm::min(layer.dirtyMin, dirtyMin) : dirtyMin;
+        layer.dirtyMax = isDirty ? glm::max(layer.dirtyMax, dirtyMax) : dirtyMax;
+    }
+
+    /* Redraw a whole static layer on the next render() */
+    void LayerStack::invalidateAll(const size_t layerIndex) {
+        m_layers[layerIndex].isCacheValid = false;
+    }
+
+    /* Change the size of the viewport */
+    void LayerStack::setViewportSize(const glm::ivec2& viewportSize) {
+        const glm::ivec2 newViewportSize = glm::max(viewportSize, glm::ivec2(1));
+        if (newViewportSize == m_viewportSize) {
+            return;
+        }
+        m_viewportSize = newViewportSize;
+        for (Layer& layer : m_layers) {
+            if (layer.isStatic) {
+                deleteCache(layer);
+                createCache(layer);
+            }
+        }
+    }
+
+    /* Draw the layers bottom to top */
+    void LayerStack::render(const glm::vec2& cameraPosition) {
+        m_lastFrame = FrameStatistics();
+        const glm::ivec2 camera(glm::round(cameraPosition));
+        const glm::mat4 projectionMatrix = pixelProjection(camera, m_viewportSize);
+        const size_t viewportArea = static_cast<size_t>(m_viewportSize.x) * m_viewportSize.y;
+
+        for (size_t i = 0; i < m_layers.size(); ++i) {
+            Layer& layer = m_layers[i];
+            if (!layer.isStatic) {
+                m_lastFrame.drawCalls += layer.drawFunction(projectionMatrix);
+                continue;
+            }
+
+            /* The cache is redrawn around the camera when the camera leaves the margin, otherwise only its dirty pixels */
+            const bool isBottom = i == 0;
+            glm::ivec2 offset = camera - layer.cacheOrigin;
+            unsigned int drawCalls = 0;
+            size_t redrawnPixels = 0;
+            if (!layer.isCacheValid || glm::any(glm::lessThan(offset, glm::ivec2(0))) || glm::any(glm::greaterThan(offset, glm::ivec2(2 * m_cacheMargin)))) {
+                layer.cacheOrigin = camera - m_cacheMargin;
+                offset = camera - layer.cacheOrigin;
+                drawCalls = redrawCache(layer, glm::ivec2(0), cacheSize(), isBottom);
+                layer.drawCalls = drawCalls;
+                layer.isCacheValid = true;
+                redrawnPixels = area(glm::ivec2(0), cacheSize());
+            }
+            else if (layer.dirtyMin.x < layer.dirtyMax.x && layer.dirtyMin.y < layer.dirtyMax.y) {
+                drawCalls = redrawCache(layer, layer.dirtyMin, layer.dirtyMax, isBottom);
+                redrawnPixels = area(layer.dirtyMin, layer.dirtyMax);
+            }
+            layer.dirtyMin = layer.dirtyMax = glm::ivec2(0);
+            if (redrawnPixels != 0) {
+                ++m_lastFrame.redrawnLayers;
+                m_lastFrame.redrawnPixels += redrawnPixels;
+            }
+
+            /* Cache pixels map one to one to the viewport pixels, moved by the camera offset inside the margin */
+            m_pCompositeShaderProgram->use();
+            glUniform2i(m_cacheOffsetLocation, offset.x, offset.y);
+            glActiveTexture(GL_TEXTURE0);
+            layer.pCache->bind();
+            if (!isBottom) {
+                glEnable(GL_BLEND);
+                glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+            }
+            glBindVertexArray(m_vao);
+            glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+            glBindVertexArray(0);
+            glDisable(GL_BLEND);
+            glBindTexture(GL_TEXTURE_2D, 0);
+
+            m_lastFrame.drawCalls += drawCalls + 1;
+            m_lastFrame.savedDrawCalls += layer.drawCalls > drawCalls + 1 ? layer.drawCalls - drawCalls - 1 : 0;
+            m_lastFrame.cachedPixels += viewportArea > redrawnPixels ? viewportArea - redrawnPixels : 0;
+        }
+    }
+
+    /* Video memory used by the caches */
+    size_t LayerStack::gpuSizeInBytes() const {
+        size_t sizeInBytes = 0;
+        for (const Layer& layer : m_layers) {
+            if (layer.pCache) {
+                sizeInBytes += layer.pCache->imageSizeInBytes();
+            }
+        }
+        return sizeInBytes;
+    }
+
+    /* Create the cache of a layer: a texture with the viewport and the margin, attached to a framebuffer */
+    void LayerStack::createCache(Layer& layer) {
+        const glm::ivec2 size = cacheSize();
+        layer.pCache = std::make_shared<Texture2D>(size.x, size.y, nullptr, 4, GL_NEAREST);
+        layer.isCacheValid = false;
+
+        GLint previousFramebuffer = 0;
+        glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+        glGenFramebuffers(1, &layer.framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, layer.framebuffer);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, layer.pCache->id(), 0);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            std::cerr << "Layer cache framebuffer of " << size.x << "x" << size.y << " is incomplete" << std::endl;
+        }
+        glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(previousFramebuffer));
+    }
+
+    /* Delete the cache of a layer */
+    void LayerStack::deleteCache(Layer& layer) {
+        glDeleteFramebuffers(1, &layer.framebuffer);
+        layer.framebuffer = 0;
+        layer.pCache.reset();
+        layer.isCacheValid = false;
+    }
+
+    /* Redraw the pixels [min, max) of the cache of a layer */
+    unsigned int LayerStack::redrawCache(Layer& layer, const glm::ivec2& min, const glm::ivec2& max, const bool isBottom) {
+        GLint previousFramebuffer = 0;
+        GLint previousViewport[4];
+        GLint previousScissorBox[4];
+        glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+        glGetIntegerv(GL_VIEWPORT, previousViewport);
+        glGetIntegerv(GL_SCISSOR_BOX, previousScissorBox);
+        const GLboolean isScissorEnabled = glIsEnabled(GL_SCISSOR_TEST);
+
+        const glm::ivec2 size = cacheSize();
+        glBindFramebuffer(GL_FRAMEBUFFER, layer.framebuffer);
+        glViewport(0, 0, size.x, size.y);
+        /* The scissor keeps the fill cost to the redrawn pixels, the layer still issues all of its draw calls */
+        glEnable(GL_SCISSOR_TEST);
+        glScissor(min.x, min.y, max.x - min.x, max.y - min.y);
+        /* The bottom layer is cached over the clear color of the frame, the others over transparent pixels */
+        if (isBottom) {
+            glClear(GL_COLOR_BUFFER_BIT);
+        }
+        else {
+            GLfloat clearColor[4];
+            glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColor);
+            glClearColor(0.f, 0.f, 0.f, 0.f);
+            glClear(GL_COLOR_BUFFER_BIT);
+            glClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
+        }
+        const unsigned int drawCalls = layer.drawFunction(pixelProjection(layer.cacheOrigin, size));
+
+        /* The caller may be drawing with its own scissor */
+        if (!isScissorEnabled) {
+            glDisable(GL_SCISSOR_TEST);
+        }
+        glScissor(previousScissorBox[0], previousScissorBox[1], previousScissorBox[2], previousScissorBox[3]);
+        glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(previousFramebuffer));
+        glViewport(previousViewport[0], previousViewport[1], previousViewport[2], previousViewport[3]);
+        return drawCalls;
+    }
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/vec2.hpp>
+#include <glm/mat4x4.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace Renderer {
+    class ShaderProgram;
+    class Texture2D;
+
+    /*
+    Ordered layers of a frame seen through a pixel-aligned 2D camera (one world unit per pixel).
+    Dynamic layers are drawn every frame. A static layer is drawn into a framebuffer-backed Texture2D that covers
+    the viewport and a margin around it, and the frame gets it with one full-screen quad. The cache is redrawn
+    only inside invalidated rectangles, or entirely when the camera moves out of the margin.
+    A static bottom layer is cached over the clear color and replaces it, static layers above others are
+    composited with premultiplied alpha, which is exact for opaque and alpha-tested content
+    */
+    class LayerStack {
+    public:
+        /* Draw the content of a layer with the projection matrix and return the number of draw calls */
+        typedef std::function<unsigned int(const glm::mat4& projectionMatrix)> DrawFunction;
+
+        /* Work done and saved by the last render() */
+        struct FrameStatistics {
+            unsigned int drawCalls = 0;         // Draw calls of dynamic layers, cache redraws and composites
+            unsigned int savedDrawCalls = 0;    // Draw calls static layers would have made without their caches
+            unsigned int redrawnLayers = 0;     // Static layers whose cache was redrawn (in part or entirely)
+            size_t redrawnPixels = 0;           // Cache pixels redrawn
+            size_t cachedPixels = 0;            // Pixels of static layers that came from the caches without redrawing
+        };
+
+        /*
+        Create an empty stack. The composite shader program must read the tex sampler at gl_FragCoord
+        moved by the cacheOffset uniform (see res/shaders/fLayerComposite_shader.txt)
+        */
+        LayerStack(std::shared_ptr <ShaderProgram> pCompositeShaderProgram, const glm::ivec2& viewportSize, const int cacheMargin = 64);
+
+        /* Delete the caches */
+        ~LayerStack();
+
+        /* Prohibit copying of layer stack objects */
+        LayerStack(const LayerStack&) = delete;
+        LayerStack& operator = (const LayerStack&) = delete;
+
+        /* Add a layer on top of the others and return its index */
+        size_t addLayer(DrawFunction drawFunction, const bool isStatic = false);
+        /* Make a layer static (cached) or dynamic. A layer made static is drawn into its cache on the next render() */
+        void setStatic(const size_t layer, const bool isStatic);
+        bool isStatic(const size_t layer) const { return m_layers[layer].isStatic; }
+        size_t layersCount() const { return m_layers.size(); }
+
+        /* Redraw a rectangle of a static layer (world coordinates) on the next render() */
+        void invalidate(const size_t layer, const glm::vec2& min, const glm::vec2& max);
+        /* Redraw a whole static layer on the next render() */
+        void invalidateAll(const size_t layer);
+
+        /* Change the size of the viewport, the caches are recreated */
+        void setViewportSize(const glm::ivec2& viewportSize);
+        const glm::ivec2& viewportSize() const { return m_viewportSize; }
+
+        /*
+        Draw the layers bottom to top into the current framebuffer with the lower left corner of the viewport at the camera
+        position (rounded to whole pixels). Caches are redrawn first where they are invalid
+        */
+        void render(const glm::vec2& cameraPosition);
+
+        const FrameStatistics& lastFrame() const { return m_lastFrame; }
+        /* Video memory used by the caches */
+        size_t gpuSizeInBytes() const;
+
+    private:
+        struct Layer {
+            DrawFunction drawFunction;
+            bool isStatic = false;
+
+            /* Cache of a static layer */
+            std::shared_ptr <Texture2D> pCache;
+            GLuint framebuffer = 0;
+            glm::ivec2 cacheOrigin = glm::ivec2(0);     // World position of the lower left pixel of the cache
+            bool isCacheValid = false;
+            glm::ivec2 dirtyMin = glm::ivec2(0);        // Invalid pixels of the cache, max exclusive
+            glm::ivec2 dirtyMax = glm::ivec2(0);
+            unsigned int drawCalls = 0;                 // Draw calls of the last redraw of the whole layer
+        };
+
+        /* Create or delete the cache of a layer */
+        void createCache(Layer& layer);
+        void deleteCache(Layer& layer);
+        /* Redraw the pixels [min, max) of the cache of a layer and return the number of draw calls */
+        unsigned int redrawCache(Layer& layer, const glm::ivec2& min, const glm::ivec2& max, const bool isBottom);
+        glm::ivec2 cacheSize() const { return m_viewportSize + 2 * m_cacheMargin; }
+
+        std::shared_ptr <ShaderProgram> m_pCompositeShaderProgram;
+        GLint m_cacheOffsetLocation = -1;
+        glm::ivec2 m_viewportSize;
+        int m_cacheMargin;
+        std::vector <Layer> m_layers;
+        FrameStatistics m_lastFrame;
+
+        GLuint m_quad_vbo = 0;
+        GLuint m_vao = 0;
+    };
+}
@@ -0,0 +1,235 @@
+#include "ParticleEmitter.h"
+#include "ShaderProgram.h"
+#include "../System/JobSystem.h"
+
+#include <glm/trigonometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+
+/* SSE2 is part of x86-64, other targets use the scalar loops */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PARTICLES_USE_SSE2
+#endif
+
+namespace Renderer {
+    namespace {
+        /* Smaller ranges run on the calling thread, so small emitters do not pay for the job system */
+        const size_t MIN_PARTICLES_PER_JOB = 16384;
+    }
+
+    /* Create the quad and instance buffers */
+    ParticleEmitter::ParticleEmitter(std::shared_ptr <Texture2D> pTexture,
+                                     const Texture2D::SubTextureId subTextureId,
+                                     std::shared_ptr <ShaderProgram> pShaderProgram,
+                                     const ParticleEmitterSettings& settings)
+        : m_pTexture(std::move(pTexture))
+        , m_pShaderProgram(std::move(pShaderProgram))
+        , m_subTextureId(subTextureId)
+        , m_settings(settings)
+        , m_quads(sizeof(Instance), {
+            { 1, 3, GL_FLOAT, GL_FALSE, offsetof(Instance, x) },
+            { 2, 4, GL_UNSIGNED_BYTE, GL_TRUE, offsetof(Instance, color) } }) {
+        m_uvRectLocation = m_pShaderProgram->getUniformLocation("uvRect");
+
+        /* The particle budget is allocated up front, so spawning does not allocate */
+        for (std::vector <float>* pArray : { &m_positionsX, &m_positionsY, &m_velocitiesX, &m_velocitiesY, &m_ages, &m_inverseLifetimes }) {
+            pArray->reserve(m_settings.maxParticles);
+        }
+    }
+
+    /* Uniform random number in [min, max) (xorshift, cheap enough to call per spawned particle) */
+    float ParticleEmitter::random(const float min, const float max) {
+        m_randomState ^= m_randomState << 13;
+        m_randomState ^= m_randomState >> 17;
+        m_randomState ^= m_randomState << 5;
+        return min + (max - min) * static_cast<float>(m_randomState >> 8) * (1.f / 16777216.f);
+    }
+
+    /* Spawn a burst of particles */
+    void ParticleEmitter::emit(const size_t count) {
+        const size_t first = size();
+        const size_t spawnCount = std::min(count, m_settings.maxParticles > first ? m_settings.maxParticles - first : 0);
+        const size_t newSize = first + spawnCount;
+        for (std::vector <float>* pArray : { &m_positionsX, &m_positionsY, &m_velocitiesX, &m_velocitiesY, &m_ages, &m_inverseLifetimes }) {
+            pArray->resize(newSize);
+        }
+
+        for (size_t i = first; i < newSize; ++i) {
+            const float angle = glm::radians(m_settings.direction + random(-m_settings.directionSpread, m_settings.directionSpread));
+            const float speed = random(m_settings.minSpeed, m_settings.maxSpeed);
+            m_positionsX[i] = m_settings.position.x + random(-m_settings.positionSpread.x, m_settings.positionSpread.x);
+            m_positionsY[i] = m_settings.position.y + random(-m_settings.positionSpread.y, m_settings.positionSpread.y);
+            m_velocitiesX[i] = std::cos(angle) * speed;
+            m_velocitiesY[i] = std::sin(angle) * speed;
+            m_ages[i] = 0.f;
+            m_inverseLifetimes[i] = 1.f / std::max(random(m_settings.minLifetime, m_settings.maxLifetime), 0.001f);
+        }
+    }
+
+    /* Spawn, advance and remove dead particles */
+    void ParticleEmitter::update(const float deltaTime) {
+        /* Advance the existing particles, the integration is split between the worker threads */
+        if (!m_positionsX.empty()) {
+            const float dragFactor = std::exp(-m_settings.drag * deltaTime);
+            System::JobSystem::instance().parallelFor(size(), MIN_PARTICLES_PER_JOB, [this, deltaTime, dragFactor](const size_t begin, const size_t end) {
+                simulate(begin, end, deltaTime, dragFactor);
+            });
+            removeDead();
+        }
+
+        /* Spawn new particles, fractions of a particle accumulate between updates */
+        m_spawnRemainder += m_settings.spawnRate * deltaTime;
+        const float spawnCount = std::floor(m_spawnRemainder);
+        m_spawnRemainder -= spawnCount;
+        emit(static_cast<size_t>(spawnCount));
+    }
+
+    /* Integrate the particles in [begin, end) */
+    void ParticleEmitter::simulate(const size_t begin, const size_t end, const float deltaTime, const float dragFactor) {
+        float* positionsX = m_positionsX.data();
+        float* positionsY = m_positionsY.data();
+        float* velocitiesX = m_velocitiesX.data();
+        float* velocitiesY = m_velocitiesY.data();
+        float* ages = m_ages.data();
+        const float gravityX = m_settings.gravity.x * deltaTime;
+        const float gravityY = m_settings.gravity.y * deltaTime;
+
+        size_t i = begin;
+#ifdef PARTICLES_USE_SSE2
+        const __m128 deltaTime4 = _mm_set1_ps(deltaTime);
+        const __m128 dragFactor4 = _mm_set1_ps(dragFactor);
+        const __m128 gravityX4 = _mm_set1_ps(gravityX);
+        const __m128 gravityY4 = _mm_set1_ps(gravityY);
+        for (; i + 4 <= end; i += 4) {
+            const __m128 velocityX = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(velocitiesX + i), dragFactor4), gravityX4);
+            const __m128 velocityY = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(velocitiesY + i), dragFactor4), gravityY4);
+            _mm_storeu_ps(velocitiesX + i, velocityX);
+            _mm_storeu_ps(velocitiesY + i, velocityY);
+            _mm_storeu_ps(positionsX + i, _mm_add_ps(_mm_loadu_ps(positionsX + i), _mm_mul_ps(velocityX, deltaTime4)));
+            _mm_storeu_ps(positionsY + i, _mm_add_ps(_mm_loadu_ps(positionsY + i), _mm_mul_ps(velocityY, deltaTime4)));
+            _mm_storeu_ps(ages + i, _mm_add_ps(_mm_loadu_ps(ages + i), deltaTime4));
+        }
+#endif
+        for (; i < end; ++i) {
+            velocitiesX[i] = velocitiesX[i] * dragFactor + gravityX;
+            velocitiesY[i] = velocitiesY[i] * dragFactor + gravityY;
+            positionsX[i] += velocitiesX[i] * deltaTime;
+            positionsY[i] += velocitiesY[i] * deltaTime;
+            ages[i] += deltaTime;
+        }
+    }
+
+    /* Swap-remove particles that outlived their lifetime */
+    void ParticleEmitter::removeDead() {
+        size_t count = size();
+        size_t i = 0;
+        while (i < count) {
+            if (m_ages[i] * m_inverseLifetimes[i] < 1.f) {
+                ++i;
+                continue;
+            }
+            /* The last particle takes the place of the dead one and is checked on the next iteration */
+            --count;
+            m_positionsX[i] = m_positionsX[count];
+            m_positionsY[i] = m_positionsY[count];
+            m_velocitiesX[i] = m_velocitiesX[count];
+            m_velocitiesY[i] = m_velocitiesY[count];
+            m_ages[i] = m_ages[count];
+            m_inverseLifetimes[i] = m_inverseLifetimes[count];
+        }
+        for (std::vector <float>* pArray : { &m_positionsX, &m_positionsY, &m_velocitiesX, &m_velocitiesY, &m_ages, &m_inverseLifetimes }) {
+            pArray->resize(count);
+        }
+    }
+
+    /* Write instances of the particles in [begin, end): size and color are interpolated by the normalized age */
+    void ParticleEmitter::writeInstances(const size_t begin, const size_t end, Instance* instances) const {
+        const ParticleEmitterSettings& settings = m_settings;
+        const glm::vec4 colorChange = settings.endColor - settings.startColor;
+        const float sizeChange = settings.endSize - settings.startSize;
+
+        size_t i = begin;
+#ifdef PARTICLES_USE_SSE2
+        const __m128 one = _mm_set1_ps(1.f);
+        const __m128 half = _mm_set1_ps(0.5f);
+        const __m128 startSize = _mm_set1_ps(settings.startSize);
+        const __m128 sizeChange4 = _mm_set1_ps(sizeChange);
+        /* Colors are scaled to [0, 255] up front, so a channel is one multiply-add and a conversion */
+        const __m128 startColor[4] = { _mm_set1_ps(settings.startColor.r * 255.f), _mm_set1_ps(settings.startColor.g * 255.f),
+                                       _mm_set1_ps(settings.startColor.b * 255.f), _mm_set1_ps(settings.startColor.a * 255.f) };
+        const __m128 colorChange4[4] = { _mm_set1_ps(colorChange.r * 255.f), _mm_set1_ps(colorChange.g * 255.f),
+                                         _mm_set1_ps(colorChange.b * 255.f), _mm_set1_ps(colorChange.a * 255.f) };
+        for (; i + 4 <= end; i += 4) {
+            const __m128 t = _mm_min_ps(_mm_mul_ps(_mm_loadu_ps(m_ages.data() + i), _mm_loadu_ps(m_inverseLifetimes.data() + i)), one);
+            __m128 size = _mm_add_ps(startSize, _mm_mul_ps(t, sizeChange4));
+            __m128 x = _mm_sub_ps(_mm_loadu_ps(m_positionsX.data() + i), _mm_mul_ps(size, half));
+            __m128 y = _mm_sub_ps(_mm_loadu_ps(m_positionsY.data() + i), _mm_mul_ps(size, half));
+            __m128i color = _mm_setzero_si128();
+            for (int channel = 0; channel < 4; ++channel) {
+                const __m128i value = _mm_cvtps_epi32(_mm_add_ps(startColor[channel], _mm_mul_ps(t, colorChange4[channel])));
+                color = _mm_or_si128(color, _mm_slli_epi32(value, channel * 8));
+            }
+            /* Structure of arrays to array of instances: x, y, size and color of four particles form a 4x4 matrix */
+            __m128 packedColor = _mm_castsi128_ps(color);
+            _MM_TRANSPOSE4_PS(x, y, size, packedColor);
+            float* pOut = reinterpret_cast<float*>(instances + (i - begin));
+            _mm_storeu_ps(pOut, x);
+            _mm_storeu_ps(pOut + 4, y);
+            _mm_storeu_ps(pOut + 8, size);
+            _mm_storeu_ps(pOut + 12, packedColor);
+        }
+#endif
+        for (; i < end; ++i) {
+            const float t = std::min(m_ages[i] * m_inverseLifetimes[i], 1.f);
+            const float size = settings.startSize + t * sizeChange;
+            Instance& instance = instances[i - begin];
+            instance.x = m_positionsX[i] - 0.5f * size;
+            instance.y = m_positionsY[i] - 0.5f * size;
+            instance.size = size;
+            instance.color = packColor(settings.startColor + t * colorChange);
+        }
+    }
+
+    /* Upload the particles and draw them */
+    void ParticleEmitter::render() {
+        const size_t count = size();
+        if (count == 0) {
+            return;
+        }
+
+        /* The buffer is orphaned every frame and the instances are written straight into the mapping by the workers */
+        m_quads.orphan(count);
+        Instance* instances = static_cast<Instance*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, count * sizeof(Instance), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+        if (!instances) {
+            std::cerr << "Can not map the particle instance buffer" << std::endl;
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            return;
+        }
+        System::JobSystem::instance().parallelFor(count, MIN_PARTICLES_PER_JOB, [this, instances](const size_t begin, const size_t end) {
+            writeInstances(begin, end, instances + begin);
+        });
+        /* The contents are undefined if the mapping was lost, the particles are skipped for this frame then */
+        const bool isUploaded = glUnmapBuffer(GL_ARRAY_BUFFER) == GL_TRUE;
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        if (!isUploaded) {
+            return;
+        }
+
+        const Texture2D::SubTexture2D subTexture = m_pTexture->getSubTexture(m_subTextureId);
+        m_pShaderProgram->use();
+        glUniform4f(m_uvRectLocation, subTexture.leftBottomUV.x, subTexture.leftBottomUV.y, subTexture.rightTopUV.x, subTexture.rightTopUV.y);
+        glActiveTexture(GL_TEXTURE0);
+        m_pTexture->bind();
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        m_quads.bind();
+        m_quads.draw(0, count);
+        m_quads.unbind();
+        glDisable(GL_BLEND);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+}
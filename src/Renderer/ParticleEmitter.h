@@ -0,0 +1,103 @@
+#pragma once
+
+#include "InstancedQuads.h"
+#include "Texture2D.h"
+
+#include <glad/glad.h>
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Renderer {
+    class ShaderProgram;
+
+    /* Parameters of the particles spawned by an emitter */
+    struct ParticleEmitterSettings {
+        glm::vec2 position = glm::vec2(0.f);        // Spawn point
+        glm::vec2 positionSpread = glm::vec2(0.f);  // Particles spawn within +-spread of the spawn point
+        float spawnRate = 0.f;                      // Particles per second spawned by update()
+        float direction = 90.f;                     // Mean direction of the start velocity in degrees
+        float directionSpread = 180.f;              // Start velocities deviate from the direction by up to +-spread degrees
+        float minSpeed = 0.f;
+        float maxSpeed = 100.f;
+        float minLifetime = 1.f;                    // Lifetime in seconds
+        float maxLifetime = 1.f;
+        glm::vec2 gravity = glm::vec2(0.f);         // Acceleration
+        float drag = 0.f;                           // Fraction of the velocity lost per second (exponential decay rate)
+        float startSize = 8.f;                      // Size and color are interpolated over the lifetime
+        float endSize = 8.f;
+        glm::vec4 startColor = glm::vec4(1.f);
+        glm::vec4 endColor = glm::vec4(1.f, 1.f, 1.f, 0.f);
+        size_t maxParticles = 100000;               // Spawning stops while this many particles are alive
+    };
+
+    /*
+    CPU particle emitter. Particles are stored as structure of arrays and simulated with SIMD on the job system,
+    dead particles are removed by swapping the last particle into their place. All particles are written
+    into one instance buffer per frame and drawn with one instanced draw call with a subtexture of the atlas
+    */
+    class ParticleEmitter {
+    public:
+        /* Per-instance vertex attributes, computed from the particle state when rendering */
+        struct Instance {
+            float x;        // Position of the lower left corner
+            float y;
+            float size;
+            uint32_t color; // RGBA8
+        };
+
+        /* Create the quad and instance buffers. The shader program must have projectionMat and uvRect uniforms */
+        ParticleEmitter(std::shared_ptr <Texture2D> pTexture,
+                        const Texture2D::SubTextureId subTextureId,
+                        std::shared_ptr <ShaderProgram> pShaderProgram,
+                        const ParticleEmitterSettings& settings);
+
+        /* Prohibit copying of particle emitter objects */
+        ParticleEmitter(const ParticleEmitter&) = delete;
+        ParticleEmitter& operator = (const ParticleEmitter&) = delete;
+
+        /* Spawn a burst of particles (as many as fit under maxParticles) */
+        void emit(const size_t count);
+        /* Spawn particles at the spawn rate, advance all particles and remove the dead ones */
+        void update(const float deltaTime);
+        /* Upload the particles into the instance buffer and draw them with alpha blending */
+        void render();
+
+        ParticleEmitterSettings& settings() { return m_settings; }
+        const ParticleEmitterSettings& settings() const { return m_settings; }
+        /* Number of live particles */
+        size_t size() const { return m_positionsX.size(); }
+
+    private:
+        /* Integrate the particles in [begin, end) */
+        void simulate(const size_t begin, const size_t end, const float deltaTime, const float dragFactor);
+        /* Write instances of the particles in [begin, end) */
+        void writeInstances(const size_t begin, const size_t end, Instance* instances) const;
+        /* Swap-remove particles that outlived their lifetime */
+        void removeDead();
+        /* Uniform random number in [min, max) */
+        float random(const float min, const float max);
+
+        std::shared_ptr <Texture2D> m_pTexture;
+        std::shared_ptr <ShaderProgram> m_pShaderProgram;
+        Texture2D::SubTextureId m_subTextureId;
+        ParticleEmitterSettings m_settings;
+        GLint m_uvRectLocation = -1;
+
+        /* Particle state, one array per attribute so that SIMD lanes map to consecutive particles */
+        std::vector <float> m_positionsX;
+        std::vector <float> m_positionsY;
+        std::vector <float> m_velocitiesX;
+        std::vector <float> m_velocitiesY;
+        std::vector <float> m_ages;
+        std::vector <float> m_inverseLifetimes;
+
+        float m_spawnRemainder = 0.f;   // Fraction of a particle carried over to the next update
+        uint32_t m_randomState = 0x9E3779B9u;
+
+        InstancedQuads m_quads;
+    };
+}
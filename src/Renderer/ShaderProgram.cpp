@@ -3,20 +3,24 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include <iostream>
+#include <utility>
 
 namespace Renderer {
     /* Create a ready-to-use shader program */
-    ShaderProgram::ShaderProgram(const std::string& vertexShaderSource, const std::string& fragmentShaderSource) {
+    ShaderProgram::ShaderProgram(const std::string_view vertexShaderSource, 
+                                 const std::string_view fragmentShaderSource, 
+                                 const std::vector <std::string>& transformFeedbackVaryings)
+        : m_transformFeedbackVaryings(transformFeedbackVaryings) {
         /* Vertex shader initialization */
         GLuint vertexShaderID;
-        if (!initializeShader(vertexShaderSource.c_str(), GL_VERTEX_SHADER, vertexShaderID)) {
+        if (!initializeShader(vertexShaderSource, GL_VERTEX_SHADER, vertexShaderID)) {
             std::cerr << "Vertex shader compile time error" << std::endl;
             return;
         }
         
         /* Fragment shader initialization */
         GLuint fragmentShaderID;
-        if (!initializeShader(fragmentShaderSource.c_str(), GL_FRAGMENT_SHADER, fragmentShaderID)) {
+        if (!initializeShader(fragmentShaderSource, GL_FRAGMENT_SHADER, fragmentShaderID)) {
             std::cerr << "Fragment shader compile time error" << std::endl;
             glDeleteShader(vertexShaderID);     // Delete vertex shader in case of fragment shader compilation error
             return;
@@ -26,6 +30,14 @@ namespace Renderer {
         m_ID = glCreateProgram();       // Create a shader program object and return its unique ID
         glAttachShader(m_ID, vertexShaderID);       // Attach a vertex shader to the program object 
         glAttachShader(m_ID, fragmentShaderID);     // Attach a fragment shader to the program object
+        /* Outputs captured by transform feedback have to be declared before linking */
+        if (!transformFeedbackVaryings.empty()) {
+            std::vector <const GLchar*> varyings;
+            for (const std::string& varying : transformFeedbackVaryings) {
+                varyings.push_back(varying.c_str());
+            }
+            glTransformFeedbackVaryings(m_ID, static_cast<GLsizei>(varyings.size()), varyings.data(), GL_INTERLEAVED_ATTRIBS);
+        }
         glLinkProgram(m_ID);    // Link the program object
 
         /* Linking check */
@@ -53,11 +65,13 @@ namespace Renderer {
     }
 
     /* Initialize shader */
-    bool ShaderProgram::initializeShader(const std::string& sourceCode, const GLenum shaderType, GLuint& shaderID) {
+    bool ShaderProgram::initializeShader(const std::string_view sourceCode, const GLenum shaderType, GLuint& shaderID) {
         /* Shader initialization */
         shaderID = glCreateShader(shaderType);      // Create a shader object and return its unique ID
-        const char* C_stringSourceCode = sourceCode.c_str();    // Convert std::string to C-string
-        glShaderSource(shaderID, 1, &C_stringSourceCode, nullptr);      // Bind source code to the shader object
+        /* The source code is not null-terminated when it is a view into a resource pack, so pass its length explicitly */
+        const GLchar* sourceCodeData = sourceCode.data();
+        const GLint sourceCodeLength = static_cast<GLint>(sourceCode.size());
+        glShaderSource(shaderID, 1, &sourceCodeData, &sourceCodeLength);      // Bind source code to the shader object
         glCompileShader(shaderID);      // Compile source code
 
         /* Compilation check */
@@ -82,6 +96,7 @@ namespace Renderer {
         glDeleteProgram(m_ID);
         m_ID = shaderProgram.m_ID;
         m_isCompiled = shaderProgram.m_isCompiled;
+        m_transformFeedbackVaryings = std::move(shaderProgram.m_transformFeedbackVaryings);
 
         shaderProgram.m_ID = 0;
         shaderProgram.m_isCompiled = false;
@@ -89,16 +104,26 @@ namespace Renderer {
         return *this;
     }
     
+    /* Get the location of a uniform variable */
+    GLint ShaderProgram::getUniformLocation(const char* uniformName) const {
+        return glGetUniformLocation(m_ID, uniformName);
+    }
+
     /* Link a texture to a shader program */
-    void ShaderProgram::setTexture(const std::string& textureName, const GLint textureUnit) {
+    void ShaderProgram::setTexture(const char* textureName, const GLint textureUnit) {
         /* Get the location of the uniform variable and set its value */
-        glUniform1i(glGetUniformLocation(m_ID, textureName.c_str()), textureUnit);
+        glUniform1i(glGetUniformLocation(m_ID, textureName), textureUnit);
     }
 
     /* Link a matrix to a shader program */
-    void  ShaderProgram::setMatrix4(const std::string& matrixName, const glm::mat4& matrix) {
+    void  ShaderProgram::setMatrix4(const char* matrixName, const glm::mat4& matrix) {
         /* Get the location of the uniform variable and set its value */
-        glUniformMatrix4fv(glGetUniformLocation(m_ID, matrixName.c_str()), 1, GL_FALSE, glm::value_ptr(matrix));
+        glUniformMatrix4fv(glGetUniformLocation(m_ID, matrixName), 1, GL_FALSE, glm::value_ptr(matrix));
+    }
+
+    /* Link a matrix to a shader program by the uniform location */
+    void ShaderProgram::setMatrix4(const GLint matrixLocation, const glm::mat4& matrix) {
+        glUniformMatrix4fv(matrixLocation, 1, GL_FALSE, glm::value_ptr(matrix));
     }
 }
 
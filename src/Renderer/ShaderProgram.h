@@ -4,12 +4,19 @@
 #include <glm/mat4x4.hpp>
 
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace Renderer {
     class ShaderProgram {
     public:
-        /* Create a ready-to-use shader program */
-        ShaderProgram(const std::string& vertexShaderSource, const std::string& fragmentShaderSource);
+        /*
+        Create a ready-to-use shader program. Vertex shader outputs listed in transformFeedbackVaryings are captured
+        interleaved, in the listed order, into the buffer bound to GL_TRANSFORM_FEEDBACK_BUFFER binding 0
+        */
+        ShaderProgram(const std::string_view vertexShaderSource, 
+                      const std::string_view fragmentShaderSource, 
+                      const std::vector <std::string>& transformFeedbackVaryings = {});
 
         /* Delete a shader program */
         ~ShaderProgram();
@@ -18,14 +25,22 @@ namespace Renderer {
             return m_isCompiled;
         }
 
+        /* Vertex shader outputs captured by transform feedback, as requested at creation */
+        const std::vector <std::string>& transformFeedbackVaryings() const { return m_transformFeedbackVaryings; }
+
         /* Activate shader program (make it current) */
         void use() const;
         
+        /* Get the location of a uniform variable (look it up once and keep it for per-frame updates) */
+        GLint getUniformLocation(const char* uniformName) const;
+
         /* Link a texture to a shader program */
-        void setTexture(const std::string& textureName, const GLint textureUnit);
+        void setTexture(const char* textureName, const GLint textureUnit);
 
         /* Link a matrix to a shader program */
-        void setMatrix4(const std::string& matrixName, const glm::mat4& matrix);
+        void setMatrix4(const char* matrixName, const glm::mat4& matrix);
+        /* Link a matrix to a shader program by the uniform location */
+        void setMatrix4(const GLint matrixLocation, const glm::mat4& matrix);
         
         /*
         Overload assignment-operator-based moving of shader program objects.
@@ -36,8 +51,9 @@ namespace Renderer {
     private:
         bool m_isCompiled = false;
         GLuint m_ID = 0;
+        std::vector <std::string> m_transformFeedbackVaryings;
         
         /* Initialize shader */
-        bool initializeShader(const std::string& sourceCode, const GLenum shaderType, GLuint& shaderID);
+        bool initializeShader(const std::string_view sourceCode, const GLenum shaderType, GLuint& shaderID);
     }; 
 }
\ No newline at end of file
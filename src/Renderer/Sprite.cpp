@@ -1,5 +1,6 @@
 #include "Sprite.h"
 #include "ShaderProgram.h"
+#include "../System/AllocationTracker.h"
 #include "Texture2D.h"
 
 #include <glm/mat4x4.hpp>
@@ -18,7 +19,8 @@ namespace Renderer {
                    , m_pShaderProgram(std::move(pShaderProgram))
                    , m_position(position)
                    , m_size(size)
-                   , m_rotation(rotation) {
+                   , m_rotation(rotation)
+                   , m_modelMatrixLocation(m_pShaderProgram->getUniformLocation("modelMat")) {
         /* Array of vertex coordinates in local space */
         const GLfloat vertexCoords[] = {
             // 2--3   1
@@ -34,19 +36,6 @@ namespace Renderer {
             0.f, 0.f
         };
 
-        /* Get the subtexture by its name */
-        auto subTexture = pTexture->getSubTexture(std::move(initialSubTextureName));
-
-        /* Array of subtexture-to-vertex coordinate mapping */
-        const GLfloat textureCoords[] {
-            subTexture.leftBottomUV.x, subTexture.leftBottomUV.y,
-            subTexture.leftBottomUV.x, subTexture.rightTopUV.y,
-            subTexture.rightTopUV.x, subTexture.rightTopUV.y,
-
-            subTexture.rightTopUV.x, subTexture.rightTopUV.y, 
-            subTexture.rightTopUV.x, subTexture.leftBottomUV.y,
-            subTexture.leftBottomUV.x, subTexture.leftBottomUV.y
-        };
         
         /* Create a Vertex Array Object for vertex attriute state */
         glGenVertexArrays(1, &m_vao);   // Generate and return one unique identifier for a vertex array
@@ -56,15 +45,20 @@ namespace Renderer {
         glGenBuffers(1, &m_vertexCoords_vbo);   // Generate and return one unique identifier for a buffer
         glBindBuffer(GL_ARRAY_BUFFER, m_vertexCoords_vbo);  // Create a buffer of GL_ARRAY_BUFFER type, bind it to the ID & make current
         glBufferData(GL_ARRAY_BUFFER, sizeof(vertexCoords), vertexCoords, GL_STATIC_DRAW);  // Fill the buffer with data
+        m_buffersSizeInBytes += sizeof(vertexCoords);
 
         /* Configure the vertex shader to work with coordinates */
         glEnableVertexAttribArray(0);   // Enable use of vertex attribute with index 0 in the vertex array
         glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr); // Configure how the vertex shader interprets data
 
-        /* Create a Vertex Buffer Object with texture-to-vertex coordinate mappiing data in video card memory */
+        /* 
+        Create a Vertex Buffer Object for texture-to-vertex coordinate mappiing data in video card memory.
+        The buffer is only allocated here and filled by setSubTexture(), which also rewrites it when the frame changes
+        */
         glGenBuffers(1, &m_textureCoords_vbo);  // Generate and return one unique identifier for a buffer
         glBindBuffer(GL_ARRAY_BUFFER, m_textureCoords_vbo);  // Create a buffer of GL_ARRAY_BUFFER type, bind it to the ID & make current
-        glBufferData(GL_ARRAY_BUFFER, sizeof(textureCoords), textureCoords, GL_STATIC_DRAW);  // Fill the buffer with data 
+        glBufferData(GL_ARRAY_BUFFER, 12 * sizeof(GLfloat), nullptr, GL_DYNAMIC_DRAW);  // Allocate the buffer 
+        m_buffersSizeInBytes += 12 * sizeof(GLfloat);
 
         /* Configure the vertex shader to work with texture */
         glEnableVertexAttribArray(1);   // Enable use of vertex attribute with index 1 in the vertex array
@@ -76,10 +70,17 @@ namespace Renderer {
         */
         glBindBuffer(GL_ARRAY_BUFFER, 0);
         glBindVertexArray(0);
+
+        /* Resolve the subtexture name to its ID once and fill the texture coordinates */
+        setSubTexture(m_pTexture->getSubTextureId(initialSubTextureName));
+
+        /* Keep the texture image in video memory while the sprite is alive */
+        m_pTexture->addSpriteReference();
     }
 
     /* Delete a sprite */
     Sprite::~Sprite() {
+        m_pTexture->releaseSpriteReference();        // Allow the texture image to be evicted
         glDeleteBuffers(1, &m_vertexCoords_vbo);    // Free the memory associated with the buffer object with coordinates
         glDeleteBuffers(1, &m_textureCoords_vbo);   // Free the memory associated with the buffer object with texture-to-vertex coordinate mapping
         glDeleteVertexArrays(1, &m_vao);            // Free the memory associated with the vertex array object
@@ -87,6 +88,8 @@ namespace Renderer {
 
     /* Render a sprite */ 
     void Sprite::render() const {
+        ALLOCATION_HOT_SCOPE("Sprite::render");
+
         /* Activate the shader program (make it current) */
         m_pShaderProgram->use();
 
@@ -107,7 +110,7 @@ namespace Renderer {
         modelMatrix = glm::scale(modelMatrix, glm::vec3(m_size, 1.0f));
         
         /* Link the model matrix to the shader program */
-        m_pShaderProgram->setMatrix4("modelMat", modelMatrix);  
+        m_pShaderProgram->setMatrix4(m_modelMatrixLocation, modelMatrix);
 
         /* Set the texture */
         glActiveTexture(GL_TEXTURE0);   // Activate texture unit 0 (make it current)
@@ -138,4 +141,28 @@ namespace Renderer {
     void Sprite::setRotation(const float rotation) {
         m_rotation = rotation;
     }
+
+    /* Set the subtexture(frame) by its ID */
+    void Sprite::setSubTexture(const Texture2D::SubTextureId subTextureId) {
+        m_subTextureId = subTextureId;
+
+        /* Get the subtexture by its ID (an array index) */
+        const Texture2D::SubTexture2D& subTexture = m_pTexture->getSubTexture(subTextureId);
+
+        /* Array of subtexture-to-vertex coordinate mapping */
+        const GLfloat textureCoords[] {
+            subTexture.leftBottomUV.x, subTexture.leftBottomUV.y,
+            subTexture.leftBottomUV.x, subTexture.rightTopUV.y,
+            subTexture.rightTopUV.x, subTexture.rightTopUV.y,
+
+            subTexture.rightTopUV.x, subTexture.rightTopUV.y, 
+            subTexture.rightTopUV.x, subTexture.leftBottomUV.y,
+            subTexture.leftBottomUV.x, subTexture.leftBottomUV.y
+        };
+
+        /* Rewrite the data of the existing buffer without reallocating it */
+        glBindBuffer(GL_ARRAY_BUFFER, m_textureCoords_vbo);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(textureCoords), textureCoords);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
 }
\ No newline at end of file
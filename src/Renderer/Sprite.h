@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Texture2D.h"
+
 #include <glm/vec2.hpp>
 #include <glad/glad.h>
 
@@ -7,7 +9,6 @@
 #include <string>
 
 namespace Renderer {
-    class Texture2D;
     class ShaderProgram;
 
     class Sprite {
@@ -39,15 +40,27 @@ namespace Renderer {
         /* Set rotation */
         void setRotation(const float rotation);
 
+        /* Set the subtexture(frame) by its ID. Only the texture coordinates in the existing buffer are rewritten */
+        void setSubTexture(const Texture2D::SubTextureId subTextureId);
+        Texture2D::SubTextureId subTextureId() const { return m_subTextureId; }
+
+        /* Video memory used by the vertex buffers of the sprite */
+        size_t gpuSizeInBytes() const { return m_buffersSizeInBytes; }
+        /* System memory used by the sprite object (the texture and shader program are accounted separately) */
+        size_t cpuSizeInBytes() const { return sizeof(Sprite); }
+
     private:
         std::shared_ptr <Texture2D> m_pTexture;
         std::shared_ptr <ShaderProgram> m_pShaderProgram;
         glm::vec2 m_position;
         glm::vec2 m_size;
         float m_rotation;
+        GLint m_modelMatrixLocation;    // Looked up once, so rendering does not query the uniform by name
+        Texture2D::SubTextureId m_subTextureId = Texture2D::INVALID_SUBTEXTURE_ID;
 
         GLuint m_vao;
         GLuint m_vertexCoords_vbo;
         GLuint m_textureCoords_vbo;
+        size_t m_buffersSizeInBytes = 0;
     };
 }
\ No newline at end of file
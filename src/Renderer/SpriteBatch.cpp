@@ -0,0 +1,107 @@
+#include "SpriteBatch.h"
+#include "ShaderProgram.h"
+
+#include <glm/trigonometric.hpp>
+
+#include <algorithm>
+#include <cstddef>
+
+namespace Renderer {
+    /* Create the quad and instance buffers */
+    SpriteBatch::SpriteBatch(std::shared_ptr <ShaderProgram> pShaderProgram)
+        : m_pShaderProgram(std::move(pShaderProgram))
+        , m_quads(sizeof(Instance), {
+            { 1, 4, GL_FLOAT, GL_FALSE, offsetof(Instance, positionSize) },
+            { 2, 4, GL_FLOAT, GL_FALSE, offsetof(Instance, uvRect) },
+            { 3, 1, GL_FLOAT, GL_FALSE, offsetof(Instance, rotation) } }) {
+    }
+
+    /* Reserve space for instances drawn with the texture on the layer */
+    SpriteBatch::Instance* SpriteBatch::append(const Texture2D* pTexture, const int32_t layer, const size_t count) {
+        /* Consecutive sprites usually share the run, so the last one is checked before the others */
+        size_t runIndex = m_lastRunIndex;
+        if (runIndex == SIZE_MAX || m_runs[runIndex].pTexture != pTexture || m_runs[runIndex].layer != layer) {
+            runIndex = 0;
+            while (runIndex < m_runsCount && (m_runs[runIndex].pTexture != pTexture || m_runs[runIndex].layer != layer)) {
+                ++runIndex;
+            }
+            if (runIndex == m_runsCount) {
+                /* Reuse a run of an earlier frame with its memory */
+                if (m_runsCount == m_runs.size()) {
+                    m_runs.emplace_back();
+                }
+                ++m_runsCount;
+                m_runs[runIndex].layer = layer;
+                m_runs[runIndex].pTexture = pTexture;
+            }
+            m_lastRunIndex = runIndex;
+        }
+        std::vector <Instance>& instances = m_runs[runIndex].instances;
+        instances.resize(instances.size() + count);
+        return instances.data() + instances.size() - count;
+    }
+
+    /* Add one sprite */
+    void SpriteBatch::add(const Texture2D* pTexture, const int32_t layer, const glm::vec2& position, const glm::vec2& size, const float rotation, const Texture2D::SubTextureId subTextureId) {
+        const Texture2D::SubTexture2D subTexture = pTexture->getSubTexture(subTextureId);
+        Instance& instance = *append(pTexture, layer, 1);
+        instance.positionSize = glm::vec4(position, size);
+        instance.uvRect = glm::vec4(subTexture.leftBottomUV, subTexture.rightTopUV);
+        instance.rotation = glm::radians(rotation);
+    }
+
+    /* Upload the instances and draw them ordered by layer */
+    void SpriteBatch::render() {
+        m_drawCalls = 0;
+        m_instancesCount = 0;
+        m_drawOrder.clear();
+        for (size_t i = 0; i < m_runsCount; ++i) {
+            if (!m_runs[i].instances.empty()) {
+                m_drawOrder.push_back(i);
+                m_instancesCount += m_runs[i].instances.size();
+            }
+        }
+        if (m_instancesCount == 0) {
+            return;
+        }
+        /* Runs of one layer keep their submission order, so overlapping sprites do not swap between frames */
+        std::stable_sort(m_drawOrder.begin(), m_drawOrder.end(), [this](const size_t a, const size_t b) {
+            return m_runs[a].layer < m_runs[b].layer;
+        });
+
+        /* All runs go into one buffer */
+        m_quads.orphan(m_instancesCount);
+        size_t offset = 0;
+        for (const size_t runIndex : m_drawOrder) {
+            const std::vector <Instance>& instances = m_runs[runIndex].instances;
+            m_quads.upload(offset, instances.data(), instances.size());
+            offset += instances.size();
+        }
+
+        m_pShaderProgram->use();
+        glActiveTexture(GL_TEXTURE0);
+        m_quads.bind();
+        offset = 0;
+        for (const size_t runIndex : m_drawOrder) {
+            const Run& run = m_runs[runIndex];
+            run.pTexture->bind();
+            m_quads.draw(offset, run.instances.size());
+            ++m_drawCalls;
+            offset += run.instances.size();
+        }
+        m_quads.unbind();
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        clear();
+    }
+
+    /* Drop the collected instances without drawing */
+    void SpriteBatch::clear() {
+        for (size_t i = 0; i < m_runsCount; ++i) {
+            m_runs[i].pTexture = nullptr;
+            m_runs[i].instances.clear();
+        }
+        m_runsCount = 0;
+        m_lastRunIndex = SIZE_MAX;
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "InstancedQuads.h"
+#include "Texture2D.h"
+
+#include <glad/glad.h>
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Renderer {
+    class ShaderProgram;
+
+    /*
+    Instanced sprite renderer. Sprites are collected into runs by layer and texture, all instances are uploaded
+    into one instance buffer per frame and every run is drawn with one instanced draw call.
+    Storage is kept between frames, so a steady frame does not allocate
+    */
+    class SpriteBatch {
+    public:
+        /* Per-instance vertex attributes */
+        struct Instance {
+            glm::vec4 positionSize;     // Position of the lower left corner and size
+            glm::vec4 uvRect;           // Left bottom and right top texture coordinates
+            float rotation;             // Rotation around the center in radians
+        };
+
+        /* Create the quad and instance buffers. The shader program must have a projectionMat uniform */
+        explicit SpriteBatch(std::shared_ptr <ShaderProgram> pShaderProgram);
+
+        /* Prohibit copying of sprite batch objects */
+        SpriteBatch(const SpriteBatch&) = delete;
+        SpriteBatch& operator = (const SpriteBatch&) = delete;
+
+        /* Reserve space for instances drawn with the texture on the layer and return it for writing */
+        Instance* append(const Texture2D* pTexture, const int32_t layer, const size_t count);
+        /* Add one sprite (rotation in degrees, as in Sprite) */
+        void add(const Texture2D* pTexture, const int32_t layer, const glm::vec2& position, const glm::vec2& size, const float rotation, const Texture2D::SubTextureId subTextureId);
+
+        /* Upload the instances, draw them ordered by layer and clear the batch */
+        void render();
+        /* Drop the collected instances without drawing */
+        void clear();
+
+        /* Statistics of the last render() */
+        unsigned int drawCalls() const { return m_drawCalls; }
+        size_t instancesCount() const { return m_instancesCount; }
+
+    private:
+        /* Instances sharing a layer and a texture */
+        struct Run {
+            int32_t layer = 0;
+            const Texture2D* pTexture = nullptr;
+            std::vector <Instance> instances;
+        };
+
+        std::shared_ptr <ShaderProgram> m_pShaderProgram;
+        InstancedQuads m_quads;
+
+        /*
+        Runs persist between frames to keep their memory, but are assigned to a layer and a texture only until the batch is cleared,
+        so a texture freed and reallocated at the same address never joins an old run. A frame has few runs (layers times textures),
+        so they are searched linearly after the last used one
+        */
+        std::vector <Run> m_runs;
+        size_t m_runsCount = 0;
+        std::vector <size_t> m_drawOrder;
+        size_t m_lastRunIndex = SIZE_MAX;
+
+        unsigned int m_drawCalls = 0;
+        size_t m_instancesCount = 0;
+    };
+}
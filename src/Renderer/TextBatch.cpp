@@ -0,0 +1,182 @@
+#include "TextBatch.h"
+#include "Font.h"
+#include "ShaderProgram.h"
+#include "../System/Hash.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+
+namespace Renderer {
+    namespace {
+        /* Layouts not drawn for this many frames are dropped from the cache */
+        const uint64_t LAYOUT_LIFETIME_FRAMES = 256;
+
+        /* Decode the UTF-8 sequence at the position and advance past it. Malformed bytes decode as U+FFFD */
+        uint32_t decodeUtf8(const std::string_view text, size_t& position) {
+            const unsigned char lead = static_cast<unsigned char>(text[position++]);
+            if (lead < 0x80) {
+                return lead;
+            }
+            const size_t length = lead >= 0xF0 ? 3 : (lead >= 0xE0 ? 2 : (lead >= 0xC0 ? 1 : 0));
+            if (length == 0 || position + length > text.size()) {
+                return 0xFFFD;
+            }
+            uint32_t codepoint = lead & (0x3F >> length);
+            for (size_t i = 0; i < length; ++i) {
+                const unsigned char continuation = static_cast<unsigned char>(text[position++]);
+                if ((continuation & 0xC0) != 0x80) {
+                    return 0xFFFD;
+                }
+                codepoint = (codepoint << 6) | (continuation & 0x3F);
+            }
+            return codepoint;
+        }
+    }
+
+    /* Create the quad and instance buffers */
+    TextBatch::TextBatch(std::shared_ptr <ShaderProgram> pShaderProgram)
+        : m_pShaderProgram(std::move(pShaderProgram))
+        , m_quads(sizeof(Instance), {
+            { 1, 4, GL_FLOAT, GL_FALSE, offsetof(Instance, rect) },
+            { 2, 4, GL_FLOAT, GL_FALSE, offsetof(Instance, uvRect) },
+            { 3, 4, GL_UNSIGNED_BYTE, GL_TRUE, offsetof(Instance, color) } }) {
+    }
+
+    /* Get the cached layout of the text or lay it out */
+    const TextBatch::TextLayout& TextBatch::getLayout(Font& font, const std::string_view text) {
+        const Font* pFont = &font;
+        const uint64_t key = System::hashString(text, System::hashBytes(&pFont, sizeof(pFont)));
+        TextLayout& layout = m_layouts[key];
+        layout.lastUsedFrame = m_frame;
+        if (layout.pFont == pFont && layout.atlasGeneration == font.atlasGeneration() && layout.text == text) {
+            ++m_layoutHits;
+            return layout;
+        }
+
+        /* A new text, another text with the same hash, which simply takes over the entry, or glyphs moved in the atlas */
+        ++m_layoutMisses;
+        layout.pFont = pFont;
+        layout.text.assign(text);
+        layout.quads.clear();
+        glm::vec2 pen(0.f, -font.ascent());
+        size_t position = 0;
+        while (position < text.size()) {
+            const uint32_t codepoint = decodeUtf8(text, position);
+            if (codepoint == '\n') {
+                pen = glm::vec2(0.f, pen.y - font.lineHeight());
+                continue;
+            }
+            const Font::Glyph* pGlyph = font.getGlyph(codepoint);
+            if (!pGlyph) {
+                continue;
+            }
+            if (pGlyph->size.x > 0.f && pGlyph->size.y > 0.f) {
+                const glm::vec2 leftBottom(pen.x + pGlyph->offset.x, pen.y + pGlyph->offset.y - pGlyph->size.y);
+                layout.quads.push_back({ pGlyph->page, glm::vec4(leftBottom, pGlyph->size), glm::vec4(pGlyph->leftBottomUV, pGlyph->rightTopUV) });
+            }
+            pen.x += pGlyph->advance;
+        }
+        /* Taken after the glyphs are requested, since copying them into the atlas may evict a page */
+        layout.atlasGeneration = font.atlasGeneration();
+        return layout;
+    }
+
+    /* Instances of a font page */
+    std::vector <TextBatch::Instance>& TextBatch::getPageInstances(const Texture2D* pPage) {
+        size_t pageIndex = 0;
+        while (pageIndex < m_pagesCount && m_pages[pageIndex].pTexture != pPage) {
+            ++pageIndex;
+        }
+        if (pageIndex == m_pagesCount) {
+            /* Reuse a page of an earlier frame with its memory */
+            if (m_pagesCount == m_pages.size()) {
+                m_pages.emplace_back();
+            }
+            ++m_pagesCount;
+            m_pages[pageIndex].pTexture = pPage;
+        }
+        return m_pages[pageIndex].instances;
+    }
+
+    /* Add text */
+    void TextBatch::add(Font& font, const std::string_view text, const glm::vec2& position, const glm::vec4& color, const float scale) {
+        const TextLayout& layout = getLayout(font, text);
+        const uint32_t packedColor = packColor(color);
+
+        /* Consecutive glyphs usually share the page, so the page is only looked up when it changes. Drawn pages are not evicted this frame */
+        uint32_t page = UINT32_MAX;
+        std::vector <Instance>* pInstances = nullptr;
+        for (const GlyphQuad& quad : layout.quads) {
+            if (quad.page != page) {
+                page = quad.page;
+                font.touchPage(page);
+                pInstances = &getPageInstances(font.getPage(page));
+            }
+            pInstances->push_back({ glm::vec4(position.x + quad.rect.x * scale, position.y + quad.rect.y * scale, quad.rect.z * scale, quad.rect.w * scale),
+                                    quad.uvRect, packedColor });
+        }
+    }
+
+    /* Upload the glyphs and draw them page by page */
+    void TextBatch::render() {
+        m_drawCalls = 0;
+        m_glyphsCount = 0;
+        for (size_t i = 0; i < m_pagesCount; ++i) {
+            m_glyphsCount += m_pages[i].instances.size();
+        }
+
+        if (m_glyphsCount != 0) {
+            /* All pages go into one buffer */
+            m_quads.orphan(m_glyphsCount);
+            size_t offset = 0;
+            for (size_t i = 0; i < m_pagesCount; ++i) {
+                const Page& page = m_pages[i];
+                m_quads.upload(offset, page.instances.data(), page.instances.size());
+                offset += page.instances.size();
+            }
+
+            m_pShaderProgram->use();
+            glActiveTexture(GL_TEXTURE0);
+            glEnable(GL_BLEND);
+            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            m_quads.bind();
+            offset = 0;
+            for (size_t i = 0; i < m_pagesCount; ++i) {
+                const Page& page = m_pages[i];
+                if (page.instances.empty()) {
+                    continue;
+                }
+                page.pTexture->bind();
+                m_quads.draw(offset, page.instances.size());
+                ++m_drawCalls;
+                offset += page.instances.size();
+            }
+            m_quads.unbind();
+            glDisable(GL_BLEND);
+            glBindTexture(GL_TEXTURE_2D, 0);
+        }
+        clear();
+
+        /* Forget layouts of text that is no longer drawn, once in a while so that the sweep cost is spread out */
+        ++m_frame;
+        if (m_frame % LAYOUT_LIFETIME_FRAMES == 0) {
+            for (auto it = m_layouts.begin(); it != m_layouts.end(); ) {
+                it = it->second.lastUsedFrame + LAYOUT_LIFETIME_FRAMES < m_frame ? m_layouts.erase(it) : std::next(it);
+            }
+        }
+    }
+
+    /* Drop the collected glyphs without drawing */
+    void TextBatch::clear() {
+        for (size_t i = 0; i < m_pagesCount; ++i) {
+            m_pages[i].pTexture = nullptr;
+            m_pages[i].instances.clear();
+        }
+        m_pagesCount = 0;
+        m_lastLayoutMisses = m_layoutMisses;
+        m_lastLayoutHits = m_layoutHits;
+        m_layoutMisses = 0;
+        m_layoutHits = 0;
+    }
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "InstancedQuads.h"
+
+#include <glad/glad.h>
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Renderer {
+    class ShaderProgram;
+    class Font;
+    class Texture2D;
+
+    /*
+    Batched text renderer. Strings are laid out once into glyph quads relative to the string origin and the layout
+    is cached by the font and the text, so unchanged text is only offset and colored on later frames.
+    Glyphs of all strings go into one instance stream per font page and every page is drawn with one draw call
+    */
+    class TextBatch {
+    public:
+        /* Per-instance vertex attributes */
+        struct Instance {
+            glm::vec4 rect;         // Left bottom corner and size
+            glm::vec4 uvRect;       // Left bottom and right top texture coordinates
+            uint32_t color;         // RGBA8
+        };
+
+        /* Create the quad and instance buffers. The shader program must have a projectionMat uniform */
+        explicit TextBatch(std::shared_ptr <ShaderProgram> pShaderProgram);
+
+        /* Prohibit copying of text batch objects */
+        TextBatch(const TextBatch&) = delete;
+        TextBatch& operator = (const TextBatch&) = delete;
+
+        /*
+        Add UTF-8 text with its top left corner at the position, lines are separated by '\n'.
+        Laying out new text may allocate, drawing cached text does not
+        */
+        void add(Font& font, const std::string_view text, const glm::vec2& position, const glm::vec4& color = glm::vec4(1.f), const float scale = 1.f);
+
+        /* Upload the glyphs, draw them (one draw call per font page) with alpha blending and clear the batch */
+        void render();
+        /* Drop the collected glyphs without drawing */
+        void clear();
+
+        /* Statistics of the last render() */
+        unsigned int drawCalls() const { return m_drawCalls; }
+        size_t glyphsCount() const { return m_glyphsCount; }
+        /* Layouts computed and reused since the last render() */
+        unsigned int layoutMisses() const { return m_lastLayoutMisses; }
+        unsigned int layoutHits() const { return m_lastLayoutHits; }
+        size_t cachedLayoutsCount() const { return m_layouts.size(); }
+
+    private:
+        /* Glyph quad relative to the origin of the text */
+        struct GlyphQuad {
+            uint32_t page;
+            glm::vec4 rect;
+            glm::vec4 uvRect;
+        };
+        /* Laid out text. The text is kept to tell apart strings with the same hash, the atlas generation to redo layouts with evicted glyphs */
+        struct TextLayout {
+            const Font* pFont = nullptr;
+            std::string text;
+            uint64_t atlasGeneration = 0;
+            std::vector <GlyphQuad> quads;
+            uint64_t lastUsedFrame = 0;
+        };
+
+        /* Get the cached layout of the text or lay it out */
+        const TextLayout& getLayout(Font& font, const std::string_view text);
+        /* Instances of a font page */
+        std::vector <Instance>& getPageInstances(const Texture2D* pPage);
+
+        std::shared_ptr <ShaderProgram> m_pShaderProgram;
+        InstancedQuads m_quads;
+
+        std::unordered_map <uint64_t, TextLayout> m_layouts;
+        uint64_t m_frame = 0;
+
+        /*
+        Instances per font page. Storage persists between frames, but pages are assigned to textures only until the batch
+        is cleared, so a freed page texture never leaves a stale key. A frame draws few pages, so they are searched linearly
+        */
+        struct Page {
+            const Texture2D* pTexture = nullptr;
+            std::vector <Instance> instances;
+        };
+        std::vector <Page> m_pages;
+        size_t m_pagesCount = 0;
+
+        unsigned int m_drawCalls = 0;
+        size_t m_glyphsCount = 0;
+        unsigned int m_layoutMisses = 0;
+        unsigned int m_layoutHits = 0;
+        unsigned int m_lastLayoutMisses = 0;
+        unsigned int m_lastLayoutHits = 0;
+    };
+}
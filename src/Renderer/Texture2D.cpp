@@ -1,13 +1,18 @@
 #include "Texture2D.h"
+#include "../System/Hash.h"
+
+#include <iostream>
 
 namespace Renderer {
+    uint64_t Texture2D::s_currentFrame = 0;
+
     /* Create a ready-to-use texture */
     Texture2D::Texture2D(const GLuint width, const GLuint height, 
         const unsigned char* pixels,
         const unsigned int channels,
         const GLenum filter,
         const GLenum wrapMode)
-        : m_width(width), m_height(height) {
+        : m_image(std::make_shared<Image>()), m_width(width), m_height(height) {
             /* Set the format of texture pixel data depending on the number of channels per pixel */
             switch (channels) {
             case 3:
@@ -20,77 +25,263 @@ namespace Renderer {
                 m_mode = GL_RGBA;
                 break;
             }
+            m_image->bytesPerPixel = m_mode == GL_RGB ? 3 : 4;
+            m_image->filter = filter;
+            m_image->wrapMode = wrapMode;
+            m_image->lastBoundFrame = s_currentFrame;
 
             /* Create a texture */
-            glGenTextures(1, &m_ID);    // Generate and return one unique identifier for a texture
-            glActiveTexture(GL_TEXTURE0);   // Activate texture unit 0 (make it current)
-            glBindTexture(GL_TEXTURE_2D, m_ID);     // Create a texture object, bind it to the ID & make current
-            glTexImage2D(GL_TEXTURE_2D, 0, m_mode, m_width, m_height, 0, m_mode, GL_UNSIGNED_BYTE, pixels); // Fill the texture with data
-
-            /* Set texture parameters */
-            /* Texture wrapping in case texture coordinates are specified out of range */
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapMode);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrapMode);
-            /* Texture filtering in case the texture is smaller or larger the area it is being mapped to on the screen */
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
-
-            /* Generate mipmaps for the texture */
-            glGenerateMipmap(GL_TEXTURE_2D);
-
-            /*
-            Unbind the current texture. 
-            After working with a texture it is a good practice to unbind it
-            */
-            glBindTexture(GL_TEXTURE_2D, 0);
+            upload(pixels);
+    }
+
+    /* (Re)create the GL texture object of the image from pixels */
+    void Texture2D::upload(const unsigned char* pixels) const {
+        /* Create a texture */
+        if (m_image->ID == 0) {
+            glGenTextures(1, &m_image->ID);    // Generate and return one unique identifier for a texture
+        }
+        /* The image may be reloaded while binding to another unit, so the active unit is restored afterwards */
+        GLint activeUnit = GL_TEXTURE0;
+        glGetIntegerv(GL_ACTIVE_TEXTURE, &activeUnit);
+        glActiveTexture(GL_TEXTURE0);   // Activate texture unit 0 (make it current)
+        glBindTexture(GL_TEXTURE_2D, m_image->ID);     // Create a texture object, bind it to the ID & make current
+        glTexImage2D(GL_TEXTURE_2D, 0, m_mode, m_width, m_height, 0, m_mode, GL_UNSIGNED_BYTE, pixels); // Fill the texture with data
+
+        /* Set texture parameters */
+        /* Texture wrapping in case texture coordinates are specified out of range */
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, m_image->wrapMode);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, m_image->wrapMode);
+        /* Texture filtering in case the texture is smaller or larger the area it is being mapped to on the screen */
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_image->filter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_image->filter);
+
+        /* Generate mipmaps for the texture */
+        glGenerateMipmap(GL_TEXTURE_2D);
+
+        /*
+        Unbind the current texture. 
+        After working with a texture it is a good practice to unbind it
+        */
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glActiveTexture(static_cast<GLenum>(activeUnit));
+    }
+
+    /* Delete the GL texture object, keeping everything needed to reload it */
+    size_t Texture2D::evict() const {
+        if (!isResident()) {
+            return 0;
+        }
+        glDeleteTextures(1, &m_image->ID);
+        m_image->ID = 0;
+        return imageSizeInBytes();
     }
 
     /* Delete a texture */
     Texture2D::~Texture2D() {
-        /* Free the memory associated with the texture */
-         glDeleteTextures(1, &m_ID);
+        /* The memory associated with the texture is freed when the last texture sharing the image is deleted */
+    }
+
+    /* Overwrite a rectangle of the resident image */
+    void Texture2D::uploadRegion(const GLint x, const GLint y, const GLsizei width, const GLsizei height, const unsigned char* pixels) const {
+        GLint activeUnit = GL_TEXTURE0;
+        glGetIntegerv(GL_ACTIVE_TEXTURE, &activeUnit);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, m_image->ID);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, m_mode, GL_UNSIGNED_BYTE, pixels);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glActiveTexture(static_cast<GLenum>(activeUnit));
     }
 
     /* Overload move constructor */
     Texture2D::Texture2D(Texture2D&& texture2d) {
-        m_ID = texture2d.m_ID;
-        texture2d.m_ID = 0;
+        m_image = std::move(texture2d.m_image);
         m_width = texture2d.m_width;
         m_height = texture2d.m_height;
         m_mode = texture2d.m_mode;
+        m_subTextures = std::move(texture2d.m_subTextures);
+        m_subTextureNames = std::move(texture2d.m_subTextureNames);
+        m_subTextureIds = std::move(texture2d.m_subTextureIds);
+        m_gridColumns = texture2d.m_gridColumns;
+        m_gridRows = texture2d.m_gridRows;
+        m_tileUVSize = texture2d.m_tileUVSize;
     }
 
     /* Overload move assignment operator */
     Texture2D& Texture2D::operator = (Texture2D&& texture2d) {
-        glDeleteTextures(1, &m_ID);
-        m_ID = texture2d.m_ID;
-        texture2d.m_ID = 0;
+        m_image = std::move(texture2d.m_image);
         m_width = texture2d.m_width;
         m_height = texture2d.m_height;
         m_mode = texture2d.m_mode;
+        m_subTextures = std::move(texture2d.m_subTextures);
+        m_subTextureNames = std::move(texture2d.m_subTextureNames);
+        m_subTextureIds = std::move(texture2d.m_subTextureIds);
+        m_gridColumns = texture2d.m_gridColumns;
+        m_gridRows = texture2d.m_gridRows;
+        m_tileUVSize = texture2d.m_tileUVSize;
         return *this;
     }
 
+    /* Create a texture that shares the image of this texture */
+    Texture2D Texture2D::createAlias() const {
+        Texture2D alias;
+        alias.m_image = m_image;
+        alias.m_width = m_width;
+        alias.m_height = m_height;
+        alias.m_mode = m_mode;
+        return alias;
+    }
+
+    /* Size of the image in video memory including the mipmap chain */
+    size_t Texture2D::imageSizeInBytes() const {
+        if (!m_image) {
+            return 0;
+        }
+        size_t size = 0;
+        unsigned int levelWidth = m_width;
+        unsigned int levelHeight = m_height;
+        while (true) {
+            size += static_cast<size_t>(levelWidth) * levelHeight * m_image->bytesPerPixel;
+            if (levelWidth == 1 && levelHeight == 1) {
+                break;
+            }
+            levelWidth = levelWidth > 1 ? levelWidth / 2 : 1;
+            levelHeight = levelHeight > 1 ? levelHeight / 2 : 1;
+        }
+        return size;
+    }
+
+    /* System memory used by the texture object and its subtexture tables */
+    size_t Texture2D::cpuSizeInBytes() const {
+        size_t size = sizeof(Texture2D) + m_subTextures.capacity() * sizeof(SubTexture2D);
+        /* Hash tables: buckets plus one node per element */
+        size += m_subTextureNames.bucket_count() * sizeof(void*) + m_subTextureIds.bucket_count() * sizeof(void*);
+        size += m_subTextureNames.size() * (sizeof(std::pair<const SubTextureId, std::string>) + sizeof(void*));
+        size += m_subTextureIds.size() * (sizeof(std::pair<const uint64_t, SubTextureId>) + sizeof(void*));
+        const size_t inlineCapacity = std::string().capacity();    // Short names are stored inside the string object
+        for (const auto& [subTextureId, subTextureName] : m_subTextureNames) {
+            if (subTextureName.capacity() > inlineCapacity) {
+                size += subTextureName.capacity() + 1;
+            }
+        }
+        return size;
+    }
+
     /* Make the texture current */
     void Texture2D::bind() const {
-        glBindTexture(GL_TEXTURE_2D, m_ID);
+        if (!m_image) {
+            glBindTexture(GL_TEXTURE_2D, 0);
+            return;
+        }
+        /* Reload the evicted image. upload() leaves the texture unbound, so bind it afterwards */
+        if (m_image->ID == 0 && m_image->reloadFunction && !m_image->reloadFunction(*this)) {
+            /* The image stays empty and is not reloaded again, so the message is printed once */
+            std::cerr << "Can not reload an evicted texture image, texture 0 is bound instead" << std::endl;
+            m_image->reloadFunction = nullptr;
+        }
+        m_image->lastBoundFrame = s_currentFrame;
+        glBindTexture(GL_TEXTURE_2D, m_image->ID);
     }
 
-    /* Add a subtexture(tile) */
-    void Texture2D::addSubTexture(std::string subTextureName, const glm::vec2& leftBottomUV, glm::vec2& rigthTopUV) {
-        /* Create a subtexture object and emplace it in the map */
-        m_subTextures.emplace(std::move(subTextureName), SubTexture2D(leftBottomUV, rigthTopUV));
+    /* Intern a name for the ID */
+    Texture2D::SubTextureId Texture2D::internSubTextureName(std::string subTextureName, const SubTextureId subTextureId, bool& isNewName) {
+        /* A name that is already known keeps its ID */
+        auto [it, isInserted] = m_subTextureIds.emplace(System::hashString(subTextureName), subTextureId);
+        isNewName = isInserted;
+        if (isInserted) {
+            /* Further aliases of a grid tile only add IDs, the first one stays the name of the tile */
+            m_subTextureNames.emplace(subTextureId, std::move(subTextureName));
+            return it->second;
+        }
+        /* The stored name is the first alias of the ID, a further alias has another hash and is not a collision */
+        const std::string& name = m_subTextureNames[it->second];
+        if (name != subTextureName && System::hashString(name) == it->first) {
+            std::cerr << "Subtexture name hash collision: " << subTextureName << " and " << name << std::endl;
+            return INVALID_SUBTEXTURE_ID;
+        }
+        return it->second;
     }
 
-    /* Get subtexture by its name */
-    const Texture2D::SubTexture2D& Texture2D::getSubTexture(const std::string& subTextureName) const {
-        auto it = m_subTextures.find(subTextureName);
+    /* Add a subtexture(tile) and return its ID */
+    Texture2D::SubTextureId Texture2D::addSubTexture(std::string subTextureName, const glm::vec2& leftBottomUV, const glm::vec2& rigthTopUV) {
+        if (isGrid()) {
+            std::cerr << "Can not add subtexture " << subTextureName << " to a grid atlas, use tile aliases instead" << std::endl;
+            return INVALID_SUBTEXTURE_ID;
+        }
+
+        bool isNewName = false;
+        const SubTextureId subTextureId = internSubTextureName(std::move(subTextureName), static_cast<SubTextureId>(m_subTextures.size()), isNewName);
+        /* Create a subtexture object and append it to the array */
+        if (isNewName) {
+            m_subTextures.emplace_back(leftBottomUV, rigthTopUV);
+        }
+        return subTextureId;
+    }
+
+    /* Switch the texture to grid-atlas mode */
+    void Texture2D::setGrid(const unsigned int tileWidth, const unsigned int tileHeight) {
+        if (tileWidth == 0 || tileHeight == 0 || tileWidth > m_width || tileHeight > m_height) {
+            std::cerr << "Invalid grid tile size: " << tileWidth << "x" << tileHeight << std::endl;
+            return;
+        }
+        m_gridColumns = m_width / tileWidth;
+        m_gridRows = m_height / tileHeight;
+        m_tileUVSize = glm::vec2(static_cast<float>(tileWidth) / m_width, static_cast<float>(tileHeight) / m_height);
+        /* IDs now are tile indices, so names of earlier subtextures or of another grid would resolve to wrong tiles */
+        m_subTextures.clear();
+        m_subTextureIds.clear();
+        m_subTextureNames.clear();
+    }
+
+    /* Give a name to a tile of the grid */
+    Texture2D::SubTextureId Texture2D::addTileAlias(std::string tileName, const SubTextureId tileIndex) {
+        if (!isGrid() || tileIndex >= subTexturesCount()) {
+            std::cerr << "Can not add alias " << tileName << " for tile " << tileIndex << std::endl;
+            return INVALID_SUBTEXTURE_ID;
+        }
+        /* A tile may have several aliases, they all resolve to it and the first one stays its name. A name can not move to another tile */
+        const std::string name = tileName;
+        bool isNewName = false;
+        const SubTextureId subTextureId = internSubTextureName(std::move(tileName), tileIndex, isNewName);
+        if (subTextureId != INVALID_SUBTEXTURE_ID && subTextureId != tileIndex) {
+            std::cerr << "Can not add alias " << name << " for tile " << tileIndex << ", it is already an alias for tile " << subTextureId << std::endl;
+            return INVALID_SUBTEXTURE_ID;
+        }
+        return subTextureId;
+    }
+
+    /* Get subtexture ID by its name */
+    Texture2D::SubTextureId Texture2D::getSubTextureId(const std::string_view subTextureName) const {
+        return getSubTextureId(System::hashString(subTextureName));
+    }
+
+    /* Get subtexture ID by the hash of its name */
+    Texture2D::SubTextureId Texture2D::getSubTextureId(const uint64_t subTextureNameHash) const {
+        auto it = m_subTextureIds.find(subTextureNameHash);
+        return it == m_subTextureIds.end() ? INVALID_SUBTEXTURE_ID : it->second;
+    }
+
+    /* Get subtexture by its ID */
+    Texture2D::SubTexture2D Texture2D::getSubTexture(const SubTextureId subTextureId) const {
         /* Check the existence of the subtexture. If the subtexture does not exist, then take the entire texture as subtexture */
-        if (it == m_subTextures.end()) {
-            const static SubTexture2D defaultSubTexture;
-            return defaultSubTexture;
+        if (subTextureId >= subTexturesCount()) {
+            return SubTexture2D();
         }
-        return it->second;
+        /* Grid tiles are computed from the index, other subtextures are stored */
+        if (isGrid()) {
+            return getTile(subTextureId);
+        }
+        return m_subTextures[subTextureId];
+    }
+
+    /* Get subtexture by its name */
+    Texture2D::SubTexture2D Texture2D::getSubTexture(const std::string& subTextureName) const {
+        return getSubTexture(getSubTextureId(subTextureName));
+    }
+
+    /* Get subtexture name by its ID */
+    const std::string& Texture2D::getSubTextureName(const SubTextureId subTextureId) const {
+        const static std::string emptyName;
+        auto it = m_subTextureNames.find(subTextureId);
+        return it == m_subTextureNames.end() ? emptyName : it->second;
     }
-    
 }
\ No newline at end of file
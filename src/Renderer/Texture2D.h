@@ -2,8 +2,14 @@
  
 #include <glad/glad.h>
 #include <string>
+#include <string_view>
 #include <glm/vec2.hpp>
-#include <map>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <limits>
+#include <unordered_map>
+#include <vector>
 
 namespace Renderer {
     class Texture2D {
@@ -22,6 +28,10 @@ namespace Renderer {
             glm::vec2 rightTopUV;
         };
 
+        /* Small integer ID of a subtexture, interned from its name when the atlas is loaded */
+        typedef uint32_t SubTextureId;
+        static constexpr SubTextureId INVALID_SUBTEXTURE_ID = std::numeric_limits<SubTextureId>::max();
+
         /* Create a ready-to-use texture */
         Texture2D(const GLuint width, const GLuint height, 
                   const unsigned char* pixels,
@@ -39,25 +49,136 @@ namespace Renderer {
         Texture2D(Texture2D&& texture2d);
         Texture2D& operator = (Texture2D&& texture2d);
 
-        /* Make the texture current */
+        /*
+        Create a texture that shares the image (GL texture object) of this texture,
+        but has its own subtextures. Used to deduplicate textures loaded from the same image
+        */
+        Texture2D createAlias() const;
+        /* Check whether two textures share the same image */
+        bool sharesImageWith(const Texture2D& texture) const { return m_image == texture.m_image; }
+        /* Check whether other textures share the image of this texture */
+        bool isImageShared() const { return m_image.use_count() > 1; }
+
+        /* Make the texture current. An evicted image is transparently reloaded first */
         void bind() const;
 
-        /* Add a subtexture(tile) */
-        void addSubTexture(std::string subTextureName, const glm::vec2& leftBottomUV, glm::vec2& rigthTopUV);
+        /* Function that uploads the pixels of an evicted image again (see upload()) */
+        typedef std::function<bool(const Texture2D& texture)> ReloadFunction;
+
+        /*
+        (Re)create the GL texture object of the image from pixels in the texture's format.
+        The image is shared by all aliases and is not a part of the logical state of the texture,
+        so it can be uploaded through a const texture, e.g. when it is reloaded on bind
+        */
+        void upload(const unsigned char* pixels) const;
+        /* Overwrite a rectangle of the resident image (x, y from the bottom left corner) with pixels in the texture's format. Mipmaps are not updated */
+        void uploadRegion(const GLint x, const GLint y, const GLsizei width, const GLsizei height, const unsigned char* pixels) const;
+        /* Delete the GL texture object, keeping everything needed to reload it. Returns the freed bytes */
+        size_t evict() const;
+        bool isResident() const { return m_image && m_image->ID != 0; }
+        /* GL texture object of the image (0 while it is evicted), e.g. to attach the texture to a framebuffer */
+        GLuint id() const { return m_image ? m_image->ID : 0; }
+        /* Set the function that reloads the image after eviction. Images without it are never evicted */
+        void setReloadFunction(ReloadFunction reloadFunction) const { m_image->reloadFunction = std::move(reloadFunction); }
+        bool isEvictable() const { return m_image && m_image->reloadFunction && m_image->spriteReferences == 0; }
+
+        /* Frame counter used to find least recently bound images */
+        static void setCurrentFrame(const uint64_t frame) { s_currentFrame = frame; }
+        static uint64_t currentFrame() { return s_currentFrame; }
+        uint64_t lastBoundFrame() const { return m_image ? m_image->lastBoundFrame : 0; }
+
+        /* Live sprites pin the image in video memory */
+        void addSpriteReference() const { ++m_image->spriteReferences; }
+        void releaseSpriteReference() const { --m_image->spriteReferences; }
+
+        /* Add a subtexture(tile) and return its ID */
+        SubTextureId addSubTexture(std::string subTextureName, const glm::vec2& leftBottomUV, const glm::vec2& rigthTopUV);
+        /* Get subtexture ID by its name. Returns INVALID_SUBTEXTURE_ID if there is no such subtexture */
+        SubTextureId getSubTextureId(const std::string_view subTextureName) const;
+        /* Get subtexture ID by the hash of its name (see System::literals::operator "" _hash) */
+        SubTextureId getSubTextureId(const uint64_t subTextureNameHash) const;
+        /* Get subtexture by its ID. An invalid ID refers to the entire texture */
+        SubTexture2D getSubTexture(const SubTextureId subTextureId) const;
         /* Get subtexture by its name */
-        const SubTexture2D& getSubTexture(const std::string& subTextureName) const;
+        SubTexture2D getSubTexture(const std::string& subTextureName) const;
+        /* Get subtexture name by its ID (for tooling and debug output) */
+        const std::string& getSubTextureName(const SubTextureId subTextureId) const;
+        /* Number of subtextures (tiles in grid mode) */
+        size_t subTexturesCount() const { return isGrid() ? static_cast<size_t>(m_gridColumns) * m_gridRows : m_subTextures.size(); }
+
+        /*
+        Switch the texture to grid-atlas mode: the texture is split into equal tiles numbered
+        left to right, top to bottom, and tile UVs are computed from the tile index instead of being stored.
+        In this mode a subtexture ID is a tile index
+        */
+        void setGrid(const unsigned int tileWidth, const unsigned int tileHeight);
+        bool isGrid() const { return m_gridColumns != 0; }
+        /*
+        Give a name to a tile of the grid (names are an optional sparse alias table). A tile may have several aliases,
+        getSubTextureName() returns the first one. Returns INVALID_SUBTEXTURE_ID if the name already belongs to another tile
+        */
+        SubTextureId addTileAlias(std::string tileName, const SubTextureId tileIndex);
+        unsigned int gridColumns() const { return m_gridColumns; }
+        unsigned int gridRows() const { return m_gridRows; }
 
         /* Getters for the width and height of the texture */
         unsigned int width() const { return m_width; }
         unsigned int height() const { return m_height; }
+        /* Size of the image in video memory including the mipmap chain */
+        size_t imageSizeInBytes() const;
+        /* Video memory used by the image right now (0 while it is evicted) */
+        size_t residentSizeInBytes() const { return isResident() ? imageSizeInBytes() : 0; }
+        /* System memory used by the texture object and its subtexture tables */
+        size_t cpuSizeInBytes() const;
 
     private:
-        GLuint m_ID;
-        unsigned int m_width;
-        unsigned int m_height;
-        GLenum m_mode;
+        /* GL texture object. Textures that alias the same image share it, it is deleted with the last of them */
+        struct Image {
+            GLuint ID = 0;
+            unsigned int bytesPerPixel = 4;
+            GLenum filter = GL_LINEAR;
+            GLenum wrapMode = GL_CLAMP_TO_EDGE;
+
+            /* Residency state */
+            uint64_t lastBoundFrame = 0;
+            unsigned int spriteReferences = 0;
+            ReloadFunction reloadFunction;
+
+            Image() = default;
+            Image(const Image&) = delete;
+            Image& operator = (const Image&) = delete;
+            ~Image() { glDeleteTextures(1, &ID); }
+        };
+
+        /* Create an empty texture object (used for aliases) */
+        Texture2D() = default;
+
+        static uint64_t s_currentFrame;
+
+        std::shared_ptr <Image> m_image;
+        unsigned int m_width = 0;
+        unsigned int m_height = 0;
+        GLenum m_mode = GL_RGBA;
+
+        /* Intern a name for the ID. Returns INVALID_SUBTEXTURE_ID on a hash collision */
+        SubTextureId internSubTextureName(std::string subTextureName, const SubTextureId subTextureId, bool& isNewName);
+
+        /* Subtextures are stored densely and indexed by ID, names are interned by their hash */
+        std::vector <SubTexture2D> m_subTextures;
+        std::unordered_map <SubTextureId, std::string> m_subTextureNames;
+        std::unordered_map <uint64_t, SubTextureId> m_subTextureIds;
+
+        /* Compute UVs of a grid tile in O(1). Only valid in grid mode for an index below subTexturesCount(), see getSubTexture() */
+        SubTexture2D getTile(const SubTextureId tileIndex) const {
+            const float left = static_cast<float>(tileIndex % m_gridColumns) * m_tileUVSize.x;
+            const float top = 1.f - static_cast<float>(tileIndex / m_gridColumns) * m_tileUVSize.y;
+            return SubTexture2D(glm::vec2(left, top - m_tileUVSize.y), glm::vec2(left + m_tileUVSize.x, top));
+        }
 
-        std::map <std::string, SubTexture2D> m_subTextures;
+        /* Grid-atlas mode parameters */
+        unsigned int m_gridColumns = 0;
+        unsigned int m_gridRows = 0;
+        glm::vec2 m_tileUVSize = glm::vec2(0.f);
     };
 }
  
\ No newline at end of file
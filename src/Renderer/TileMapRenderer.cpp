@@ -0,0 +1,201 @@
+#include "TileMapRenderer.h"
+#include "ShaderProgram.h"
+#include "Texture2D.h"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+namespace Renderer {
+    namespace {
+        /* Texture units of the lookup textures, the atlas uses unit 0 like everywhere else */
+        const GLint CELL_IMAGES_TEXTURE_UNIT = 1;
+        const GLint UV_RECTS_TEXTURE_UNIT = 2;
+        const GLint SUB_CELLS_TEXTURE_UNIT = 3;
+
+        /* Create an integer texture with one 16-bit value per cell */
+        GLuint createCellTexture(const int columns, const int rows, const uint16_t value) {
+            const std::vector <uint16_t> values(static_cast<size_t>(columns) * rows, value);
+            GLuint texture = 0;
+            glGenTextures(1, &texture);
+            glBindTexture(GL_TEXTURE_2D, texture);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_R16UI, std::max(columns, 1), std::max(rows, 1), 0, GL_RED_INTEGER, GL_UNSIGNED_SHORT,
+                         values.empty() ? nullptr : values.data());
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glBindTexture(GL_TEXTURE_2D, 0);
+            return texture;
+        }
+    }
+
+    /* Create the textures and the quad */
+    TileMapRenderer::TileMapRenderer(std::shared_ptr <Texture2D> pAtlas,
+                                     std::shared_ptr <ShaderProgram> pShaderProgram,
+                                     const int columns,
+                                     const int rows,
+                                     const glm::vec2& tileSize,
+                                     const glm::vec2& origin)
+        : m_pAtlas(std::move(pAtlas))
+        , m_pShaderProgram(std::move(pShaderProgram))
+        , m_columns(std::max(columns, 0))
+        , m_rows(std::max(rows, 0))
+        , m_tileSize(tileSize)
+        , m_origin(origin) {
+        /* UV rectangles of all subtextures of the atlas, one RGBA32F texel each */
+        GLint maxTextureSize = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+        m_uvRectsCount = static_cast<GLsizei>(std::min<size_t>(m_pAtlas->subTexturesCount(), static_cast<size_t>(maxTextureSize)));
+        if (m_uvRectsCount < static_cast<GLsizei>(m_pAtlas->subTexturesCount())) {
+            std::cerr << "Only the first " << m_uvRectsCount << " subtextures of the atlas can be drawn by the tile map renderer" << std::endl;
+        }
+        std::vector <GLfloat> uvRects(static_cast<size_t>(m_uvRectsCount) * 4);
+        for (GLsizei i = 0; i < m_uvRectsCount; ++i) {
+            const Texture2D::SubTexture2D subTexture = m_pAtlas->getSubTexture(static_cast<Texture2D::SubTextureId>(i));
+            uvRects[i * 4 + 0] = subTexture.leftBottomUV.x;
+            uvRects[i * 4 + 1] = subTexture.leftBottomUV.y;
+            uvRects[i * 4 + 2] = subTexture.rightTopUV.x;
+            uvRects[i * 4 + 3] = subTexture.rightTopUV.y;
+        }
+
+        /* Lookup textures are read with texelFetch, so they are never filtered */
+        glGenTextures(1, &m_uvRectsTexture);
+        glBindTexture(GL_TEXTURE_2D, m_uvRectsTexture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, std::max<GLsizei>(m_uvRectsCount, 1), 1, 0, GL_RGBA, GL_FLOAT, uvRects.empty() ? nullptr : uvRects.data());
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        /* All cells start empty and whole */
+        m_cellImagesTexture = createCellTexture(m_columns, m_rows, EMPTY_IMAGE);
+        m_subCellsTexture = createCellTexture(m_columns, m_rows, 0xFFFF);
+
+        /* Unit quad drawn as a triangle strip and stretched over the grid by the vertex shader */
+        const GLfloat quadCoords[] = {
+            0.f, 0.f,
+            1.f, 0.f,
+            0.f, 1.f,
+            1.f, 1.f
+        };
+        glGenBuffers(1, &m_quad_vbo);
+        glBindBuffer(GL_ARRAY_BUFFER, m_quad_vbo);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(quadCoords), quadCoords, GL_STATIC_DRAW);
+        glGenVertexArrays(1, &m_vao);
+        glBindVertexArray(m_vao);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        /* Samplers are the same for every grid, the grid uniforms are set when drawing as grids may share the shader program */
+        m_pShaderProgram->use();
+        m_pShaderProgram->setTexture("tex", 0);
+        m_pShaderProgram->setTexture("cellImages", CELL_IMAGES_TEXTURE_UNIT);
+        m_pShaderProgram->setTexture("uvRects", UV_RECTS_TEXTURE_UNIT);
+        m_pShaderProgram->setTexture("cellSubCells", SUB_CELLS_TEXTURE_UNIT);
+        m_uniforms.gridOrigin = m_pShaderProgram->getUniformLocation("gridOrigin");
+        m_uniforms.gridSize = m_pShaderProgram->getUniformLocation("gridSize");
+        m_uniforms.gridCells = m_pShaderProgram->getUniformLocation("gridCells");
+        m_uniforms.uvRectsCount = m_pShaderProgram->getUniformLocation("uvRectsCount");
+    }
+
+    /* Delete the textures and buffers */
+    TileMapRenderer::~TileMapRenderer() {
+        glDeleteVertexArrays(1, &m_vao);
+        glDeleteBuffers(1, &m_quad_vbo);
+        glDeleteTextures(1, &m_uvRectsTexture);
+        glDeleteTextures(1, &m_subCellsTexture);
+        glDeleteTextures(1, &m_cellImagesTexture);
+    }
+
+    /* Upload the images of all cells */
+    void TileMapRenderer::upload(const CellImage* images) {
+        if (m_columns == 0 || m_rows == 0) {
+            return;
+        }
+        uploadRegion(images, glm::ivec2(0), glm::ivec2(m_columns - 1, m_rows - 1));
+    }
+
+    /* Upload the images of a rectangle of cells */
+    void TileMapRenderer::uploadRegion(const CellImage* images, const glm::ivec2& first, const glm::ivec2& last) {
+        uploadCells(m_cellImagesTexture, images, first, last);
+    }
+
+    /* Upload the sub-cell masks of a rectangle of cells */
+    void TileMapRenderer::uploadSubCellsRegion(const SubCellMask* subCells, const glm::ivec2& first, const glm::ivec2& last) {
+        uploadCells(m_subCellsTexture, subCells, first, last);
+    }
+
+    /* Upload a rectangle of cell values */
+    void TileMapRenderer::uploadCells(const GLuint texture, const uint16_t* values, const glm::ivec2& first, const glm::ivec2& last) {
+        const glm::ivec2 clampedFirst = glm::max(first, glm::ivec2(0));
+        const glm::ivec2 clampedLast = glm::min(last, glm::ivec2(m_columns - 1, m_rows - 1));
+        if (clampedFirst.x > clampedLast.x || clampedFirst.y > clampedLast.y) {
+            return;
+        }
+        const glm::ivec2 size = clampedLast - clampedFirst + 1;
+
+        /* The unpack parameters pick the rectangle out of the values of all cells, so nothing is copied on the CPU */
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, m_columns);
+        glPixelStorei(GL_UNPACK_SKIP_PIXELS, clampedFirst.x);
+        glPixelStorei(GL_UNPACK_SKIP_ROWS, clampedFirst.y);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, clampedFirst.x, clampedFirst.y, size.x, size.y, GL_RED_INTEGER, GL_UNSIGNED_SHORT, values);
+        glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+        glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        m_uploadedBytes += static_cast<size_t>(size.x) * size.y * sizeof(uint16_t);
+    }
+
+    /* Draw the grid */
+    void TileMapRenderer::render() {
+        if (m_columns == 0 || m_rows == 0) {
+            return;
+        }
+        m_pShaderProgram->use();
+        glUniform2f(m_uniforms.gridOrigin, m_origin.x, m_origin.y);
+        glUniform2f(m_uniforms.gridSize, m_tileSize.x * m_columns, m_tileSize.y * m_rows);
+        glUniform2i(m_uniforms.gridCells, m_columns, m_rows);
+        glUniform1i(m_uniforms.uvRectsCount, m_uvRectsCount);
+        glActiveTexture(GL_TEXTURE0 + SUB_CELLS_TEXTURE_UNIT);
+        glBindTexture(GL_TEXTURE_2D, m_subCellsTexture);
+        glActiveTexture(GL_TEXTURE0 + UV_RECTS_TEXTURE_UNIT);
+        glBindTexture(GL_TEXTURE_2D, m_uvRectsTexture);
+        glActiveTexture(GL_TEXTURE0 + CELL_IMAGES_TEXTURE_UNIT);
+        glBindTexture(GL_TEXTURE_2D, m_cellImagesTexture);
+        glActiveTexture(GL_TEXTURE0);
+        m_pAtlas->bind();
+
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glBindVertexArray(m_vao);
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        glBindVertexArray(0);
+        glDisable(GL_BLEND);
+
+        glActiveTexture(GL_TEXTURE0 + CELL_IMAGES_TEXTURE_UNIT);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glActiveTexture(GL_TEXTURE0 + UV_RECTS_TEXTURE_UNIT);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glActiveTexture(GL_TEXTURE0 + SUB_CELLS_TEXTURE_UNIT);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    /* Bytes sent to the GPU by the uploads since the last call */
+    size_t TileMapRenderer::takeUploadedBytes() {
+        const size_t uploadedBytes = m_uploadedBytes;
+        m_uploadedBytes = 0;
+        return uploadedBytes;
+    }
+
+    /* Video memory used by the lookup textures */
+    size_t TileMapRenderer::gpuSizeInBytes() const {
+        return static_cast<size_t>(m_columns) * m_rows * (sizeof(CellImage) + sizeof(SubCellMask)) + static_cast<size_t>(m_uvRectsCount) * 4 * sizeof(GLfloat);
+    }
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/vec2.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace Renderer {
+    class ShaderProgram;
+    class Texture2D;
+
+    /*
+    Renderer of a grid of atlas tiles drawn with one quad over the whole grid. The image of every cell
+    (a subtexture ID, 0xFFFF for empty cells) is a texel of an integer texture, and the fragment shader looks up
+    the UV rectangle of the image in a table texture. A second integer texture holds a 4x4 mask of the solid
+    sub-cells of every cell and the shader discards the chipped ones. Changing cells re-uploads only their texels
+    */
+    class TileMapRenderer {
+    public:
+        typedef uint16_t CellImage;
+        static constexpr CellImage EMPTY_IMAGE = 0xFFFF;
+        /* Sub-cell (x, y) counted from the lower left corner of a cell is bit y * 4 + x, like in Scene::TileMap */
+        typedef uint16_t SubCellMask;
+
+        /*
+        Create the cell and UV table textures and the quad. The grid has its lower left corner at the origin.
+        The shader program must have projectionMat, gridOrigin, gridSize, gridCells and uvRectsCount uniforms and
+        tex, cellImages, cellSubCells and uvRects samplers (see res/shaders/fTileMap_shader.txt)
+        */
+        TileMapRenderer(std::shared_ptr <Texture2D> pAtlas,
+                        std::shared_ptr <ShaderProgram> pShaderProgram,
+                        const int columns,
+                        const int rows,
+                        const glm::vec2& tileSize,
+                        const glm::vec2& origin = glm::vec2(0.f));
+
+        /* Delete the textures and buffers */
+        ~TileMapRenderer();
+
+        /* Prohibit copying of tile map renderer objects */
+        TileMapRenderer(const TileMapRenderer&) = delete;
+        TileMapRenderer& operator = (const TileMapRenderer&) = delete;
+
+        /* Upload the images of all cells, row by row from the bottom */
+        void upload(const CellImage* images);
+        /*
+        Upload the images of a rectangle of cells (first and last inclusive). The images are the ones of all cells,
+        only the rectangle is read from them
+        */
+        void uploadRegion(const CellImage* images, const glm::ivec2& first, const glm::ivec2& last);
+
+        /* Upload the sub-cell masks of a rectangle of cells (first and last inclusive), all cells start with every sub-cell */
+        void uploadSubCellsRegion(const SubCellMask* subCells, const glm::ivec2& first, const glm::ivec2& last);
+
+        /* Draw the grid with alpha blending */
+        void render();
+
+        int columns() const { return m_columns; }
+        int rows() const { return m_rows; }
+        /* Bytes sent to the GPU by the uploads since the last call */
+        size_t takeUploadedBytes();
+        /* Video memory used by the cell and UV table textures */
+        size_t gpuSizeInBytes() const;
+
+    private:
+        /* Upload a rectangle of 16-bit cell values into one of the cell textures */
+        void uploadCells(const GLuint texture, const uint16_t* values, const glm::ivec2& first, const glm::ivec2& last);
+
+        std::shared_ptr <Texture2D> m_pAtlas;
+        std::shared_ptr <ShaderProgram> m_pShaderProgram;
+        int m_columns;
+        int m_rows;
+        glm::vec2 m_tileSize;
+        glm::vec2 m_origin;
+        GLsizei m_uvRectsCount = 0;
+        size_t m_uploadedBytes = 0;
+
+        /* Uniform locations, looked up once */
+        struct {
+            GLint gridOrigin = -1;
+            GLint gridSize = -1;
+            GLint gridCells = -1;
+            GLint uvRectsCount = -1;
+        } m_uniforms;
+
+        GLuint m_cellImagesTexture = 0;
+        GLuint m_subCellsTexture = 0;
+        GLuint m_uvRectsTexture = 0;
+        GLuint m_quad_vbo = 0;
+        GLuint m_vao = 0;
+    };
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/* Read-only memory mapping of a whole file */
+class MappedFile {
+public:
+    MappedFile() = default;
+
+    /* Unmap the file */
+    ~MappedFile();
+
+    /* Prohibit copying, allow moving of mapped file objects */
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator = (const MappedFile&) = delete;
+    MappedFile(MappedFile&& mappedFile) noexcept;
+    MappedFile& operator = (MappedFile&& mappedFile) noexcept;
+
+    /* Map the file into memory. Returns false if the file can not be opened or mapped */
+    bool open(const std::string& filePath);
+
+    /* Unmap the file */
+    void close();
+
+    bool isOpen() const { return m_data != nullptr; }
+    const unsigned char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+    /* Get a view of the bytes in [offset, offset + size) */
+    std::string_view view(const size_t offset, const size_t size) const {
+        return std::string_view(reinterpret_cast<const char*>(m_data) + offset, size);
+    }
+
+private:
+    const unsigned char* m_data = nullptr;
+    size_t m_size = 0;
+#ifdef _WIN32
+    void* m_fileHandle = nullptr;
+    void* m_mappingHandle = nullptr;
+#endif
+};
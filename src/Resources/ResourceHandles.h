@@ -0,0 +1,12 @@
+#pragma once
+
+#include "../System/HandlePool.h"
+
+/* Typed handles of resources owned by the resource manager */
+struct ShaderHandleTag;
+struct TextureHandleTag;
+struct SpriteHandleTag;
+
+typedef System::Handle<ShaderHandleTag> ShaderHandle;
+typedef System::Handle<TextureHandleTag> TextureHandle;
+typedef System::Handle<SpriteHandleTag> SpriteHandle;
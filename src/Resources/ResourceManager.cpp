@@ -2,10 +2,23 @@
 #include "../Renderer/ShaderProgram.h"
 #include "../Renderer/Texture2D.h"
 #include "../Renderer/Sprite.h"
+#include "../Renderer/Font.h"
+#include "../Physics/CollisionMask.h"
+#include "../System/Hash.h"
+#include "../System/JobSystem.h"
+#include "../System/FrameArena.h"
+#include "ResourceManifest.h"
 
 #include <sstream>
 #include <fstream>
 #include <iostream>
+#include <iomanip>
+#include <unordered_set>
+#include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <future>
 
 #define STBI_ONLY_PNG
 #define STB_IMAGE_IMPLEMENTATION
@@ -15,6 +28,16 @@
 ResourceManager::ResourceManager(const std::string& executablePath) {
     size_t foundLastSlash = executablePath.find_last_of("/\\");
     m_path = executablePath.substr(0, foundLastSlash);
+    m_textureCache.setCacheDirectory(m_path + "/cache/textures");
+}
+
+/* Clear the reload functions of the loaded images, textures that outlive the manager can not be reloaded through it */
+ResourceManager::~ResourceManager() {
+    for (const auto& [imageKey, pWeakTexture] : m_loadedImages) {
+        if (std::shared_ptr <Renderer::Texture2D> pTexture = pWeakTexture.lock()) {
+            pTexture->setReloadFunction(nullptr);
+        }
+    }
 }
 
 /* Get a string from the file */
@@ -33,10 +56,53 @@ std::string ResourceManager::getFileString(const std::string relativeFilePath) c
     return buffer.str();    // Get buffer content as std::string
 }
 
+/* Get the file content from the mounted resource pack or from the resources directory */
+std::string_view ResourceManager::getFileData(const std::string& relativeFilePath, std::string& storage) const {
+    ResourcePack::File packedFile;
+    if (m_resourcePack.find(relativeFilePath, packedFile)) {
+        return packedFile.data;
+    }
+    storage = getFileString(relativeFilePath);
+    return storage;
+}
+
+/* Mount a single-file resource pack */
+bool ResourceManager::mountResourcePack(const std::string& packRelativePath) {
+    if (!m_resourcePack.open(m_path + "/" + packRelativePath)) {
+        std::cout << "Resource pack is not available: " << packRelativePath << ", loading resources from the directory" << std::endl;
+        return false;
+    }
+    std::cout << "Resource pack mounted: " << packRelativePath << " (" << m_resourcePack.size() << " files)" << std::endl;
+    return true;
+}
+
+/* Pack all files of a resources directory into a single-file resource pack */
+bool ResourceManager::buildResourcePack(const std::string& packRelativePath, const std::string& resourcesRelativeDirectory) const {
+    namespace fs = std::filesystem;
+    std::error_code error;
+    std::vector <std::string> relativeFilePaths;
+    for (fs::recursive_directory_iterator it(m_path + "/" + resourcesRelativeDirectory, error), end; !error && it != end; it.increment(error)) {
+        if (it->is_regular_file()) {
+            relativeFilePaths.push_back(fs::relative(it->path(), m_path).generic_string());
+        }
+    }
+    if (error) {
+        std::cerr << "Can not read resources directory: " << resourcesRelativeDirectory << std::endl;
+        return false;
+    }
+    /* Keep the blob order deterministic */
+    std::sort(relativeFilePaths.begin(), relativeFilePaths.end());
+    return ResourcePack::build(m_path, relativeFilePaths, m_path + "/" + packRelativePath);
+}
+
 /* Load shaders source code and create a shader program */
-std::shared_ptr <Renderer::ShaderProgram> ResourceManager::loadShaders(const std::string& shaderProgramName, const std::string& vertexShaderPath, const std::string& fragmentShaderPath) {
+std::shared_ptr <Renderer::ShaderProgram> ResourceManager::loadShaders(const std::string& shaderProgramName, 
+                                                                       const std::string& vertexShaderPath, 
+                                                                       const std::string& fragmentShaderPath,
+                                                                       const std::vector <std::string>& transformFeedbackVaryings) {
     // Get vertex shader source code from the file
-    std::string vertexShaderSource = getFileString(vertexShaderPath);
+    std::string vertexShaderStorage;
+    std::string_view vertexShaderSource = getFileData(vertexShaderPath, vertexShaderStorage);
     /* Check getting the vertex shader source code for success */
     if (vertexShaderSource.empty()) {
         std::cerr << "No vertex shader" << std::endl;
@@ -44,15 +110,36 @@ std::shared_ptr <Renderer::ShaderProgram> ResourceManager::loadShaders(const std
     }
 
     // Get fragment shader source code from the file
-    std::string fragmentShaderSource = getFileString(fragmentShaderPath);
+    std::string fragmentShaderStorage;
+    std::string_view fragmentShaderSource = getFileData(fragmentShaderPath, fragmentShaderStorage);
     /* Check getting the fragment shader source code for success */
     if (fragmentShaderSource.empty()) {
         std::cerr << "No fragment shader" << std::endl;
         return nullptr;
     }
-    
-    /* Create a shader program and emplace it in the map */
-    std::shared_ptr <Renderer::ShaderProgram>& newShaderProgram = m_shaderPrograms.emplace(shaderProgramName, std::make_shared<Renderer::ShaderProgram>(vertexShaderSource.c_str(), fragmentShaderSource.c_str())).first->second;
+
+    return createShaderProgram(shaderProgramName, vertexShaderSource, fragmentShaderSource, vertexShaderPath, fragmentShaderPath, transformFeedbackVaryings);
+}
+
+/* Compile a shader program from its sources and register it */
+std::shared_ptr <Renderer::ShaderProgram> ResourceManager::createShaderProgram(const std::string& shaderProgramName,
+                                                                               const std::string_view vertexShaderSource,
+                                                                               const std::string_view fragmentShaderSource,
+                                                                               const std::string& vertexShaderPath,
+                                                                               const std::string& fragmentShaderPath,
+                                                                               const std::vector <std::string>& transformFeedbackVaryings) {
+    /* Create a shader program, store it in the pool and register its name */
+    auto [nameIt, isNewName] = m_shaderProgramNames.emplace(shaderProgramName, ShaderHandle{});
+    if (isNewName) {
+        nameIt->second = m_shaderPrograms.insert(std::make_shared<Renderer::ShaderProgram>(vertexShaderSource, fragmentShaderSource, transformFeedbackVaryings));
+        ++m_memoryStatistics.shaderProgramCount;
+    }
+    std::shared_ptr <Renderer::ShaderProgram>& newShaderProgram = *m_shaderPrograms.get(nameIt->second);
+    /* The registered program can not be relinked to capture other outputs */
+    if (!isNewName && newShaderProgram->transformFeedbackVaryings() != transformFeedbackVaryings) {
+        std::cerr << "Shader program " << shaderProgramName << " is already loaded with other transform feedback varyings" << std::endl;
+        return nullptr;
+    }
     /* Check shader program compilation for success */
     if (!newShaderProgram->isCompiled()) {
         std::cerr << "Can not load shader program:\n"
@@ -65,17 +152,77 @@ std::shared_ptr <Renderer::ShaderProgram> ResourceManager::loadShaders(const std
 
 /* Get shader program by its name */
 std::shared_ptr <Renderer::ShaderProgram> ResourceManager::getShaderProgram(const std::string shaderProgramName) const {
-    ShaderProgramsMap::const_iterator it = m_shaderPrograms.find(shaderProgramName);
+    const std::shared_ptr <Renderer::ShaderProgram>* pShaderProgram = m_shaderPrograms.get(getShaderProgramHandle(shaderProgramName));
+    return pShaderProgram ? *pShaderProgram : nullptr;
+}
+
+/* Resolve the shader program name to a handle */
+ShaderHandle ResourceManager::getShaderProgramHandle(const std::string& shaderProgramName) const {
+    ShaderProgramsMap::const_iterator it = m_shaderProgramNames.find(shaderProgramName);
     /* Check the existence of the shader program */
-    if (it == m_shaderPrograms.end()) {
+    if (it == m_shaderProgramNames.end()) {
         std::cerr << "Can not find the Shader Prpgram: " << shaderProgramName << std::endl;
-        return nullptr;
+        return ShaderHandle{};
     }
     return it->second;
 }
 
-/* Load a texture */
-std::shared_ptr <Renderer::Texture2D> ResourceManager::loadTexture(const std::string& textureName, const std::string& texturePath) {
+/* Get shader program by its handle */
+Renderer::ShaderProgram* ResourceManager::getShaderProgram(const ShaderHandle shaderProgramHandle) const {
+    const std::shared_ptr <Renderer::ShaderProgram>* pShaderProgram = m_shaderPrograms.get(shaderProgramHandle);
+    return pShaderProgram ? pShaderProgram->get() : nullptr;
+}
+
+/* Decode parameters of all loaded images. They are part of the image key, so changing them never returns stale pixels */
+static constexpr int IMAGE_FLIP_VERTICALLY = 1;
+/*
+Images keep their own channels (0) in the cache as in the upload: RGB images stay 3 bytes per pixel on disk and in video memory,
+and the font sheet coverage is read from the channels the sheet has (alpha, or gray for opaque sheets)
+*/
+static constexpr int IMAGE_DESIRED_CHANNELS = 0;
+
+/* Compute the key that identifies a source image */
+bool ResourceManager::getImageKey(const std::string& texturePath, uint64_t& imageKey) const {
+    /*
+    The key combines the canonical path, a hash of the source content and the decode parameters: packed files carry
+    the content hash in the pack index, files in the directory are hashed here. Size and modification time are not enough,
+    a file rewritten within the timestamp resolution or copied with its time preserved would map stale pixels
+    */
+    const std::string canonicalPath = ResourcePack::normalizePath(texturePath);
+    imageKey = System::hashString(canonicalPath);
+
+    ResourcePack::File packedFile;
+    if (m_resourcePack.find(canonicalPath, packedFile)) {
+        imageKey = System::hashBytes(&packedFile.contentHash, sizeof(packedFile.contentHash), imageKey);
+    }
+    else {
+        MappedFile file;
+        if (!file.open(m_path + "/" + canonicalPath)) {
+            std::cerr << "Can not load image: " << texturePath << std::endl;
+            return false;
+        }
+        const uint64_t contentHash = System::hashBytes(file.data(), file.size());
+        imageKey = System::hashBytes(&contentHash, sizeof(contentHash), imageKey);
+    }
+    imageKey = System::hashBytes(&IMAGE_FLIP_VERTICALLY, sizeof(IMAGE_FLIP_VERTICALLY), imageKey);
+    imageKey = System::hashBytes(&IMAGE_DESIRED_CHANNELS, sizeof(IMAGE_DESIRED_CHANNELS), imageKey);
+    return true;
+}
+
+/* Decode an image or map its decoded copy from the texture cache */
+DecodedImage ResourceManager::decodeImage(const std::string& texturePath, const uint64_t imageKey) {
+    const auto startTime = std::chrono::steady_clock::now();
+    auto elapsedMilliseconds = [&startTime]() {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    };
+
+    /* On a hit the decoded pixels are mapped straight from the cache */
+    DecodedImage image;
+    if (m_textureCache.lookup(imageKey, image)) {
+        m_textureCache.addHitTime(elapsedMilliseconds());
+        return image;
+    }
+
     int width = 0;      // Image width
     int height = 0;     // Image height
     int channels = 0;   // Number of image channels (RGBA)
@@ -83,36 +230,270 @@ std::shared_ptr <Renderer::Texture2D> ResourceManager::loadTexture(const std::st
     stb_image library loads the image from the top left corner, however, OpenGL draws image from the bottom left corner.
     This command flips the image vertically when loading, so that the first pixel corresponds to the bottom left
     */
-    stbi_set_flip_vertically_on_load(true);
-    /* Load an image and return a pointer to an array of its pixels */
-    unsigned char* pixels = stbi_load((m_path + "/" + texturePath).c_str(), &width, &height, &channels, 0);
+    stbi_set_flip_vertically_on_load_thread(IMAGE_FLIP_VERTICALLY);     // Per-thread setting, images may be decoded on loader threads
+    /* Load an image and return a pointer to an array of its pixels. Images from the resource pack are decoded straight from the mapping */
+    unsigned char* pixels = nullptr;
+    ResourcePack::File packedFile;
+    if (m_resourcePack.find(texturePath, packedFile)) {
+        pixels = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(packedFile.data.data()), static_cast<int>(packedFile.data.size()), &width, &height, &channels, IMAGE_DESIRED_CHANNELS);
+    }
+    else {
+        pixels = stbi_load((m_path + "/" + texturePath).c_str(), &width, &height, &channels, IMAGE_DESIRED_CHANNELS);
+    }
 
     /* Check image loading for success */
-    if(!pixels) {
+    if (!pixels) {
         std::cerr << "Can not load image: " << texturePath << std::endl;
+        return image;
+    }
+
+    /* The image memory is freed by stb_image when the decoded image is destroyed */
+    image.adoptPixels(pixels, stbi_image_free, width, height, channels);
+    m_textureCache.store(imageKey, image);
+    m_textureCache.addMissTime(elapsedMilliseconds());
+    return image;
+}
+
+/* Load a texture */
+std::shared_ptr <Renderer::Texture2D> ResourceManager::loadTexture(const std::string& textureName, const std::string& texturePath) {
+    /* A texture with this name is already loaded */
+    TexturesMap::const_iterator nameIt = m_textureNames.find(textureName);
+    if (nameIt != m_textureNames.end()) {
+        return *m_textures.get(nameIt->second);
+    }
+
+    uint64_t imageKey = 0;
+    if (!getImageKey(texturePath, imageKey)) {
         return nullptr;
     }
-    
-    /* Create a texture and emplace it in the map */
-    std::shared_ptr <Renderer::Texture2D> newTexture = m_textures.emplace(textureName, std::make_shared<Renderer::Texture2D>(width, height, pixels, channels, GL_NEAREST, GL_CLAMP_TO_EDGE)).first->second;
+    return createTexture(textureName, texturePath, imageKey, nullptr);
+}
+
+/* Check whether an image with the key is already resident as a texture */
+bool ResourceManager::isImageLoaded(const uint64_t imageKey) const {
+    LoadedImagesMap::const_iterator imageIt = m_loadedImages.find(imageKey);
+    return imageIt != m_loadedImages.end() && !imageIt->second.expired();
+}
 
-    /* Free the memory allocated for storing the image */
-    stbi_image_free(pixels);
+/* Release a texture and its name. The image is released with the last texture that shares it */
+void ResourceManager::unregisterTexture(const std::string& textureName) {
+    TexturesMap::const_iterator nameIt = m_textureNames.find(textureName);
+    if (nameIt == m_textureNames.end()) {
+        return;
+    }
+    const Renderer::Texture2D& texture = **m_textures.get(nameIt->second);
+    --m_memoryStatistics.textureCount;
+    m_memoryStatistics.textureCpuBytes -= texture.cpuSizeInBytes();
+    if (!texture.isImageShared()) {
+        m_textureResidency.residentBytes -= texture.residentSizeInBytes();
+    }
+    m_textures.erase(nameIt->second);
+    m_textureNames.erase(nameIt);
+}
 
+/* Create a texture from the image identified by the key and register it */
+std::shared_ptr <Renderer::Texture2D> ResourceManager::createTexture(const std::string& textureName, const std::string& texturePath, const uint64_t imageKey, const DecodedImage* pDecodedImage) {
+    std::shared_ptr <Renderer::Texture2D> newTexture;
+    /* The same image is already loaded under another name: share its GL texture instead of decoding and uploading it again */
+    LoadedImagesMap::const_iterator imageIt = m_loadedImages.find(imageKey);
+    std::shared_ptr <Renderer::Texture2D> pLoadedTexture = imageIt != m_loadedImages.end() ? imageIt->second.lock() : nullptr;
+    if (pLoadedTexture) {
+        newTexture = std::make_shared<Renderer::Texture2D>(pLoadedTexture->createAlias());
+        ++m_deduplicatedTexturesCount;
+        m_deduplicatedTextureBytes += pLoadedTexture->imageSizeInBytes();
+    }
+    else {
+        /* Get the decoded image pixels, unless they were decoded in advance */
+        DecodedImage decodedImage;
+        if (!pDecodedImage) {
+            decodedImage = decodeImage(texturePath, imageKey);
+            pDecodedImage = &decodedImage;
+        }
+        const DecodedImage& image = *pDecodedImage;
+
+        /* Check image loading for success */
+        if (!image.isValid()) {
+            return nullptr;
+        }
+
+        /* Create a texture. The decoded image is released when it goes out of scope */
+        newTexture = std::make_shared<Renderer::Texture2D>(image.width(), image.height(), image.pixels(), image.channels(), GL_NEAREST, GL_CLAMP_TO_EDGE);
+        m_loadedImages[imageKey] = newTexture;
+        m_textureResidency.residentBytes += newTexture->imageSizeInBytes();
+
+        /* After eviction the image is decoded again (usually a texture cache hit) and uploaded on the next bind */
+        newTexture->setReloadFunction([this, texturePath, imageKey](const Renderer::Texture2D& texture) {
+            DecodedImage reloadedImage = decodeImage(texturePath, imageKey);
+            if (!reloadedImage.isValid()) {
+                return false;
+            }
+            texture.upload(reloadedImage.pixels());
+            m_textureResidency.residentBytes += texture.imageSizeInBytes();
+            ++m_textureResidency.reloads;
+            return true;
+        });
+    }
+
+    /* Store the texture in the pool and register its name */
+    m_textureNames.emplace(textureName, m_textures.insert(newTexture));
+    ++m_memoryStatistics.textureCount;
+    m_memoryStatistics.textureCpuBytes += newTexture->cpuSizeInBytes();
     return newTexture;
 }
 
+/* Advance the frame counter and evict textures over the budget */
+void ResourceManager::beginFrame() {
+    ++m_frame;
+    Renderer::Texture2D::setCurrentFrame(m_frame);
+    m_textureResidency.evictions = 0;
+    m_textureResidency.reloads = 0;
+
+    /* Measure resident images and collect the ones that may be evicted: not pinned by sprites and not bound during the last frame */
+    size_t residentBytes = 0;
+    System::FrameVector <const Renderer::Texture2D*> evictionCandidates;    // Transient, taken from the frame arena
+    for (const auto& [imageKey, pWeakTexture] : m_loadedImages) {
+        std::shared_ptr <Renderer::Texture2D> pTexture = pWeakTexture.lock();
+        if (!pTexture || !pTexture->isResident()) {
+            continue;
+        }
+        residentBytes += pTexture->imageSizeInBytes();
+        if (pTexture->isEvictable() && pTexture->lastBoundFrame() + 1 < m_frame) {
+            evictionCandidates.push_back(pTexture.get());
+        }
+    }
+    m_textureResidency.residentBytes = residentBytes;
+
+    if (m_textureResidency.budgetBytes == 0 || residentBytes <= m_textureResidency.budgetBytes) {
+        return;
+    }
+
+    /* Evict least recently bound images first until the budget is met */
+    std::sort(evictionCandidates.begin(), evictionCandidates.end(), [](const Renderer::Texture2D* a, const Renderer::Texture2D* b) {
+        return a->lastBoundFrame() < b->lastBoundFrame();
+    });
+    for (const Renderer::Texture2D* pTexture : evictionCandidates) {
+        if (m_textureResidency.residentBytes <= m_textureResidency.budgetBytes) {
+            break;
+        }
+        m_textureResidency.residentBytes -= pTexture->evict();
+        ++m_textureResidency.evictions;
+    }
+}
+
+/* Get the running totals of the memory used by the loaded resources */
+ResourceManager::MemoryStatistics ResourceManager::getMemoryStatistics() const {
+    MemoryStatistics statistics = m_memoryStatistics;
+    statistics.textureGpuBytes = m_textureResidency.residentBytes;
+    /* Glyph atlas pages are added while text is drawn, so they are taken from the fonts (there are only a few) */
+    for (const auto& [fontName, pFont] : m_fonts) {
+        statistics.fontGpuBytes += pFont->gpuSizeInBytes();
+    }
+    return statistics;
+}
+
+/* Write a per-resource memory report sorted by video memory, then by system memory */
+void ResourceManager::writeMemoryReport(std::ostream& stream) const {
+    struct ReportLine {
+        const char* type;
+        const std::string* pName;
+        size_t cpuBytes;
+        size_t gpuBytes;
+        const char* note;
+    };
+    std::vector <ReportLine> lines;
+    lines.reserve(m_shaderProgramNames.size() + m_textureNames.size() + m_spriteNames.size() + m_fonts.size());
+
+    for (const auto& [shaderProgramName, shaderProgramHandle] : m_shaderProgramNames) {
+        lines.push_back({ "shader", &shaderProgramName, 0, 0, "" });
+    }
+    /* Video memory of a shared image is reported once, with the texture that loaded it */
+    std::unordered_set <const Renderer::Texture2D*> imageOwners;
+    for (const auto& [imageKey, pWeakTexture] : m_loadedImages) {
+        imageOwners.insert(pWeakTexture.lock().get());
+    }
+    for (const auto& [textureName, textureHandle] : m_textureNames) {
+        const Renderer::Texture2D& texture = **m_textures.get(textureHandle);
+        const bool isImageOwner = imageOwners.count(&texture) != 0;
+        const char* note = !texture.isResident() ? "evicted" : (isImageOwner ? "" : "shared image");
+        /* Collision masks are system memory of their atlas */
+        CollisionMasksMap::const_iterator masksIt = m_collisionMasks.find(textureName);
+        const size_t masksBytes = masksIt != m_collisionMasks.end() ? masksIt->second->sizeInBytes() : 0;
+        lines.push_back({ "texture", &textureName, texture.cpuSizeInBytes() + masksBytes, isImageOwner ? texture.residentSizeInBytes() : 0, note });
+    }
+    for (const auto& [spriteName, spriteHandle] : m_spriteNames) {
+        const Renderer::Sprite& sprite = **m_sprites.get(spriteHandle);
+        lines.push_back({ "sprite", &spriteName, sprite.cpuSizeInBytes(), sprite.gpuSizeInBytes(), "" });
+    }
+    /* Glyph atlas pages grow with the glyphs requested so far */
+    for (const auto& [fontName, pFont] : m_fonts) {
+        lines.push_back({ "font", &fontName, 0, pFont->gpuSizeInBytes(), "" });
+    }
+    std::sort(lines.begin(), lines.end(), [](const ReportLine& a, const ReportLine& b) {
+        if (a.gpuBytes != b.gpuBytes) {
+            return a.gpuBytes > b.gpuBytes;
+        }
+        if (a.cpuBytes != b.cpuBytes) {
+            return a.cpuBytes > b.cpuBytes;
+        }
+        return *a.pName < *b.pName;
+    });
+
+    stream << "Memory report, frame " << m_frame << "\n";
+    stream << std::left << std::setw(10) << "type" << std::setw(32) << "name"
+           << std::right << std::setw(14) << "cpu bytes" << std::setw(14) << "gpu bytes" << "  note\n";
+    for (const ReportLine& line : lines) {
+        stream << std::left << std::setw(10) << line.type << std::setw(32) << *line.pName
+               << std::right << std::setw(14) << line.cpuBytes << std::setw(14) << line.gpuBytes << "  " << line.note << "\n";
+    }
+    const MemoryStatistics statistics = getMemoryStatistics();
+    stream << "Total: " << statistics.shaderProgramCount << " shader programs, "
+           << statistics.textureCount << " textures (" << statistics.textureCpuBytes << " cpu bytes, " << statistics.textureGpuBytes << " gpu bytes), "
+           << statistics.spriteCount << " sprites (" << statistics.spriteCpuBytes << " cpu bytes, " << statistics.spriteGpuBytes << " gpu bytes), "
+           << statistics.fontCount << " fonts (" << statistics.fontGpuBytes << " gpu bytes)" << std::endl;
+}
+
+/* Write the memory report to a file */
+bool ResourceManager::writeMemoryReport(const std::string& reportPath) const {
+    std::ofstream f;
+    f.open(m_path + "/" + reportPath, std::ios::out | std::ios::trunc);
+    if (!f.is_open()) {
+        std::cerr << "Failed to open the memory report file: " << reportPath << std::endl;
+        return false;
+    }
+    writeMemoryReport(f);
+    return true;
+}
+
+/* Print texture cache and deduplication statistics */
+void ResourceManager::logTextureStatistics() const {
+    m_textureCache.logStatistics();
+    std::cout << "Texture deduplication: " << m_deduplicatedTexturesCount << " aliased textures, "
+              << m_deduplicatedTextureBytes << " bytes saved" << std::endl;
+}
+
 /* Get texture by its name */
 std::shared_ptr <Renderer::Texture2D> ResourceManager::getTexture(const std::string& textureName) const {
-    TexturesMap::const_iterator it = m_textures.find(textureName);
+    const std::shared_ptr <Renderer::Texture2D>* pTexture = m_textures.get(getTextureHandle(textureName));
+    return pTexture ? *pTexture : nullptr;
+}
+
+/* Resolve the texture name to a handle */
+TextureHandle ResourceManager::getTextureHandle(const std::string& textureName) const {
+    TexturesMap::const_iterator it = m_textureNames.find(textureName);
     /* Check the existence of the texture */
-    if (it == m_textures.end()) {
+    if (it == m_textureNames.end()) {
         std::cerr << "Can not find the texture: " << textureName << std::endl;
-        return nullptr;
+        return TextureHandle{};
     }
     return it->second;
 }
 
+/* Get texture by its handle */
+Renderer::Texture2D* ResourceManager::getTexture(const TextureHandle textureHandle) const {
+    const std::shared_ptr <Renderer::Texture2D>* pTexture = m_textures.get(textureHandle);
+    return pTexture ? pTexture->get() : nullptr;
+}
+
 /* Load a sprite */
 std::shared_ptr <Renderer::Sprite> ResourceManager::loadSprite(const std::string& spriteName, 
                                                                const std::string& textureName, 
@@ -134,55 +515,507 @@ std::shared_ptr <Renderer::Sprite> ResourceManager::loadSprite(const std::string
         std::cerr << "Can not fint the shader program: " << shaderProgramName << " for the sprite: " << spriteName << std::endl;
     }
 
-    /* Create a sprite and emplace it in the map */
-    std::shared_ptr <Renderer::Sprite> newSprite = m_sprites.emplace(spriteName, 
-                                                                     std::make_shared<Renderer::Sprite>(pTexture,
-                                                                     initialSubTextureName, 
-                                                                     pShaderProgram,
-                                                                     glm::vec2(0.f, 0.f),
-                                                                     glm::vec2(spriteWidth, spriteHeight))).first->second;
+    /* Create a sprite, store it in the pool and register its name */
+    auto [nameIt, isNewName] = m_spriteNames.emplace(spriteName, SpriteHandle{});
+    if (isNewName) {
+        nameIt->second = m_sprites.insert(std::make_shared<Renderer::Sprite>(pTexture,
+                                                                             initialSubTextureName, 
+                                                                             pShaderProgram,
+                                                                             glm::vec2(0.f, 0.f),
+                                                                             glm::vec2(spriteWidth, spriteHeight)));
+        const Renderer::Sprite& sprite = **m_sprites.get(nameIt->second);
+        ++m_memoryStatistics.spriteCount;
+        m_memoryStatistics.spriteCpuBytes += sprite.cpuSizeInBytes();
+        m_memoryStatistics.spriteGpuBytes += sprite.gpuSizeInBytes();
+    }
+    std::shared_ptr <Renderer::Sprite> newSprite = *m_sprites.get(nameIt->second);
 
     return newSprite;                                                                                                                             
 }
 
 /* Get sprite by its name */
 std::shared_ptr <Renderer::Sprite> ResourceManager::getSprite(const std::string& spriteName) const {
-    SpritesMap::const_iterator it = m_sprites.find(spriteName);
+    const std::shared_ptr <Renderer::Sprite>* pSprite = m_sprites.get(getSpriteHandle(spriteName));
+    return pSprite ? *pSprite : nullptr;
+}
+
+/* Resolve the sprite name to a handle */
+SpriteHandle ResourceManager::getSpriteHandle(const std::string& spriteName) const {
+    SpritesMap::const_iterator it = m_spriteNames.find(spriteName);
     /* Check the existence of the sprite */
-    if (it == m_sprites.end()) {
+    if (it == m_spriteNames.end()) {
         std::cerr << "Can not find the sprite: " << spriteName << std::endl;
-        return nullptr;
+        return SpriteHandle{};
     }
     return it->second;
 }
 
+/* Get sprite by its handle */
+Renderer::Sprite* ResourceManager::getSprite(const SpriteHandle spriteHandle) const {
+    const std::shared_ptr <Renderer::Sprite>* pSprite = m_sprites.get(spriteHandle);
+    return pSprite ? pSprite->get() : nullptr;
+}
+
 /* Load a texture atlas */
 std::shared_ptr <Renderer::Texture2D> ResourceManager::loadTextureAtlas(const std::string textureAtlasName,
                                                                         const std::string texturePath,
                                                                         const std::vector <std::string> subTextureNames,
                                                                         const unsigned int subTextureWidth, 
-                                                                        const unsigned int subTextureHeight) {
+                                                                        const unsigned int subTextureHeight,
+                                                                        const bool buildCollisionMasks) {
     /* Load a texture */
-    auto pTexture = loadTexture(std::move(textureAtlasName), std::move(texturePath));
-    /* If the texture is successfully loaded, split it into subtextures(tiles) */
+    const bool isNewTexture = m_textureNames.count(textureAtlasName) == 0;
+    auto pTexture = loadTexture(textureAtlasName, texturePath);
+    setupTextureAtlas(pTexture, subTextureNames, subTextureWidth, subTextureHeight);
+    if (pTexture && buildCollisionMasks && !this->buildCollisionMasks(textureAtlasName, texturePath, nullptr, subTextureWidth, subTextureHeight)) {
+        /* Do not leave a half-loaded atlas registered under its name */
+        if (isNewTexture) {
+            unregisterTexture(textureAtlasName);
+        }
+        return nullptr;
+    }
+    return pTexture;
+}
+
+/* Build the collision masks of the atlas tiles from the image alpha */
+bool ResourceManager::buildCollisionMasks(const std::string& textureAtlasName,
+                                          const std::string& texturePath,
+                                          const DecodedImage* pDecodedImage,
+                                          const unsigned int subTextureWidth,
+                                          const unsigned int subTextureHeight) {
+    /* Masks of this atlas are already built */
+    if (m_collisionMasks.count(textureAtlasName) != 0) {
+        return true;
+    }
+
+    DecodedImage decodedImage;
+    if (!pDecodedImage || !pDecodedImage->isValid()) {
+        uint64_t imageKey = 0;
+        if (!getImageKey(texturePath, imageKey)) {
+            return false;
+        }
+        decodedImage = decodeImage(texturePath, imageKey);
+        pDecodedImage = &decodedImage;
+    }
+    const DecodedImage& image = *pDecodedImage;
+    if (!image.isValid()) {
+        return false;
+    }
+
+    auto pMasks = std::make_shared<const Physics::CollisionMaskSet>(image.pixels(), image.width(), image.height(), image.channels(), subTextureWidth, subTextureHeight);
+    if (pMasks->masksCount() == 0) {
+        std::cerr << "Can not build collision masks of " << textureAtlasName << " with " << subTextureWidth << "x" << subTextureHeight << " tiles" << std::endl;
+        return false;
+    }
+    m_memoryStatistics.textureCpuBytes += pMasks->sizeInBytes();
+    m_collisionMasks.emplace(textureAtlasName, std::move(pMasks));
+    return true;
+}
+
+/* Get the collision masks of the atlas tiles */
+std::shared_ptr <const Physics::CollisionMaskSet> ResourceManager::getCollisionMasks(const std::string& textureAtlasName) const {
+    CollisionMasksMap::const_iterator it = m_collisionMasks.find(textureAtlasName);
+    return it != m_collisionMasks.end() ? it->second : nullptr;
+}
+
+/* Split a texture into grid tiles and name the first of them */
+void ResourceManager::setupTextureAtlas(const std::shared_ptr <Renderer::Texture2D>& pTexture,
+                                        const std::vector <std::string>& subTextureNames,
+                                        const unsigned int subTextureWidth, 
+                                        const unsigned int subTextureHeight) {
+    /*
+    If the texture is successfully loaded, split it into subtextures(tiles).
+    The atlas is a uniform grid, so tile UVs are computed from the tile index on demand
+    and subtexture names only become aliases of the first tiles (left to right, top to bottom)
+    */
     if (pTexture) {
-        const unsigned int textureWidth = pTexture->width();
-        const unsigned int textureHeight = pTexture->height();
-        unsigned int currentTextureOffsetX = 0;
-        unsigned int currentTextureOffsetY = textureHeight;
+        const size_t cpuBytes = pTexture->cpuSizeInBytes();
+        pTexture->setGrid(subTextureWidth, subTextureHeight);
+        Renderer::Texture2D::SubTextureId tileIndex = 0;
         for (const auto& currentSubTextureName : subTextureNames) {
-            glm::vec2 leftBottomUV(static_cast<float>(currentTextureOffsetX) / textureWidth, static_cast<float>(currentTextureOffsetY - subTextureHeight) / textureHeight);
-            glm::vec2 rightTopUV(static_cast<float>(currentTextureOffsetX + subTextureWidth) / textureWidth, static_cast<float>(currentTextureOffsetY) / textureHeight);
+            pTexture->addTileAlias(currentSubTextureName, tileIndex++);
+        }
+        m_memoryStatistics.textureCpuBytes = m_memoryStatistics.textureCpuBytes + pTexture->cpuSizeInBytes() - cpuBytes;
+    }
+}
+
+/* Load a bitmap font from its descriptor */
+std::shared_ptr <Renderer::Font> ResourceManager::loadFont(const std::string& fontName, const std::string& descriptorPath) {
+    /* A font with this name is already loaded */
+    FontsMap::const_iterator fontIt = m_fonts.find(fontName);
+    if (fontIt != m_fonts.end()) {
+        return fontIt->second;
+    }
+
+    std::string descriptorStorage;
+    const std::string_view descriptor = getFileData(descriptorPath, descriptorStorage);
+    if (descriptor.empty()) {
+        std::cerr << "Can not load font descriptor: " << descriptorPath << std::endl;
+        return nullptr;
+    }
+
+    /* Lines: "font <glyph sheet path> <line height> <ascent>" and "glyph <codepoint> <x> <y> <width> <height> <x offset> <y offset> <advance>" */
+    std::string sheetPath;
+    float lineHeight = 0.f;
+    float ascent = 0.f;
+    std::vector <std::pair <uint32_t, Renderer::Font::GlyphSource>> glyphs;
+    std::istringstream descriptorStream{ std::string(descriptor) };
+    std::string line;
+    unsigned int lineNumber = 0;
+    while (std::getline(descriptorStream, line)) {
+        ++lineNumber;
+        std::istringstream lineStream(line);
+        std::string type;
+        if (!(lineStream >> type) || type[0] == '#') {
+            continue;
+        }
+        bool isValid = false;
+        if (type == "font") {
+            isValid = static_cast<bool>(lineStream >> sheetPath >> lineHeight >> ascent);
+        }
+        else if (type == "glyph") {
+            uint32_t codepoint = 0;
+            Renderer::Font::GlyphSource glyph;
+            isValid = static_cast<bool>(lineStream >> codepoint >> glyph.x >> glyph.y >> glyph.width >> glyph.height >> glyph.offsetX >> glyph.offsetY >> glyph.advance)
+                && glyph.width >= 0 && glyph.height >= 0;
+            glyphs.emplace_back(codepoint, glyph);
+        }
+        if (!isValid) {
+            std::cerr << descriptorPath << ":" << lineNumber << ": malformed font descriptor line" << std::endl;
+            return nullptr;
+        }
+    }
+    if (sheetPath.empty()) {
+        std::cerr << descriptorPath << ": the font line is missing" << std::endl;
+        return nullptr;
+    }
+
+    /* The glyph sheet is decoded flipped like any texture, only its coverage (alpha, or gray for opaque sheets) is kept */
+    uint64_t imageKey = 0;
+    if (!getImageKey(sheetPath, imageKey)) {
+        return nullptr;
+    }
+    const DecodedImage sheet = decodeImage(sheetPath, imageKey);
+    if (!sheet.isValid()) {
+        return nullptr;
+    }
+    const int channels = sheet.channels();
+    const int coverageChannel = channels == 4 ? 3 : (channels == 2 ? 1 : 0);
+    std::vector <unsigned char> coverage(static_cast<size_t>(sheet.width()) * sheet.height());
+    for (size_t i = 0; i < coverage.size(); ++i) {
+        coverage[i] = sheet.pixels()[i * channels + coverageChannel];
+    }
+
+    /* Descriptor rectangles are measured from the top of the sheet, the flipped sheet starts at the bottom */
+    std::unordered_map <uint32_t, Renderer::Font::GlyphSource> glyphSources;
+    for (auto& [codepoint, glyph] : glyphs) {
+        if (glyph.x < 0 || glyph.y < 0 || glyph.x + glyph.width > sheet.width() || glyph.y + glyph.height > sheet.height()) {
+            std::cerr << descriptorPath << ": glyph " << codepoint << " is outside of the glyph sheet" << std::endl;
+            return nullptr;
+        }
+        glyph.y = sheet.height() - glyph.y - glyph.height;
+        glyphSources.emplace(codepoint, glyph);
+    }
+
+    std::shared_ptr <Renderer::Font> pFont = std::make_shared<Renderer::Font>(std::move(coverage), sheet.width(), std::move(glyphSources), lineHeight, ascent);
+    m_fonts.emplace(fontName, pFont);
+    ++m_memoryStatistics.fontCount;
+    return pFont;
+}
+
+/* Get font by its name */
+std::shared_ptr <Renderer::Font> ResourceManager::getFont(const std::string& fontName) const {
+    FontsMap::const_iterator fontIt = m_fonts.find(fontName);
+    if (fontIt == m_fonts.end()) {
+        std::cerr << "Can not find the font: " << fontName << std::endl;
+        return nullptr;
+    }
+    return fontIt->second;
+}
+
+/* Load an animation clip */
+Renderer::AnimationClipId ResourceManager::loadAnimation(const std::string& animationName,
+                                                         const std::string& textureName,
+                                                         const std::string& mode,
+                                                         const std::vector <std::string>& frameNames,
+                                                         const std::vector <unsigned int>& frameDurations) {
+    /* Clips are immutable once loaded, so loading the same animation again returns the loaded clip */
+    if (m_animations.hasClip(animationName)) {
+        return m_animations.getClipId(animationName);
+    }
+
+    /* Get texture by its name */
+    auto pTexture = getTexture(textureName);
+    /* Check getting of the texture for success */
+    if (!pTexture) {
+        std::cerr << "Can not find the texture: " << textureName << " for the animation: " << animationName << std::endl;
+        return Renderer::INVALID_ANIMATION_CLIP_ID;
+    }
+
+    Renderer::AnimationClip::PlaybackMode playbackMode = Renderer::AnimationClip::PlaybackMode::Loop;
+    if (mode == "pingpong") {
+        playbackMode = Renderer::AnimationClip::PlaybackMode::PingPong;
+    }
+    else if (mode == "once") {
+        playbackMode = Renderer::AnimationClip::PlaybackMode::Once;
+    }
+    else if (mode != "loop") {
+        std::cerr << "Unknown playback mode: " << mode << " for the animation: " << animationName << std::endl;
+        return Renderer::INVALID_ANIMATION_CLIP_ID;
+    }
+
+    /* Frame names are resolved once here, playback only works with subtexture IDs */
+    std::vector <Renderer::Texture2D::SubTextureId> frames;
+    std::vector <float> durations;
+    for (size_t i = 0; i < frameNames.size(); ++i) {
+        const Renderer::Texture2D::SubTextureId frame = pTexture->getSubTextureId(frameNames[i]);
+        if (frame == Renderer::Texture2D::INVALID_SUBTEXTURE_ID) {
+            std::cerr << "Can not find the subtexture: " << frameNames[i] << " for the animation: " << animationName << std::endl;
+            return Renderer::INVALID_ANIMATION_CLIP_ID;
+        }
+        frames.push_back(frame);
+        durations.push_back(i < frameDurations.size() ? frameDurations[i] * 0.001f : 0.1f);
+    }
+    if (frames.empty()) {
+        std::cerr << "The animation has no frames: " << animationName << std::endl;
+        return Renderer::INVALID_ANIMATION_CLIP_ID;
+    }
+
+    return m_animations.addClip(animationName, Renderer::AnimationClip(frames, durations, playbackMode));
+}
+
+/* Load all resources listed in a manifest */
+bool ResourceManager::loadManifest(const std::string& manifestPath) {
+    typedef std::chrono::steady_clock Clock;
+    auto millisecondsSince = [](const Clock::time_point startTime) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - startTime).count();
+    };
+    const Clock::time_point startTime = Clock::now();
+
+    /* Read and parse the manifest */
+    std::string manifestStorage;
+    const std::string_view manifestText = getFileData(manifestPath, manifestStorage);
+    ResourceManifest manifest;
+    if (manifestText.empty() || !ResourceManifest::parse(manifestText, manifestPath, manifest)) {
+        std::cerr << "Can not load resource manifest: " << manifestPath << std::endl;
+        return false;
+    }
 
-            pTexture->addSubTexture(std::move(currentSubTextureName), leftBottomUV, rightTopUV);
+    /* CPU work results. Shader sources and decoded images are produced by jobs and consumed by GL work */
+    struct ShaderSources {
+        std::string vertexStorage;
+        std::string fragmentStorage;
+        std::string_view vertex;
+        std::string_view fragment;
+    };
+    struct ImageDecoding {
+        DecodedImage image;
+        double milliseconds = 0.0;
+    };
+    /* One node of the dependency graph per manifest entry */
+    struct Node {
+        const ResourceManifest::Entry* pEntry = nullptr;
+        std::vector <size_t> dependencies;
+        std::shared_future <void> cpuWork;
+        std::shared_ptr <ShaderSources> pShaderSources;
+        std::shared_ptr <ImageDecoding> pImageDecoding;
+        uint64_t imageKey = 0;
+        double cpuMilliseconds = 0.0;
+        double glMilliseconds = 0.0;
+        double pathMilliseconds = 0.0;      // Longest dependency chain ending with this node
+        size_t criticalDependency = SIZE_MAX;
+        bool isFailed = false;
+    };
+    std::vector <Node> nodes(manifest.entries.size());
 
-            currentTextureOffsetX += subTextureWidth;
-            if (currentTextureOffsetX >= textureWidth) {
-                currentTextureOffsetX = 0;
-                currentTextureOffsetY -= subTextureHeight;
+    /* Build the dependency graph: sprites depend on their texture and shader program, animations on their texture */
+    std::unordered_map <std::string, size_t> shaderNodes;
+    std::unordered_map <std::string, size_t> textureNodes;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        const ResourceManifest::Entry& entry = manifest.entries[i];
+        nodes[i].pEntry = &entry;
+        if (entry.type == ResourceManifest::EntryType::Shader) {
+            shaderNodes.emplace(entry.name, i);
+        }
+        else if (entry.type == ResourceManifest::EntryType::Texture || entry.type == ResourceManifest::EntryType::Atlas) {
+            textureNodes.emplace(entry.name, i);
+        }
+    }
+    bool isSuccessful = true;
+    for (Node& node : nodes) {
+        if (node.pEntry->type != ResourceManifest::EntryType::Sprite && node.pEntry->type != ResourceManifest::EntryType::Animation) {
+            continue;
+        }
+        /* A dependency is either a node of this manifest or an already loaded resource */
+        auto addDependency = [&](const std::unordered_map <std::string, size_t>& resourceNodes, const std::string& resourceName, const bool isLoaded) {
+            auto it = resourceNodes.find(resourceName);
+            if (it != resourceNodes.end()) {
+                node.dependencies.push_back(it->second);
+            }
+            else if (!isLoaded) {
+                std::cerr << manifestPath << ":" << node.pEntry->line << ": unknown resource " << resourceName << " for " << node.pEntry->name << std::endl;
+                node.isFailed = true;
             }
+        };
+        addDependency(textureNodes, node.pEntry->textureName, m_textureNames.count(node.pEntry->textureName) != 0);
+        if (node.pEntry->type == ResourceManifest::EntryType::Sprite) {
+            addDependency(shaderNodes, node.pEntry->shaderProgramName, m_shaderProgramNames.count(node.pEntry->shaderProgramName) != 0);
         }
+        isSuccessful = isSuccessful && !node.isFailed;
     }
 
-    return pTexture;
+    /*
+    Start the independent CPU work on the job system: shader files are read and images are decoded in parallel.
+    Every image is decoded once even if several textures use it, images that are already resident are not decoded at all
+    */
+    System::JobSystem& jobSystem = System::JobSystem::instance();
+    std::unordered_map <uint64_t, size_t> imageDecodingNodes;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        Node& node = nodes[i];
+        const ResourceManifest::Entry& entry = *node.pEntry;
+        if (entry.type == ResourceManifest::EntryType::Shader) {
+            node.pShaderSources = std::make_shared<ShaderSources>();
+            node.cpuWork = jobSystem.submit([this, &entry, pSources = node.pShaderSources, pMilliseconds = &node.cpuMilliseconds, millisecondsSince]() {
+                const Clock::time_point jobStartTime = Clock::now();
+                pSources->vertex = getFileData(entry.paths[0], pSources->vertexStorage);
+                pSources->fragment = getFileData(entry.paths[1], pSources->fragmentStorage);
+                *pMilliseconds = millisecondsSince(jobStartTime);
+            }).share();
+        }
+        else if (entry.type == ResourceManifest::EntryType::Texture || entry.type == ResourceManifest::EntryType::Atlas) {
+            if (m_textureNames.count(entry.name) != 0 || !getImageKey(entry.paths[0], node.imageKey) || isImageLoaded(node.imageKey)) {
+                continue;
+            }
+            auto [decodingIt, isNewImage] = imageDecodingNodes.emplace(node.imageKey, i);
+            if (!isNewImage) {
+                node.cpuWork = nodes[decodingIt->second].cpuWork;
+                node.pImageDecoding = nodes[decodingIt->second].pImageDecoding;
+                continue;
+            }
+            node.pImageDecoding = std::make_shared<ImageDecoding>();
+            node.cpuWork = jobSystem.submit([this, &entry, imageKey = node.imageKey, pDecoding = node.pImageDecoding, millisecondsSince]() {
+                const Clock::time_point jobStartTime = Clock::now();
+                pDecoding->image = decodeImage(entry.paths[0], imageKey);
+                pDecoding->milliseconds = millisecondsSince(jobStartTime);
+            }).share();
+        }
+    }
+
+    /* Order the nodes so that every node comes after its dependencies (Kahn's algorithm) */
+    std::vector <size_t> order;
+    std::vector <unsigned int> unresolvedDependencies(nodes.size());
+    std::vector <std::vector <size_t>> dependents(nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        unresolvedDependencies[i] = static_cast<unsigned int>(nodes[i].dependencies.size());
+        for (const size_t dependency : nodes[i].dependencies) {
+            dependents[dependency].push_back(i);
+        }
+        if (unresolvedDependencies[i] == 0) {
+            order.push_back(i);
+        }
+    }
+    for (size_t i = 0; i < order.size(); ++i) {
+        for (const size_t dependent : dependents[order[i]]) {
+            if (--unresolvedDependencies[dependent] == 0) {
+                order.push_back(dependent);
+            }
+        }
+    }
+
+    /* Do the GL work on this thread in dependency order, waiting for the CPU work of each node */
+    for (const size_t i : order) {
+        Node& node = nodes[i];
+        const ResourceManifest::Entry& entry = *node.pEntry;
+        for (const size_t dependency : node.dependencies) {
+            node.isFailed = node.isFailed || nodes[dependency].isFailed;
+        }
+        if (node.isFailed) {
+            std::cerr << "Skipping " << entry.name << " from " << manifestPath << " because of failed dependencies" << std::endl;
+            isSuccessful = false;
+            continue;
+        }
+        if (node.cpuWork.valid()) {
+            node.cpuWork.wait();
+        }
+        if (node.pImageDecoding) {
+            node.cpuMilliseconds = node.pImageDecoding->milliseconds;
+        }
+
+        const Clock::time_point glStartTime = Clock::now();
+        switch (entry.type) {
+        case ResourceManifest::EntryType::Shader:
+            node.isFailed = !node.pShaderSources->vertex.empty() && !node.pShaderSources->fragment.empty()
+                ? !createShaderProgram(entry.name, node.pShaderSources->vertex, node.pShaderSources->fragment, entry.paths[0], entry.paths[1])
+                : true;
+            node.pShaderSources.reset();
+            break;
+        case ResourceManifest::EntryType::Texture:
+        case ResourceManifest::EntryType::Atlas: {
+            const bool isNewTexture = m_textureNames.count(entry.name) == 0;
+            std::shared_ptr <Renderer::Texture2D> pTexture = node.pImageDecoding
+                ? createTexture(entry.name, entry.paths[0], node.imageKey, &node.pImageDecoding->image)
+                : loadTexture(entry.name, entry.paths[0]);
+            if (pTexture && entry.type == ResourceManifest::EntryType::Atlas) {
+                setupTextureAtlas(pTexture, entry.subTextureNames, entry.width, entry.height);
+                if (entry.buildCollisionMasks
+                    && !buildCollisionMasks(entry.name, entry.paths[0], node.pImageDecoding ? &node.pImageDecoding->image : nullptr, entry.width, entry.height)) {
+                    if (isNewTexture) {
+                        unregisterTexture(entry.name);
+                    }
+                    pTexture = nullptr;
+                }
+            }
+            node.isFailed = !pTexture;
+            break;
+        }
+        case ResourceManifest::EntryType::Sprite:
+            node.isFailed = !loadSprite(entry.name, entry.textureName, entry.shaderProgramName, entry.width, entry.height, entry.initialSubTextureName);
+            break;
+        case ResourceManifest::EntryType::Font:
+            node.isFailed = !loadFont(entry.name, entry.paths[0]);
+            break;
+        case ResourceManifest::EntryType::Animation:
+            node.isFailed = loadAnimation(entry.name, entry.textureName, entry.animationMode, entry.subTextureNames, entry.frameDurations) == Renderer::INVALID_ANIMATION_CLIP_ID;
+            break;
+        }
+        node.glMilliseconds = millisecondsSince(glStartTime);
+        isSuccessful = isSuccessful && !node.isFailed;
+
+        /* The longest chain of CPU and GL work ending with this node */
+        node.pathMilliseconds = node.cpuMilliseconds + node.glMilliseconds;
+        for (const size_t dependency : node.dependencies) {
+            if (nodes[dependency].pathMilliseconds + node.cpuMilliseconds + node.glMilliseconds > node.pathMilliseconds) {
+                node.pathMilliseconds = nodes[dependency].pathMilliseconds + node.cpuMilliseconds + node.glMilliseconds;
+                node.criticalDependency = dependency;
+            }
+        }
+    }
+    /* Finish the CPU work of skipped nodes and release the decoded images */
+    for (Node& node : nodes) {
+        if (node.cpuWork.valid()) {
+            node.cpuWork.wait();
+        }
+        node.pImageDecoding.reset();
+    }
+
+    /* Report the total load time and the critical path */
+    size_t criticalNode = SIZE_MAX;
+    double cpuMilliseconds = 0.0;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        cpuMilliseconds += nodes[i].cpuMilliseconds + nodes[i].glMilliseconds;
+        if (criticalNode == SIZE_MAX || nodes[i].pathMilliseconds > nodes[criticalNode].pathMilliseconds) {
+            criticalNode = i;
+        }
+    }
+    std::cout << "Manifest " << manifestPath << ": " << nodes.size() << " resources loaded in " << millisecondsSince(startTime) << " ms"
+              << " (" << cpuMilliseconds << " ms of work, " << jobSystem.threadCount() << " loader threads)";
+    if (criticalNode != SIZE_MAX) {
+        std::string criticalPath;
+        for (size_t i = criticalNode; i != SIZE_MAX; i = nodes[i].criticalDependency) {
+            criticalPath = nodes[i].pEntry->name + (criticalPath.empty() ? "" : " -> ") + criticalPath;
+        }
+        std::cout << ", critical path " << nodes[criticalNode].pathMilliseconds << " ms: " << criticalPath;
+    }
+    std::cout << std::endl;
+    return isSuccessful;
 }
\ No newline at end of file
@@ -1,14 +1,27 @@
 #pragma once
 
+#include "ResourcePack.h"
+#include "TextureCache.h"
+#include "ResourceHandles.h"
+#include "../Renderer/Animation.h"
+
 #include <string>
+#include <iosfwd>
+#include <string_view>
 #include <memory>
 #include <map>
+#include <unordered_map>
 #include <vector>
 
 namespace Renderer {
     class ShaderProgram;
     class Texture2D;
     class Sprite;
+    class Font;
+}
+
+namespace Physics {
+    class CollisionMaskSet;
 }
 
 class ResourceManager {
@@ -16,7 +29,8 @@ public:
     /* Find the path to the resource files directory */
     ResourceManager(const std::string& executablePath);
 
-    ~ResourceManager() = default;
+    /* Textures may outlive the manager, so their reload functions (which call into it) are cleared */
+    ~ResourceManager();
 
     /* Prohibit any copying or moving of resource manager objects */
     ResourceManager(const ResourceManager&) = delete;
@@ -24,15 +38,83 @@ public:
     ResourceManager& operator = (const ResourceManager&) = delete;
     ResourceManager& operator = (const ResourceManager&&) = delete;
     
-    /* Load shaders source code and create a shader program */
-    std::shared_ptr <Renderer::ShaderProgram> loadShaders(const std::string& shaderProgramName, const std::string& vertexShaderPath, const std::string& fragmentShaderPath);
+    /*
+    Mount a single-file resource pack. While a pack is mounted, resources are read from it
+    and the resources directory is only used for files that are missing from the pack
+    */
+    bool mountResourcePack(const std::string& packRelativePath);
+    /* Pack all files of a resources directory into a single-file resource pack */
+    bool buildResourcePack(const std::string& packRelativePath, const std::string& resourcesRelativeDirectory) const;
+
+    /* Load shaders source code and create a shader program (optionally capturing vertex outputs with transform feedback) */
+    std::shared_ptr <Renderer::ShaderProgram> loadShaders(const std::string& shaderProgramName, 
+                                                          const std::string& vertexShaderPath, 
+                                                          const std::string& fragmentShaderPath,
+                                                          const std::vector <std::string>& transformFeedbackVaryings = {});
     /* Get shader program by its name */
     std::shared_ptr <Renderer::ShaderProgram> getShaderProgram(const std::string shaderProgramName) const;
+    /* Resolve the shader program name to a handle (do it once, outside of hot paths) */
+    ShaderHandle getShaderProgramHandle(const std::string& shaderProgramName) const;
+    /* Get shader program by its handle in O(1). Returns nullptr for stale handles */
+    Renderer::ShaderProgram* getShaderProgram(const ShaderHandle shaderProgramHandle) const;
+
+    /* Enable or disable the on-disk cache of decoded textures */
+    void setTextureCacheEnabled(const bool enabled) { m_textureCache.setEnabled(enabled); }
+    /* Print texture cache hit/miss statistics and the video memory saved by texture deduplication */
+    void logTextureStatistics() const;
+    /* Video memory saved by sharing images between textures loaded from the same source */
+    size_t deduplicatedTextureBytes() const { return m_deduplicatedTextureBytes; }
+
+    /* Texture video memory residency of the current frame */
+    struct TextureResidencyStatistics {
+        size_t residentBytes = 0;   // Video memory used by resident texture images
+        size_t budgetBytes = 0;     // Configured budget (0 means unlimited)
+        unsigned int evictions = 0; // Images evicted at the beginning of the frame
+        unsigned int reloads = 0;   // Evicted images reloaded during the frame
+    };
+
+    /*
+    Set the video memory budget for texture images loaded from files (0 disables eviction).
+    When the budget is exceeded, least recently bound images that are not used by live sprites are evicted
+    and transparently reloaded the next time they are bound
+    */
+    void setTextureMemoryBudget(const size_t budgetBytes) { m_textureResidency.budgetBytes = budgetBytes; }
+    /* Advance the frame counter and evict textures over the budget. Call once at the beginning of every frame */
+    void beginFrame();
+    const TextureResidencyStatistics& getTextureResidencyStatistics() const { return m_textureResidency; }
+
+    /*
+    System and video memory used by the loaded resources. Running totals are updated when resources are loaded,
+    evicted, reloaded and released, so the statistics are cheap enough to be graphed every frame
+    */
+    struct MemoryStatistics {
+        size_t textureCount = 0;
+        size_t textureCpuBytes = 0;
+        size_t textureGpuBytes = 0;     // Resident images, each image shared by aliases is counted once
+        size_t spriteCount = 0;
+        size_t spriteCpuBytes = 0;
+        size_t spriteGpuBytes = 0;      // Vertex buffers
+        size_t fontCount = 0;
+        size_t fontGpuBytes = 0;        // Glyph atlas pages
+        size_t shaderProgramCount = 0;
+
+        size_t cpuBytes() const { return textureCpuBytes + spriteCpuBytes; }
+        size_t gpuBytes() const { return textureGpuBytes + spriteGpuBytes + fontGpuBytes; }
+    };
+    MemoryStatistics getMemoryStatistics() const;
+    /* Write a per-resource memory report sorted by video memory, then by system memory */
+    void writeMemoryReport(std::ostream& stream) const;
+    /* Write the memory report to a file */
+    bool writeMemoryReport(const std::string& reportPath) const;
 
     /* Load a texture */
     std::shared_ptr <Renderer::Texture2D> loadTexture(const std::string& textureName, const std::string& texturePath);
     /* Get texture by its name */
     std::shared_ptr <Renderer::Texture2D> getTexture(const std::string& textureName) const;
+    /* Resolve the texture name to a handle (do it once, outside of hot paths) */
+    TextureHandle getTextureHandle(const std::string& textureName) const;
+    /* Get texture by its handle in O(1). Returns nullptr for stale handles */
+    Renderer::Texture2D* getTexture(const TextureHandle textureHandle) const;
 
     /* Load a sprite */
     std::shared_ptr <Renderer::Sprite> loadSprite(const std::string& spriteName, 
@@ -43,26 +125,135 @@ public:
                                                   const std::string& initialSubTextureName = "default");
     /* Get sprite by its name */
     std::shared_ptr <Renderer::Sprite> getSprite(const std::string& spriteName) const;
+    /* Resolve the sprite name to a handle (do it once, outside of hot paths) */
+    SpriteHandle getSpriteHandle(const std::string& spriteName) const;
+    /* Get sprite by its handle in O(1). Returns nullptr for stale handles */
+    Renderer::Sprite* getSprite(const SpriteHandle spriteHandle) const;
+
+    /* Load a bitmap font from its descriptor (see res/fonts/DejaVuSansMono_16.fnt for the format) */
+    std::shared_ptr <Renderer::Font> loadFont(const std::string& fontName, const std::string& descriptorPath);
+    /* Get font by its name */
+    std::shared_ptr <Renderer::Font> getFont(const std::string& fontName) const;
+
+    /*
+    Load an animation clip: frames are subtextures of the texture shown for the given milliseconds each.
+    Mode is loop, pingpong or once. Returns INVALID_ANIMATION_CLIP_ID on failure
+    */
+    Renderer::AnimationClipId loadAnimation(const std::string& animationName,
+                                            const std::string& textureName,
+                                            const std::string& mode,
+                                            const std::vector <std::string>& frameNames,
+                                            const std::vector <unsigned int>& frameDurations);
+    /* Animation clips loaded so far. Systems address clips by ID through it */
+    const Renderer::AnimationLibrary& getAnimationLibrary() const { return m_animations; }
 
-    /* Load a texture atlas */
+    /*
+    Load all resources listed in a manifest (see ResourceManifest). Files are read and images are decoded in parallel
+    on the job system, GL objects are created on the calling thread in dependency order. Total load time and the
+    critical path are reported. Returns false if any resource failed to load
+    */
+    bool loadManifest(const std::string& manifestPath);
+
+    /* Load a texture atlas, optionally building the pixel collision masks of its tiles */
     std::shared_ptr <Renderer::Texture2D> loadTextureAtlas(const std::string textureAtlasName,
                                                            const std::string texturePath,
                                                            const std::vector <std::string> subTextureNames,
                                                            const unsigned int subTextureWidth, 
-                                                           const unsigned int subTextureHeight);
+                                                           const unsigned int subTextureHeight,
+                                                           const bool buildCollisionMasks = false);
+    /* Get the collision masks of the atlas tiles, indexed by subtexture ID. Returns nullptr if they were not built */
+    std::shared_ptr <const Physics::CollisionMaskSet> getCollisionMasks(const std::string& textureAtlasName) const;
     
 private:
     /* Get a string from the file */
     std::string getFileString(const std::string relativeFilePath) const; 
+    /*
+    Get the file content. Files found in the mounted resource pack are returned as a view into the mapping,
+    other files are read into the storage string and the returned view refers to it
+    */
+    std::string_view getFileData(const std::string& relativeFilePath, std::string& storage) const;
+
+    /* Compile a shader program from its sources and register it */
+    std::shared_ptr <Renderer::ShaderProgram> createShaderProgram(const std::string& shaderProgramName,
+                                                                  const std::string_view vertexShaderSource,
+                                                                  const std::string_view fragmentShaderSource,
+                                                                  const std::string& vertexShaderPath,
+                                                                  const std::string& fragmentShaderPath,
+                                                                  const std::vector <std::string>& transformFeedbackVaryings = {});
+
+    /*
+    Create a texture from the image identified by the key and register it. An already resident image is shared,
+    otherwise the given decoded image is uploaded (the image is decoded here if it is not given)
+    */
+    std::shared_ptr <Renderer::Texture2D> createTexture(const std::string& textureName, const std::string& texturePath, const uint64_t imageKey, const DecodedImage* pDecodedImage);
+    /* Check whether an image with the key is already resident as a texture */
+    bool isImageLoaded(const uint64_t imageKey) const;
+    /* Release a texture and its name, e.g. an atlas whose collision masks can not be built */
+    void unregisterTexture(const std::string& textureName);
+    /* Split a texture into grid tiles and name the first of them */
+    void setupTextureAtlas(const std::shared_ptr <Renderer::Texture2D>& pTexture,
+                           const std::vector <std::string>& subTextureNames,
+                           const unsigned int subTextureWidth, 
+                           const unsigned int subTextureHeight);
+
+    /*
+    Build the collision masks of the atlas tiles from the image alpha. The pixels are freed after the upload,
+    so the image is decoded again (a texture cache hit when the cache is enabled) unless the decoded image is given
+    */
+    bool buildCollisionMasks(const std::string& textureAtlasName,
+                             const std::string& texturePath,
+                             const DecodedImage* pDecodedImage,
+                             const unsigned int subTextureWidth,
+                             const unsigned int subTextureHeight);
+
+    /* Compute the key that identifies a source image: canonical path, content identity and decode parameters */
+    bool getImageKey(const std::string& texturePath, uint64_t& imageKey) const;
+    /* Decode an image (vertically flipped) or map its decoded copy from the texture cache */
+    DecodedImage decodeImage(const std::string& texturePath, const uint64_t imageKey);
+
+    /* Resources live in dense slot arrays addressed by handles. Names are only used to find the handles */
+    typedef System::HandlePool <std::shared_ptr <Renderer::ShaderProgram>, ShaderHandleTag> ShaderProgramsPool;
+    ShaderProgramsPool m_shaderPrograms;
+    typedef std::map <const std::string, ShaderHandle> ShaderProgramsMap;
+    ShaderProgramsMap m_shaderProgramNames;
+
+    typedef System::HandlePool <std::shared_ptr <Renderer::Texture2D>, TextureHandleTag> TexturesPool;
+    TexturesPool m_textures;
+    typedef std::map <const std::string, TextureHandle> TexturesMap;
+    TexturesMap m_textureNames;
+
+    /*
+    Textures that own a loaded image, by image key. Textures loaded from the same image alias it.
+    Only the owner is tracked: if it were released while its aliases live on, the image would be decoded and uploaded again
+    on the next load. This does not happen now: registered textures are kept by the pool until the manager is destroyed,
+    except an atlas that failed to load, which is released before anything can alias it
+    */
+    typedef std::unordered_map <uint64_t, std::weak_ptr <Renderer::Texture2D>> LoadedImagesMap;
+    LoadedImagesMap m_loadedImages;
+    unsigned int m_deduplicatedTexturesCount = 0;
+    size_t m_deduplicatedTextureBytes = 0;
+
+    /* Texture eviction state */
+    uint64_t m_frame = 0;
+    TextureResidencyStatistics m_textureResidency;
+    /* Running totals of the memory statistics. Texture images are counted by the residency statistics, font pages by the fonts */
+    MemoryStatistics m_memoryStatistics;
+
+    typedef System::HandlePool <std::shared_ptr <Renderer::Sprite>, SpriteHandleTag> SpritesPool;
+    SpritesPool m_sprites;
+    typedef std::map <const std::string, SpriteHandle> SpritesMap;
+    SpritesMap m_spriteNames;
 
-    typedef std::map <const std::string, std::shared_ptr <Renderer::ShaderProgram>> ShaderProgramsMap;
-    ShaderProgramsMap m_shaderPrograms;
+    Renderer::AnimationLibrary m_animations;
 
-    typedef std::map <const std::string, std::shared_ptr <Renderer::Texture2D>> TexturesMap;
-    TexturesMap m_textures;
+    typedef std::map <const std::string, std::shared_ptr <Renderer::Font>> FontsMap;
+    FontsMap m_fonts;
 
-    typedef std::map <const std::string, std::shared_ptr <Renderer::Sprite>> SpritesMap;
-    SpritesMap m_sprites;
+    /* Collision masks by atlas name */
+    typedef std::map <const std::string, std::shared_ptr <const Physics::CollisionMaskSet>> CollisionMasksMap;
+    CollisionMasksMap m_collisionMasks;
 
     std::string m_path;
+    ResourcePack m_resourcePack;
+    TextureCache m_textureCache;
 };  
\ No newline at end of file
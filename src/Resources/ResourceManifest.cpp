@@ -0,0 +1,116 @@
+#include "ResourceManifest.h"
+
+#include <iostream>
+#include <sstream>
+
+/* Parse the manifest text */
+bool ResourceManifest::parse(const std::string_view text, const std::string& manifestName, ResourceManifest& manifest) {
+    std::istringstream stream{ std::string(text) };
+    std::string line;
+    unsigned int lineNumber = 0;
+    while (std::getline(stream, line)) {
+        ++lineNumber;
+        /* Drop the comment and split the line into whitespace-separated tokens */
+        const size_t commentStart = line.find('#');
+        if (commentStart != std::string::npos) {
+            line.erase(commentStart);
+        }
+        std::istringstream lineStream(line);
+        std::vector <std::string> tokens;
+        for (std::string token; lineStream >> token; ) {
+            tokens.push_back(std::move(token));
+        }
+        if (tokens.empty()) {
+            continue;
+        }
+
+        auto fail = [&](const char* message) {
+            std::cerr << manifestName << ":" << lineNumber << ": " << message << std::endl;
+            return false;
+        };
+        /* Parse a positive integer token */
+        auto parseSize = [](const std::string& token, unsigned int& value) {
+            try {
+                const unsigned long parsed = std::stoul(token);
+                value = static_cast<unsigned int>(parsed);
+                return parsed > 0;
+            }
+            catch (const std::exception&) {
+                return false;
+            }
+        };
+
+        Entry entry;
+        entry.line = lineNumber;
+        const std::string& type = tokens[0];
+        if (type == "shader") {
+            if (tokens.size() != 4) {
+                return fail("expected: shader <name> <vertex shader path> <fragment shader path>");
+            }
+            entry.type = EntryType::Shader;
+            entry.paths = { tokens[2], tokens[3] };
+        }
+        else if (type == "texture") {
+            if (tokens.size() != 3) {
+                return fail("expected: texture <name> <image path>");
+            }
+            entry.type = EntryType::Texture;
+            entry.paths = { tokens[2] };
+        }
+        else if (type == "atlas") {
+            if (tokens.size() < 5 || !parseSize(tokens[3], entry.width) || !parseSize(tokens[4], entry.height)) {
+                return fail("expected: atlas <name> <image path> <tile width> <tile height> [+masks] [subtexture names...]");
+            }
+            entry.type = EntryType::Atlas;
+            entry.paths = { tokens[2] };
+            size_t firstName = 5;
+            if (tokens.size() > firstName && tokens[firstName] == "+masks") {
+                entry.buildCollisionMasks = true;
+                ++firstName;
+            }
+            entry.subTextureNames.assign(tokens.begin() + firstName, tokens.end());
+        }
+        else if (type == "sprite") {
+            if (tokens.size() < 6 || tokens.size() > 7 || !parseSize(tokens[4], entry.width) || !parseSize(tokens[5], entry.height)) {
+                return fail("expected: sprite <name> <texture name> <shader program name> <width> <height> [initial subtexture name]");
+            }
+            entry.type = EntryType::Sprite;
+            entry.textureName = tokens[2];
+            entry.shaderProgramName = tokens[3];
+            if (tokens.size() == 7) {
+                entry.initialSubTextureName = tokens[6];
+            }
+        }
+        else if (type == "font") {
+            if (tokens.size() != 3) {
+                return fail("expected: font <name> <font descriptor path>");
+            }
+            entry.type = EntryType::Font;
+            entry.paths = { tokens[2] };
+        }
+        else if (type == "animation") {
+            /* Frames come in pairs of a subtexture name and a duration */
+            if (tokens.size() < 6 || tokens.size() % 2 != 0
+                || (tokens[3] != "loop" && tokens[3] != "pingpong" && tokens[3] != "once")) {
+                return fail("expected: animation <name> <texture name> <loop|pingpong|once> <subtexture name> <milliseconds> [<subtexture name> <milliseconds>...]");
+            }
+            entry.type = EntryType::Animation;
+            entry.textureName = tokens[2];
+            entry.animationMode = tokens[3];
+            for (size_t i = 4; i < tokens.size(); i += 2) {
+                unsigned int frameDuration = 0;
+                if (!parseSize(tokens[i + 1], frameDuration)) {
+                    return fail("animation frame duration must be a positive number of milliseconds");
+                }
+                entry.subTextureNames.push_back(tokens[i]);
+                entry.frameDurations.push_back(frameDuration);
+            }
+        }
+        else {
+            return fail("unknown resource type");
+        }
+        entry.name = tokens[1];
+        manifest.entries.push_back(std::move(entry));
+    }
+    return true;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+Declarative list of resources to load. Text format, one resource per line, '#' starts a comment:
+    shader  <name> <vertex shader path> <fragment shader path>
+    texture <name> <image path>
+    atlas   <name> <image path> <tile width> <tile height> [+masks] [subtexture names...]
+    sprite  <name> <texture name> <shader program name> <width> <height> [initial subtexture name]
+    font    <name> <font descriptor path>
+    animation <name> <texture name> <loop|pingpong|once> <subtexture name> <milliseconds> [<subtexture name> <milliseconds>...]
+The +masks option of an atlas builds pixel collision masks of its tiles (see ResourceManager::getCollisionMasks)
+*/
+struct ResourceManifest {
+    enum class EntryType {
+        Shader,
+        Texture,
+        Atlas,
+        Sprite,
+        Font,
+        Animation
+    };
+
+    struct Entry {
+        EntryType type = EntryType::Texture;
+        std::string name;
+        std::vector <std::string> paths;            // Shader: vertex and fragment shader paths, texture and atlas: image path, font: descriptor path
+        std::vector <std::string> subTextureNames;  // Atlas: tile names, animation: frame subtexture names
+        std::vector <unsigned int> frameDurations;  // Animation: frame durations in milliseconds
+        std::string animationMode;                  // Animation: loop, pingpong or once
+        unsigned int width = 0;                     // Atlas: tile width, sprite: sprite width
+        unsigned int height = 0;                    // Atlas: tile height, sprite: sprite height
+        bool buildCollisionMasks = false;           // Atlas: build collision masks of the tiles
+        std::string textureName;                    // Sprite and animation: texture or atlas name
+        std::string shaderProgramName;              // Sprite: shader program name
+        std::string initialSubTextureName = "default";  // Sprite: initial subtexture name
+        unsigned int line = 0;                      // Line in the manifest (for error messages)
+    };
+
+    std::vector <Entry> entries;
+
+    /* Parse the manifest text. Returns false and prints the first error if the text is malformed */
+    static bool parse(const std::string_view text, const std::string& manifestName, ResourceManifest& manifest);
+};
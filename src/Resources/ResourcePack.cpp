@@ -0,0 +1,169 @@
+#include "ResourcePack.h"
+#include "../System/Hash.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+/* Map a pack file and validate its header */
+bool ResourcePack::open(const std::string& packPath) {
+    m_index = nullptr;
+    m_strings = nullptr;
+    m_entryCount = 0;
+
+    if (!m_file.open(packPath)) {
+        return false;
+    }
+
+    /* Check the header */
+    Header header;
+    if (m_file.size() < sizeof(Header)) {
+        std::cerr << "Resource pack is too small: " << packPath << std::endl;
+        m_file.close();
+        return false;
+    }
+    std::memcpy(&header, m_file.data(), sizeof(Header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION) {
+        std::cerr << "Unsupported resource pack format: " << packPath << std::endl;
+        m_file.close();
+        return false;
+    }
+
+    /* Check that the index and the strings block lie inside the file */
+    const uint64_t indexSize = static_cast<uint64_t>(header.entryCount) * sizeof(IndexEntry);
+    if (header.indexOffset % alignof(IndexEntry) != 0 || header.stringsOffset > m_file.size() ||
+        header.indexOffset > header.stringsOffset || indexSize > header.stringsOffset - header.indexOffset) {
+        std::cerr << "Corrupted resource pack index: " << packPath << std::endl;
+        m_file.close();
+        return false;
+    }
+
+    /* Check every entry once here, so that lookups can trust the index: blobs inside the file, paths inside the strings block, sorted hashes */
+    const IndexEntry* index = reinterpret_cast<const IndexEntry*>(m_file.data() + header.indexOffset);
+    const uint64_t stringsSize = m_file.size() - header.stringsOffset;
+    for (uint32_t i = 0; i < header.entryCount; ++i) {
+        const IndexEntry& entry = index[i];
+        if (entry.offset > m_file.size() || entry.size > m_file.size() - entry.offset ||
+            entry.pathOffset > stringsSize || entry.pathLength > stringsSize - entry.pathOffset ||
+            (i > 0 && index[i - 1].pathHash > entry.pathHash)) {
+            std::cerr << "Corrupted resource pack entry " << i << ": " << packPath << std::endl;
+            m_file.close();
+            return false;
+        }
+    }
+
+    m_index = index;
+    m_strings = reinterpret_cast<const char*>(m_file.data() + header.stringsOffset);
+    m_entryCount = header.entryCount;
+    return true;
+}
+
+/* Find a file by its relative path */
+bool ResourcePack::find(std::string_view relativeFilePath, File& file) const {
+    if (!isOpen()) {
+        return false;
+    }
+
+    const std::string normalizedPath = normalizePath(relativeFilePath);
+    const uint64_t pathHash = System::hashString(normalizedPath);
+
+    /* Binary search by hash, then compare paths to resolve collisions */
+    const IndexEntry* end = m_index + m_entryCount;
+    const IndexEntry* it = std::lower_bound(m_index, end, pathHash, [](const IndexEntry& entry, const uint64_t hash) {
+        return entry.pathHash < hash;
+    });
+    for (; it != end && it->pathHash == pathHash; ++it) {
+        if (std::string_view(m_strings + it->pathOffset, it->pathLength) == normalizedPath) {
+            file.data = m_file.view(it->offset, it->size);
+            file.contentHash = it->contentHash;
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Normalize a relative path */
+std::string ResourcePack::normalizePath(std::string_view relativeFilePath) {
+    std::string path(relativeFilePath);
+    std::replace(path.begin(), path.end(), '\\', '/');
+    /* Collapse "./" and "dir/../" so that every spelling of a path finds the same entry */
+    return std::filesystem::path(path).lexically_normal().generic_string();
+}
+
+/* Write a pack containing the given files */
+bool ResourcePack::build(const std::string& rootDirectory, const std::vector<std::string>& relativeFilePaths, const std::string& packPath) {
+    std::ofstream out(packPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "Can not create resource pack: " << packPath << std::endl;
+        return false;
+    }
+
+    /* Write zeros up to the given offset */
+    auto pad = [&out](const uint64_t offset) {
+        static const char zeros[BLOB_ALIGNMENT] = {};
+        uint64_t position = static_cast<uint64_t>(out.tellp());
+        while (position < offset) {
+            const uint64_t count = std::min<uint64_t>(offset - position, BLOB_ALIGNMENT);
+            out.write(zeros, static_cast<std::streamsize>(count));
+            position += count;
+        }
+    };
+    auto alignUp = [](const uint64_t value, const uint64_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    };
+
+    std::vector<IndexEntry> index;
+    std::string strings;
+    index.reserve(relativeFilePaths.size());
+
+    /* Reserve space for the header and write the blobs */
+    pad(alignUp(sizeof(Header), BLOB_ALIGNMENT));
+    for (const auto& relativeFilePath : relativeFilePaths) {
+        std::ifstream in(rootDirectory + "/" + relativeFilePath, std::ios::binary);
+        if (!in.is_open()) {
+            std::cerr << "Can not open file for the resource pack: " << relativeFilePath << std::endl;
+            return false;
+        }
+        const std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        const std::string normalizedPath = normalizePath(relativeFilePath);
+
+        IndexEntry entry;
+        entry.pathHash = System::hashString(normalizedPath);
+        entry.contentHash = System::hashBytes(content.data(), content.size());
+        entry.offset = static_cast<uint64_t>(out.tellp());
+        entry.size = content.size();
+        entry.pathOffset = static_cast<uint32_t>(strings.size());
+        entry.pathLength = static_cast<uint32_t>(normalizedPath.size());
+        index.push_back(entry);
+        strings += normalizedPath;
+
+        out.write(content.data(), static_cast<std::streamsize>(content.size()));
+        pad(alignUp(static_cast<uint64_t>(out.tellp()), BLOB_ALIGNMENT));
+    }
+
+    /* Sort the index by path hash so that lookups can use binary search */
+    std::sort(index.begin(), index.end(), [](const IndexEntry& a, const IndexEntry& b) {
+        return a.pathHash < b.pathHash;
+    });
+
+    /* Write the index, the path strings and finally the header */
+    Header header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.entryCount = static_cast<uint32_t>(index.size());
+    header.indexOffset = static_cast<uint64_t>(out.tellp());
+    out.write(reinterpret_cast<const char*>(index.data()), static_cast<std::streamsize>(index.size() * sizeof(IndexEntry)));
+    header.stringsOffset = static_cast<uint64_t>(out.tellp());
+    out.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+
+    if (!out.good()) {
+        std::cerr << "Failed to write resource pack: " << packPath << std::endl;
+        return false;
+    }
+    return true;
+}
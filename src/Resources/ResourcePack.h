@@ -0,0 +1,69 @@
+#pragma once
+
+#include "MappedFile.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+Single-file resource pack.
+Layout: header | blobs (each aligned to BLOB_ALIGNMENT) | index sorted by path hash | path strings.
+The whole file is memory-mapped once and file contents are served as views into the mapping (zero-copy)
+*/
+class ResourcePack {
+public:
+    static constexpr char MAGIC[4] = { 'O', 'G', 'T', 'P' };
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint64_t BLOB_ALIGNMENT = 64;
+
+    /* Pack header stored at the beginning of the file */
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t reserved;
+        uint64_t indexOffset;
+        uint64_t stringsOffset;
+    };
+
+    /* Index entry describing one packed file */
+    struct IndexEntry {
+        uint64_t pathHash;      // Hash of the normalized relative path (the index is sorted by this field)
+        uint64_t contentHash;   // Hash of the file content
+        uint64_t offset;        // Offset of the blob from the beginning of the pack
+        uint64_t size;          // Size of the blob in bytes
+        uint32_t pathOffset;    // Offset of the path string from the beginning of the strings block
+        uint32_t pathLength;    // Length of the path string
+    };
+
+    /* Information about a packed file */
+    struct File {
+        std::string_view data;
+        uint64_t contentHash = 0;
+    };
+
+    /* Map a pack file and validate its header */
+    bool open(const std::string& packPath);
+
+    bool isOpen() const { return m_file.isOpen(); }
+
+    /* Find a file by its relative path. Returns false if the pack does not contain the file */
+    bool find(std::string_view relativeFilePath, File& file) const;
+
+    /* Number of files in the pack */
+    size_t size() const { return m_entryCount; }
+
+    /* Write a pack containing the given files (paths are relative to the root directory) */
+    static bool build(const std::string& rootDirectory, const std::vector<std::string>& relativeFilePaths, const std::string& packPath);
+
+    /* Normalize a relative path so that lookups do not depend on the path separator style */
+    static std::string normalizePath(std::string_view relativeFilePath);
+
+private:
+    MappedFile m_file;
+    const IndexEntry* m_index = nullptr;
+    const char* m_strings = nullptr;
+    size_t m_entryCount = 0;
+};
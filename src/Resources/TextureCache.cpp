@@ -0,0 +1,145 @@
+#include "TextureCache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+/* Take ownership of heap-allocated pixels */
+void DecodedImage::adoptPixels(unsigned char* pixels, PixelsDeleter deleter, const int width, const int height, const int channels) {
+    m_mapping.close();
+    m_heapPixels = std::unique_ptr<unsigned char, PixelsDeleter>(pixels, deleter);
+    m_pixelsOffset = 0;
+    m_width = width;
+    m_height = height;
+    m_channels = channels;
+}
+
+/* Take ownership of a mapped blob */
+void DecodedImage::adoptMapping(MappedFile mapping, const size_t pixelsOffset, const int width, const int height, const int channels) {
+    m_heapPixels.reset();
+    m_mapping = std::move(mapping);
+    m_pixelsOffset = pixelsOffset;
+    m_width = width;
+    m_height = height;
+    m_channels = channels;
+}
+
+/* Get the pixels */
+const unsigned char* DecodedImage::pixels() const {
+    if (m_heapPixels) {
+        return m_heapPixels.get();
+    }
+    return m_mapping.isOpen() ? m_mapping.data() + m_pixelsOffset : nullptr;
+}
+
+/* Create a cache in the given directory */
+TextureCache::TextureCache(std::string cacheDirectory)
+    : m_cacheDirectory(std::move(cacheDirectory)) {
+}
+
+/* Get the cache file path for the key */
+std::string TextureCache::blobPath(const uint64_t key) const {
+    char fileName[32];
+    std::snprintf(fileName, sizeof(fileName), "%016llx.tex", static_cast<unsigned long long>(key));
+    return m_cacheDirectory + "/" + fileName;
+}
+
+/* Map a cached image */
+bool TextureCache::lookup(const uint64_t key, DecodedImage& image) {
+    if (!isEnabled()) {
+        return false;
+    }
+
+    MappedFile mapping;
+    if (!mapping.open(blobPath(key))) {
+        std::lock_guard<std::mutex> lock(m_statisticsMutex);
+        ++m_misses;
+        return false;
+    }
+
+    /* Validate the blob so that a truncated or stale file is treated as a miss */
+    BlobHeader header;
+    bool valid = mapping.size() >= sizeof(BlobHeader);
+    if (valid) {
+        std::memcpy(&header, mapping.data(), sizeof(BlobHeader));
+        const uint64_t pixelsSize = static_cast<uint64_t>(header.width) * header.height * header.channels;
+        valid = std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0
+             && header.version == VERSION
+             && header.key == key
+             && mapping.size() >= sizeof(BlobHeader) + pixelsSize;
+    }
+    if (!valid) {
+        std::cerr << "Ignoring invalid texture cache entry: " << blobPath(key) << std::endl;
+        std::lock_guard<std::mutex> lock(m_statisticsMutex);
+        ++m_misses;
+        return false;
+    }
+
+    image.adoptMapping(std::move(mapping), sizeof(BlobHeader), header.width, header.height, header.channels);
+    std::lock_guard<std::mutex> lock(m_statisticsMutex);
+    ++m_hits;
+    return true;
+}
+
+/* Write a decoded image to the cache */
+bool TextureCache::store(const uint64_t key, const DecodedImage& image) {
+    if (!isEnabled() || !image.isValid()) {
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(m_cacheDirectory, error);
+    if (error) {
+        std::cerr << "Can not create texture cache directory: " << m_cacheDirectory << std::endl;
+        return false;
+    }
+
+    BlobHeader header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.key = key;
+    header.width = static_cast<uint32_t>(image.width());
+    header.height = static_cast<uint32_t>(image.height());
+    header.channels = static_cast<uint32_t>(image.channels());
+
+    /* Write to a temporary file and rename it, so a reader never maps a partially written blob */
+    const std::string path = blobPath(key);
+    const std::string temporaryPath = path + ".tmp";
+    {
+        std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(BlobHeader));
+        out.write(reinterpret_cast<const char*>(image.pixels()), static_cast<std::streamsize>(image.sizeInBytes()));
+        if (!out.good()) {
+            std::cerr << "Failed to write texture cache entry: " << path << std::endl;
+            out.close();
+            std::filesystem::remove(temporaryPath, error);
+            return false;
+        }
+    }
+    std::filesystem::rename(temporaryPath, path, error);
+    return !error;
+}
+
+/* Account the time spent to obtain an image on a hit */
+void TextureCache::addHitTime(const double milliseconds) {
+    std::lock_guard<std::mutex> lock(m_statisticsMutex);
+    m_hitMilliseconds += milliseconds;
+}
+
+/* Account the time spent to obtain an image on a miss (decode + store) */
+void TextureCache::addMissTime(const double milliseconds) {
+    std::lock_guard<std::mutex> lock(m_statisticsMutex);
+    m_missMilliseconds += milliseconds;
+}
+
+/* Print hit/miss statistics */
+void TextureCache::logStatistics() const {
+    if (!isEnabled()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_statisticsMutex);
+    std::cout << "Texture cache: " << m_hits << " hits (" << m_hitMilliseconds << " ms), "
+              << m_misses << " misses (" << m_missMilliseconds << " ms)" << std::endl;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "MappedFile.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/* Decoded image pixels owned either by a mapped cache blob or by a heap buffer */
+class DecodedImage {
+public:
+    typedef void (*PixelsDeleter)(void*);
+
+    DecodedImage() = default;
+
+    /* Take ownership of heap-allocated pixels */
+    void adoptPixels(unsigned char* pixels, PixelsDeleter deleter, const int width, const int height, const int channels);
+    /* Take ownership of a mapped blob whose pixels start at the given offset */
+    void adoptMapping(MappedFile mapping, const size_t pixelsOffset, const int width, const int height, const int channels);
+
+    const unsigned char* pixels() const;
+    size_t sizeInBytes() const { return static_cast<size_t>(m_width) * m_height * m_channels; }
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+    int channels() const { return m_channels; }
+    bool isValid() const { return pixels() != nullptr; }
+
+private:
+    std::unique_ptr<unsigned char, PixelsDeleter> m_heapPixels{ nullptr, nullptr };
+    MappedFile m_mapping;
+    size_t m_pixelsOffset = 0;
+    int m_width = 0;
+    int m_height = 0;
+    int m_channels = 0;
+};
+
+/*
+On-disk cache of decoded, already vertically flipped images.
+Each entry is one file named after its key: a small header followed by raw pixels that are mapped straight into the upload path.
+Lookups and stores of different keys may run concurrently
+*/
+class TextureCache {
+public:
+    /* Create a cache in the given directory. The directory is created on the first store */
+    explicit TextureCache(std::string cacheDirectory = std::string{});
+
+    /* Move the cache to another directory */
+    void setCacheDirectory(std::string cacheDirectory) { m_cacheDirectory = std::move(cacheDirectory); }
+
+    /* Enable or disable the cache */
+    void setEnabled(const bool enabled) { m_enabled = enabled; }
+    bool isEnabled() const { return m_enabled && !m_cacheDirectory.empty(); }
+
+    /* Map a cached image. Returns false on a miss */
+    bool lookup(const uint64_t key, DecodedImage& image);
+    /* Write a decoded image to the cache */
+    bool store(const uint64_t key, const DecodedImage& image);
+
+    /* Account the time spent to obtain an image on a hit or on a miss (decode + store) */
+    void addHitTime(const double milliseconds);
+    void addMissTime(const double milliseconds);
+
+    /* Print hit/miss statistics */
+    void logStatistics() const;
+
+private:
+    struct BlobHeader {
+        char magic[4];
+        uint32_t version;
+        uint64_t key;
+        uint32_t width;
+        uint32_t height;
+        uint32_t channels;
+        uint32_t reserved[9];   // Pad the header to 64 bytes so that pixels start aligned
+    };
+    static_assert(sizeof(BlobHeader) == 64, "Texture cache blob header must be 64 bytes");
+
+    static constexpr char MAGIC[4] = { 'O', 'G', 'T', 'C' };
+    static constexpr uint32_t VERSION = 1;
+
+    /* Get the cache file path for the key */
+    std::string blobPath(const uint64_t key) const;
+
+    std::string m_cacheDirectory;
+    bool m_enabled = true;
+
+    /* Lookups and stores may run on loader threads, statistics are guarded */
+    mutable std::mutex m_statisticsMutex;
+    unsigned int m_hits = 0;
+    unsigned int m_misses = 0;
+    double m_hitMilliseconds = 0.0;
+    double m_missMilliseconds = 0.0;
+};
@@ -0,0 +1,289 @@
+#include "AutoTiler.h"
+#include "../Renderer/Texture2D.h"
+#include "../System/JobSystem.h"
+
+#include <glm/common.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <limits>
+
+namespace Scene {
+    namespace {
+        /* Smaller maps are retiled on the calling thread, so small maps do not pay for the job system */
+        const size_t MIN_ROWS_PER_JOB = 64;
+
+        /* Disjoint dirty rectangles kept before the closest two are merged, scattered hits stay small uploads */
+        const size_t MAX_DIRTY_RECTS = 8;
+    }
+
+    /* Images named after the center one in the atlas */
+    AutoTiler::EdgeImages AutoTiler::EdgeImages::fromAtlas(const Renderer::Texture2D& atlas, const std::string& centerName) {
+        std::string suffix = centerName;
+        if (!suffix.empty()) {
+            suffix[0] = static_cast<char>(std::toupper(static_cast<unsigned char>(suffix[0])));
+        }
+        /* An unknown name gives the invalid subtexture ID, which is the empty image in 16 bits */
+        const auto image = [&atlas](const std::string& name) {
+            const Renderer::Texture2D::SubTextureId id = atlas.getSubTextureId(name);
+            return id == Renderer::Texture2D::INVALID_SUBTEXTURE_ID ? EMPTY_IMAGE : static_cast<CellImage>(id);
+        };
+        EdgeImages images;
+        images.center = image(centerName);
+        images.top = image("top" + suffix);
+        images.bottom = image("bottom" + suffix);
+        images.left = image("left" + suffix);
+        images.right = image("right" + suffix);
+        images.topLeft = image("topLeft" + suffix);
+        images.topRight = image("topRight" + suffix);
+        images.bottomLeft = image("bottomLeft" + suffix);
+        images.bottomRight = image("bottomRight" + suffix);
+        return images;
+    }
+
+    /* Create the auto-tiler of a map */
+    AutoTiler::AutoTiler(TileMap& tileMap)
+        : m_tileMap(tileMap)
+        , m_images(static_cast<size_t>(tileMap.columns()) * tileMap.rows(), EMPTY_IMAGE) {
+    }
+
+    /* Set the image of a tile type for every neighbour mask */
+    void AutoTiler::setImages(const TileMap::TileType type, const CellImage (&images)[MASKS_COUNT]) {
+        const size_t tableOffset = static_cast<size_t>(type) * MASKS_COUNT;
+        if (m_imageTables.size() < tableOffset + MASKS_COUNT) {
+            m_imageTables.resize(tableOffset + MASKS_COUNT, EMPTY_IMAGE);
+        }
+        std::copy(std::begin(images), std::end(images), m_imageTables.begin() + tableOffset);
+    }
+
+    /* Use one image for a tile type */
+    void AutoTiler::setImage(const TileMap::TileType type, const CellImage image) {
+        CellImage images[MASKS_COUNT];
+        std::fill(std::begin(images), std::end(images), image);
+        setImages(type, images);
+    }
+
+    /* Pick the image of a tile type by its exposed sides */
+    void AutoTiler::setEdgeImages(const TileMap::TileType type, const EdgeImages& edgeImages) {
+        CellImage images[MASKS_COUNT];
+        for (size_t mask = 0; mask < MASKS_COUNT; ++mask) {
+            const bool isTopExposed = !(mask & NORTH);
+            const bool isBottomExposed = !(mask & SOUTH);
+            const bool isLeftExposed = !(mask & WEST);
+            const bool isRightExposed = !(mask & EAST);
+            /* Cells exposed on opposite sides are thin walls, there is no edge image for them */
+            CellImage image = edgeImages.center;
+            if (isTopExposed != isBottomExposed && isLeftExposed != isRightExposed) {
+                image = isTopExposed ? (isLeftExposed ? edgeImages.topLeft : edgeImages.topRight)
+                                     : (isLeftExposed ? edgeImages.bottomLeft : edgeImages.bottomRight);
+            }
+            else if (isTopExposed != isBottomExposed && !isLeftExposed && !isRightExposed) {
+                image = isTopExposed ? edgeImages.top : edgeImages.bottom;
+            }
+            else if (isLeftExposed != isRightExposed && !isTopExposed && !isBottomExposed) {
+                image = isLeftExposed ? edgeImages.left : edgeImages.right;
+            }
+            images[mask] = image;
+        }
+        setImages(type, images);
+    }
+
+    /* Mask of the neighbours of a cell that have the same type */
+    uint8_t AutoTiler::neighbourMask(const int column, const int row) const {
+        const TileMap::TileType type = m_tileMap.getTile(column, row);
+        const auto isSame = [this, type](const int neighbourColumn, const int neighbourRow) {
+            return !m_tileMap.isInside(neighbourColumn, neighbourRow) || m_tileMap.getTile(neighbourColumn, neighbourRow) == type;
+        };
+        return (isSame(column, row + 1) ? NORTH : 0)
+             | (isSame(column + 1, row + 1) ? NORTH_EAST : 0)
+             | (isSame(column + 1, row) ? EAST : 0)
+             | (isSame(column + 1, row - 1) ? SOUTH_EAST : 0)
+             | (isSame(column, row - 1) ? SOUTH : 0)
+             | (isSame(column - 1, row - 1) ? SOUTH_WEST : 0)
+             | (isSame(column - 1, row) ? WEST : 0)
+             | (isSame(column - 1, row + 1) ? NORTH_WEST : 0);
+    }
+
+    /* Image of a cell for its current neighbours */
+    AutoTiler::CellImage AutoTiler::computeImage(const int column, const int row) const {
+        const TileMap::TileType type = m_tileMap.getTile(column, row);
+        const size_t tableOffset = static_cast<size_t>(type) * MASKS_COUNT;
+        if (type == TileMap::EMPTY_TILE || tableOffset >= m_imageTables.size()) {
+            return EMPTY_IMAGE;
+        }
+        return m_imageTables[tableOffset + neighbourMask(column, row)];
+    }
+
+    /* Change a cell and retile it with its 8 neighbours */
+    bool AutoTiler::setTile(const int column, const int row, const TileMap::TileType type) {
+        if (!m_tileMap.isInside(column, row)) {
+            return false;
+        }
+        m_lastChangedImagesCount = 0;
+        const TileMap::TileType oldType = m_tileMap.getTile(column, row);
+        const TileMap::SubCellMask oldSubCells = m_tileMap.getSubCells(column, row);
+        m_tileMap.setTile(column, row, type);
+        if (m_tileMap.getSubCells(column, row) != oldSubCells) {
+            markDirty(column, row);
+        }
+        if (type != oldType) {
+            retileNeighbourhood(column, row);
+        }
+        return true;
+    }
+
+    /* Chip sub-cells off a cell */
+    bool AutoTiler::chipSubCells(const int column, const int row, const TileMap::SubCellMask subCells) {
+        m_lastChangedImagesCount = 0;
+        if (!m_tileMap.chipSubCells(column, row, subCells)) {
+            return false;
+        }
+        markDirty(column, row);
+        if (m_tileMap.getTile(column, row) == TileMap::EMPTY_TILE) {
+            retileNeighbourhood(column, row);
+        }
+        return true;
+    }
+
+    /* Chip the sub-cells overlapped by a rectangle */
+    int AutoTiler::chipRect(const glm::vec2& min, const glm::vec2& max) {
+        glm::ivec2 first, last;
+        if (!m_tileMap.getCellRange(min, max, first, last)) {
+            m_lastChangedImagesCount = 0;
+            return 0;
+        }
+        int chippedCellsCount = 0;
+        size_t changedImagesCount = 0;
+        for (int row = first.y; row <= last.y; ++row) {
+            for (int column = first.x; column <= last.x; ++column) {
+                if (m_tileMap.getSubCells(column, row) != 0 && chipSubCells(column, row, m_tileMap.subCellsInRect(column, row, min, max))) {
+                    ++chippedCellsCount;
+                    changedImagesCount += m_lastChangedImagesCount;
+                }
+            }
+        }
+        m_lastChangedImagesCount = changedImagesCount;
+        return chippedCellsCount;
+    }
+
+    /* Retile a cell with its 8 neighbours */
+    void AutoTiler::retileNeighbourhood(const int column, const int row) {
+        /* Only the masks of the cell and its neighbours depend on the cell, and only changed images are uploaded */
+        const glm::ivec2 first = glm::max(glm::ivec2(column - 1, row - 1), glm::ivec2(0));
+        const glm::ivec2 last = glm::min(glm::ivec2(column + 1, row + 1), glm::ivec2(m_tileMap.columns() - 1, m_tileMap.rows() - 1));
+        for (int y = first.y; y <= last.y; ++y) {
+            for (int x = first.x; x <= last.x; ++x) {
+                CellImage& image = m_images[static_cast<size_t>(y) * m_tileMap.columns() + x];
+                const CellImage newImage = computeImage(x, y);
+                if (image != newImage) {
+                    image = newImage;
+                    markDirty(x, y);
+                    ++m_lastChangedImagesCount;
+                }
+            }
+        }
+    }
+
+    /* Retile the cells of a rectangle on the calling thread */
+    void AutoTiler::retile(const glm::ivec2& first, const glm::ivec2& last) {
+        const glm::ivec2 clampedFirst = glm::max(first, glm::ivec2(0));
+        const glm::ivec2 clampedLast = glm::min(last, glm::ivec2(m_tileMap.columns() - 1, m_tileMap.rows() - 1));
+        if (clampedFirst.x > clampedLast.x || clampedFirst.y > clampedLast.y) {
+            return;
+        }
+        for (int y = clampedFirst.y; y <= clampedLast.y; ++y) {
+            CellImage* rowImages = m_images.data() + static_cast<size_t>(y) * m_tileMap.columns();
+            for (int x = clampedFirst.x; x <= clampedLast.x; ++x) {
+                rowImages[x] = computeImage(x, y);
+            }
+        }
+        markDirty(clampedFirst, clampedLast);
+    }
+
+    /* Retile the whole map */
+    void AutoTiler::retileAll() {
+        if (m_images.empty()) {
+            return;
+        }
+        /* Every row only writes its own images, so the rows are independent */
+        System::JobSystem::instance().parallelFor(static_cast<size_t>(m_tileMap.rows()), MIN_ROWS_PER_JOB, [this](const size_t begin, const size_t end) {
+            retileRows(static_cast<int>(begin), static_cast<int>(end));
+        });
+        markDirty(glm::ivec2(0), glm::ivec2(m_tileMap.columns() - 1, m_tileMap.rows() - 1));
+    }
+
+    /* Retile rows [beginRow, endRow) */
+    void AutoTiler::retileRows(const int beginRow, const int endRow) {
+        const int columns = m_tileMap.columns();
+        for (int y = beginRow; y < endRow; ++y) {
+            CellImage* rowImages = m_images.data() + static_cast<size_t>(y) * columns;
+            for (int x = 0; x < columns; ++x) {
+                rowImages[x] = computeImage(x, y);
+            }
+        }
+    }
+
+    /* Add a cell to the dirty rectangles */
+    void AutoTiler::markDirty(const int column, const int row) {
+        markDirty(glm::ivec2(column, row), glm::ivec2(column, row));
+    }
+
+    /* Add a rectangle of cells to the dirty rectangles */
+    void AutoTiler::markDirty(const glm::ivec2& first, const glm::ivec2& last) {
+        /* Rectangles that overlap or touch the new one are merged into it, the merged one may reach further rectangles */
+        DirtyRect rect{ first, last };
+        for (size_t i = 0; i < m_dirtyRects.size(); ) {
+            const DirtyRect& other = m_dirtyRects[i];
+            if (other.first.x <= rect.last.x + 1 && rect.first.x <= other.last.x + 1 &&
+                other.first.y <= rect.last.y + 1 && rect.first.y <= other.last.y + 1) {
+                rect.first = glm::min(rect.first, other.first);
+                rect.last = glm::max(rect.last, other.last);
+                m_dirtyRects[i] = m_dirtyRects.back();
+                m_dirtyRects.pop_back();
+                i = 0;
+            }
+            else {
+                ++i;
+            }
+        }
+        if (m_dirtyRects.size() < MAX_DIRTY_RECTS) {
+            m_dirtyRects.push_back(rect);
+            return;
+        }
+
+        /* The list is full: the new rectangle goes into the one whose bounding rectangle grows the least */
+        const auto area = [](const glm::ivec2& first, const glm::ivec2& last) {
+            return static_cast<int64_t>(last.x - first.x + 1) * (last.y - first.y + 1);
+        };
+        size_t bestIndex = 0;
+        int64_t bestGrowth = std::numeric_limits<int64_t>::max();
+        for (size_t i = 0; i < m_dirtyRects.size(); ++i) {
+            const DirtyRect& other = m_dirtyRects[i];
+            const int64_t growth = area(glm::min(rect.first, other.first), glm::max(rect.last, other.last)) - area(other.first, other.last);
+            if (growth < bestGrowth) {
+                bestGrowth = growth;
+                bestIndex = i;
+            }
+        }
+        const DirtyRect merged{ glm::min(rect.first, m_dirtyRects[bestIndex].first), glm::max(rect.last, m_dirtyRects[bestIndex].last) };
+        m_dirtyRects[bestIndex] = m_dirtyRects.back();
+        m_dirtyRects.pop_back();
+        markDirty(merged.first, merged.last);
+    }
+
+    /* Take one of the dirty rectangles */
+    bool AutoTiler::takeDirtyRect(glm::ivec2& first, glm::ivec2& last) {
+        if (m_dirtyRects.empty()) {
+            return false;
+        }
+        first = m_dirtyRects.back().first;
+        last = m_dirtyRects.back().last;
+        m_dirtyRects.pop_back();
+        return true;
+    }
+
+    /* Forget the dirty rectangles */
+    void AutoTiler::clearDirtyRects() {
+        m_dirtyRects.clear();
+    }
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "TileMap.h"
+
+#include <glm/vec2.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Renderer {
+    class Texture2D;
+}
+
+namespace Scene {
+    /*
+    Picks the image of every cell of a tile map from its neighbours. A cell gets an 8-bit mask of the neighbours
+    of the same type, and a table of its type maps the mask to an atlas subtexture ID. Changing a cell only retiles
+    the cell and its 8 neighbours, and the changed cells are collected into a dirty rectangle, so the renderer
+    uploads only them. Chipped sub-cells do not change images, the renderer masks them out
+    */
+    class AutoTiler {
+    public:
+        /* Image of a cell: a subtexture ID of the atlas, or EMPTY_IMAGE for cells that are not drawn */
+        typedef uint16_t CellImage;
+        static constexpr CellImage EMPTY_IMAGE = 0xFFFF;
+
+        /* Bits of the neighbour mask */
+        enum Neighbour : uint8_t {
+            NORTH = 1 << 0,
+            NORTH_EAST = 1 << 1,
+            EAST = 1 << 2,
+            SOUTH_EAST = 1 << 3,
+            SOUTH = 1 << 4,
+            SOUTH_WEST = 1 << 5,
+            WEST = 1 << 6,
+            NORTH_WEST = 1 << 7
+        };
+        static constexpr size_t MASKS_COUNT = 256;
+
+        /* Images of a tile type with exposed edges, named by the sides that have no neighbour of the same type */
+        struct EdgeImages {
+            CellImage center = EMPTY_IMAGE;
+            CellImage top = EMPTY_IMAGE;
+            CellImage bottom = EMPTY_IMAGE;
+            CellImage left = EMPTY_IMAGE;
+            CellImage right = EMPTY_IMAGE;
+            CellImage topLeft = EMPTY_IMAGE;
+            CellImage topRight = EMPTY_IMAGE;
+            CellImage bottomLeft = EMPTY_IMAGE;
+            CellImage bottomRight = EMPTY_IMAGE;
+
+            /*
+            Images named after the center one in the atlas: e.g. "brick", "topBrick", "bottomBrick", ..., "bottomRightBrick".
+            Images missing in the atlas are empty
+            */
+            static EdgeImages fromAtlas(const Renderer::Texture2D& atlas, const std::string& centerName);
+        };
+
+        /* The auto-tiler keeps the images of the cells of the map, all of them empty until the first retile */
+        explicit AutoTiler(TileMap& tileMap);
+
+        /* Set the image of a tile type for every neighbour mask */
+        void setImages(const TileMap::TileType type, const CellImage (&images)[MASKS_COUNT]);
+        /* Use one image for a tile type whatever its neighbours are */
+        void setImage(const TileMap::TileType type, const CellImage image);
+        /*
+        Pick the image of a tile type by its exposed sides: a side is exposed when the cell next to it has another type.
+        Only the four sides are looked at, shapes that do not have an edge image (e.g. a lone cell) use the center one
+        */
+        void setEdgeImages(const TileMap::TileType type, const EdgeImages& images);
+
+        /* Mask of the neighbours of a cell that have the same type. Cells outside of the map count as neighbours */
+        uint8_t neighbourMask(const int column, const int row) const;
+
+        /*
+        Change a cell (with all of its sub-cells) and retile it with its 8 neighbours.
+        Returns false if the cell is outside of the map
+        */
+        bool setTile(const int column, const int row, const TileMap::TileType type);
+        /*
+        Chip sub-cells off a cell. Only the sub-cells of the cell change, unless it loses the last of them and becomes
+        empty: then it is retiled with its neighbours. Returns true if any sub-cell was cleared
+        */
+        bool chipSubCells(const int column, const int row, const TileMap::SubCellMask subCells);
+        /* Chip the sub-cells overlapped by a rectangle in world coordinates, e.g. a shell. Returns the number of chipped cells */
+        int chipRect(const glm::vec2& min, const glm::vec2& max);
+        /* Retile the cells of a rectangle (first and last inclusive) on the calling thread */
+        void retile(const glm::ivec2& first, const glm::ivec2& last);
+        /* Retile the whole map, rows are split between the worker threads of the job system */
+        void retileAll();
+
+        /* Images of the cells, row by row from the bottom like the tiles of the map */
+        const CellImage* images() const { return m_images.data(); }
+        CellImage getImage(const int column, const int row) const {
+            return m_tileMap.isInside(column, row) ? m_images[static_cast<size_t>(row) * m_tileMap.columns() + column] : EMPTY_IMAGE;
+        }
+        const TileMap& tileMap() const { return m_tileMap; }
+
+        /*
+        Take one rectangle of the cells whose images or sub-cells changed (first and last inclusive). Changed cells are kept
+        in a few disjoint rectangles, call until it returns false to get all of them
+        */
+        bool takeDirtyRect(glm::ivec2& first, glm::ivec2& last);
+        /* Forget the changed cells, e.g. after uploading the whole map */
+        void clearDirtyRects();
+        /* Number of images changed by the last setTile(), chipSubCells() or chipRect() */
+        size_t lastChangedImagesCount() const { return m_lastChangedImagesCount; }
+
+    private:
+        /* Image of a cell for its current neighbours */
+        CellImage computeImage(const int column, const int row) const;
+        /* Retile a cell with its 8 neighbours, tracking the changed images */
+        void retileNeighbourhood(const int column, const int row);
+        /* Retile rows [beginRow, endRow) without tracking changes */
+        void retileRows(const int beginRow, const int endRow);
+        /* Add a cell to the dirty rectangles */
+        void markDirty(const int column, const int row);
+        /* Add a rectangle of cells to the dirty rectangles, merging it with the ones it overlaps or touches */
+        void markDirty(const glm::ivec2& first, const glm::ivec2& last);
+
+        TileMap& m_tileMap;
+        std::vector <CellImage> m_images;
+        /* MASKS_COUNT images of every tile type that has images */
+        std::vector <CellImage> m_imageTables;
+        /* Changed cells, first and last inclusive */
+        struct DirtyRect {
+            glm::ivec2 first;
+            glm::ivec2 last;
+        };
+        std::vector <DirtyRect> m_dirtyRects;
+        size_t m_lastChangedImagesCount = 0;
+    };
+}
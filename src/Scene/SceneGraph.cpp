@@ -0,0 +1,273 @@
+#include "SceneGraph.h"
+
+#include <glm/trigonometric.hpp>
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace Scene {
+    namespace {
+        /* Matrix of translation * rotation * scale in homogeneous 2D coordinates */
+        glm::mat3 localMatrix(const LocalTransform& transform) {
+            const float radians = glm::radians(transform.rotation);
+            const float c = std::cos(radians);
+            const float s = std::sin(radians);
+            return glm::mat3(c * transform.scale.x, s * transform.scale.x, 0.f,
+                             -s * transform.scale.y, c * transform.scale.y, 0.f,
+                             transform.position.x, transform.position.y, 1.f);
+        }
+    }
+
+    /* Create a node as the last child of the parent */
+    NodeHandle SceneGraph::createNode(const NodeHandle parent, const LocalTransform& localTransform) {
+        if (parent.isValid() && !m_nodes.contains(parent)) {
+            std::cerr << "Can not create a scene node under a destroyed parent" << std::endl;
+            return NodeHandle{};
+        }
+        /* The node is appended to the arrays and takes its breadth-first place at the next update */
+        NodeRecord record;
+        record.index = static_cast<uint32_t>(m_handles.size());
+        const NodeHandle node = m_nodes.insert(record);
+        m_handles.push_back(node);
+        m_parents.push_back(INVALID_INDEX);
+        m_firstChildren.push_back(0);
+        m_childCounts.push_back(0);
+        m_localTransforms.push_back(localTransform);
+        m_worldMatrices.push_back(glm::mat3(1.f));
+        m_updateStamps.push_back(0);
+        m_isDirty.push_back(0);
+        link(node, parent);
+        m_isOrderDirty = true;
+        return node;
+    }
+
+    /* Destroy a node with its subtree */
+    bool SceneGraph::destroyNode(const NodeHandle node) {
+        if (!m_nodes.contains(node)) {
+            return false;
+        }
+        unlink(node);
+        /* Release the subtree depth-first. The array entries are dropped by the next rebuild of the order */
+        m_orderScratch.clear();
+        m_orderScratch.push_back(node);
+        while (!m_orderScratch.empty()) {
+            const NodeHandle current = m_orderScratch.back();
+            m_orderScratch.pop_back();
+            for (NodeHandle child = m_nodes.get(current)->firstChild; child.isValid(); child = m_nodes.get(child)->nextSibling) {
+                m_orderScratch.push_back(child);
+            }
+            m_nodes.erase(current);
+        }
+        m_isOrderDirty = true;
+        return true;
+    }
+
+    /* Move a node with its subtree under another parent */
+    bool SceneGraph::setParent(const NodeHandle node, const NodeHandle parent) {
+        if (!m_nodes.contains(node) || (parent.isValid() && !m_nodes.contains(parent))) {
+            return false;
+        }
+        /* A node can not become a descendant of itself */
+        for (NodeHandle ancestor = parent; ancestor.isValid(); ancestor = m_nodes.get(ancestor)->parent) {
+            if (ancestor == node) {
+                std::cerr << "Can not move a scene node into its own subtree" << std::endl;
+                return false;
+            }
+        }
+        unlink(node);
+        link(node, parent);
+        m_isOrderDirty = true;
+        return true;
+    }
+
+    /* Link a node as the last child of the parent or as the last root */
+    void SceneGraph::link(const NodeHandle node, const NodeHandle parent) {
+        NodeRecord& record = *m_nodes.get(node);
+        NodeHandle& lastSibling = parent.isValid() ? m_nodes.get(parent)->lastChild : m_lastRoot;
+        NodeHandle& firstSibling = parent.isValid() ? m_nodes.get(parent)->firstChild : m_firstRoot;
+        record.parent = parent;
+        record.previousSibling = lastSibling;
+        record.nextSibling = NodeHandle{};
+        if (lastSibling.isValid()) {
+            m_nodes.get(lastSibling)->nextSibling = node;
+        }
+        else {
+            firstSibling = node;
+        }
+        lastSibling = node;
+    }
+
+    /* Unlink a node from its parent or from the roots */
+    void SceneGraph::unlink(const NodeHandle node) {
+        NodeRecord& record = *m_nodes.get(node);
+        NodeHandle& firstSibling = record.parent.isValid() ? m_nodes.get(record.parent)->firstChild : m_firstRoot;
+        NodeHandle& lastSibling = record.parent.isValid() ? m_nodes.get(record.parent)->lastChild : m_lastRoot;
+        if (record.previousSibling.isValid()) {
+            m_nodes.get(record.previousSibling)->nextSibling = record.nextSibling;
+        }
+        else {
+            firstSibling = record.nextSibling;
+        }
+        if (record.nextSibling.isValid()) {
+            m_nodes.get(record.nextSibling)->previousSibling = record.previousSibling;
+        }
+        else {
+            lastSibling = record.previousSibling;
+        }
+        record.parent = NodeHandle{};
+        record.previousSibling = NodeHandle{};
+        record.nextSibling = NodeHandle{};
+    }
+
+    /* Get the local transformation of a node */
+    const LocalTransform* SceneGraph::getLocalTransform(const NodeHandle node) const {
+        const NodeRecord* pRecord = m_nodes.get(node);
+        return pRecord ? &m_localTransforms[pRecord->index] : nullptr;
+    }
+
+    /* Set the local transformation of a node */
+    bool SceneGraph::setLocalTransform(const NodeHandle node, const LocalTransform& localTransform) {
+        const NodeRecord* pRecord = m_nodes.get(node);
+        if (!pRecord) {
+            return false;
+        }
+        m_localTransforms[pRecord->index] = localTransform;
+        markDirty(pRecord->index);
+        return true;
+    }
+
+    /* Set the local position of a node */
+    bool SceneGraph::setLocalPosition(const NodeHandle node, const glm::vec2& position) {
+        const NodeRecord* pRecord = m_nodes.get(node);
+        if (!pRecord) {
+            return false;
+        }
+        m_localTransforms[pRecord->index].position = position;
+        markDirty(pRecord->index);
+        return true;
+    }
+
+    /* Set the local rotation of a node */
+    bool SceneGraph::setLocalRotation(const NodeHandle node, const float rotation) {
+        const NodeRecord* pRecord = m_nodes.get(node);
+        if (!pRecord) {
+            return false;
+        }
+        m_localTransforms[pRecord->index].rotation = rotation;
+        markDirty(pRecord->index);
+        return true;
+    }
+
+    /* Mark the node's local transformation changed */
+    void SceneGraph::markDirty(const uint32_t index) {
+        /* After a structural change every world matrix is recomputed anyway */
+        if (!m_isOrderDirty && !m_isDirty[index]) {
+            m_isDirty[index] = 1;
+            m_dirtyNodes.push_back(index);
+        }
+    }
+
+    /* Put the nodes into breadth-first order */
+    void SceneGraph::rebuildOrder() {
+        /* Breadth-first traversal: roots first, then the children of every node in order */
+        m_orderScratch.clear();
+        for (NodeHandle root = m_firstRoot; root.isValid(); root = m_nodes.get(root)->nextSibling) {
+            m_orderScratch.push_back(root);
+        }
+        std::vector <uint32_t> parents(m_nodes.size(), INVALID_INDEX);
+        std::vector <uint32_t> firstChildren(m_nodes.size(), 0);
+        std::vector <uint32_t> childCounts(m_nodes.size(), 0);
+        std::vector <LocalTransform> localTransforms(m_nodes.size());
+        for (size_t i = 0; i < m_orderScratch.size(); ++i) {
+            const NodeHandle node = m_orderScratch[i];
+            NodeRecord& record = *m_nodes.get(node);
+            firstChildren[i] = static_cast<uint32_t>(m_orderScratch.size());
+            for (NodeHandle child = record.firstChild; child.isValid(); child = m_nodes.get(child)->nextSibling) {
+                parents[m_orderScratch.size()] = static_cast<uint32_t>(i);
+                m_orderScratch.push_back(child);
+            }
+            childCounts[i] = static_cast<uint32_t>(m_orderScratch.size()) - firstChildren[i];
+            localTransforms[i] = m_localTransforms[record.index];
+            record.index = static_cast<uint32_t>(i);
+        }
+
+        m_handles.assign(m_orderScratch.begin(), m_orderScratch.end());
+        m_parents = std::move(parents);
+        m_firstChildren = std::move(firstChildren);
+        m_childCounts = std::move(childCounts);
+        m_localTransforms = std::move(localTransforms);
+        m_worldMatrices.resize(m_handles.size());
+        m_updateStamps.assign(m_handles.size(), 0);
+        m_isDirty.assign(m_handles.size(), 0);
+        m_dirtyNodes.clear();
+    }
+
+    /* Recompute the world matrix of the node at the index */
+    void SceneGraph::updateWorldMatrix(const uint32_t index) {
+        const uint32_t parent = m_parents[index];
+        m_worldMatrices[index] = parent == INVALID_INDEX ? localMatrix(m_localTransforms[index])
+                                                         : m_worldMatrices[parent] * localMatrix(m_localTransforms[index]);
+        m_updateStamps[index] = m_updateStamp;
+    }
+
+    /* Recompute the world matrices of changed subtrees */
+    void SceneGraph::update() {
+        ++m_updateStamp;
+        m_updatedNodesCount = 0;
+
+        /* After a structural change the whole hierarchy is one linear pass, parents always come first */
+        if (m_isOrderDirty) {
+            rebuildOrder();
+            for (uint32_t i = 0; i < m_handles.size(); ++i) {
+                updateWorldMatrix(i);
+            }
+            m_updatedNodesCount = m_handles.size();
+            m_isOrderDirty = false;
+            return;
+        }
+
+        /* Ancestors have lower indices, so after sorting a changed node is reached before its changed descendants */
+        std::sort(m_dirtyNodes.begin(), m_dirtyNodes.end());
+        for (const uint32_t dirtyNode : m_dirtyNodes) {
+            m_isDirty[dirtyNode] = 0;
+            if (m_updateStamps[dirtyNode] == m_updateStamp) {
+                continue;   // Already updated with the subtree of a changed ancestor
+            }
+            /* The subtree is a contiguous range on every level below the node */
+            uint32_t begin = dirtyNode;
+            uint32_t end = dirtyNode + 1;
+            while (begin < end) {
+                for (uint32_t i = begin; i < end; ++i) {
+                    updateWorldMatrix(i);
+                }
+                m_updatedNodesCount += end - begin;
+                const uint32_t nextBegin = m_firstChildren[begin];
+                end = m_firstChildren[end - 1] + m_childCounts[end - 1];
+                begin = nextBegin;
+            }
+        }
+        m_dirtyNodes.clear();
+    }
+
+    /* World matrix of a node */
+    const glm::mat3* SceneGraph::getWorldMatrix(const NodeHandle node) const {
+        const NodeRecord* pRecord = m_nodes.get(node);
+        return pRecord ? &m_worldMatrices[pRecord->index] : nullptr;
+    }
+
+    /* World transformation of a node */
+    WorldTransform SceneGraph::getWorldTransform(const NodeHandle node) const {
+        WorldTransform transform;
+        const glm::mat3* pMatrix = getWorldMatrix(node);
+        if (!pMatrix) {
+            return transform;
+        }
+        const glm::mat3& matrix = *pMatrix;
+        transform.position = glm::vec2(matrix[2]);
+        transform.scale = glm::vec2(glm::length(glm::vec2(matrix[0])), glm::length(glm::vec2(matrix[1])));
+        transform.rotation = glm::degrees(std::atan2(matrix[0].y, matrix[0].x));
+        return transform;
+    }
+}
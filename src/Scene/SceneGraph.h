@@ -0,0 +1,113 @@
+#pragma once
+
+#include "../System/HandlePool.h"
+
+#include <glm/vec2.hpp>
+#include <glm/mat3x3.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace Scene {
+    struct SceneNodeTag {};
+    typedef System::Handle<SceneNodeTag> NodeHandle;
+
+    /* Transformation of a node relative to its parent. Rotation is in degrees, as in Renderer::Sprite */
+    struct LocalTransform {
+        glm::vec2 position = glm::vec2(0.f);
+        glm::vec2 scale = glm::vec2(1.f);
+        float rotation = 0.f;
+    };
+
+    /* World transformation decomposed into position, rotation and scale */
+    struct WorldTransform {
+        glm::vec2 position = glm::vec2(0.f);
+        glm::vec2 scale = glm::vec2(1.f);
+        float rotation = 0.f;
+    };
+
+    /*
+    Hierarchy of 2D transformations. Nodes are stored breadth-first in contiguous arrays, so parents precede
+    their children and the children of consecutive nodes are consecutive. update() recomputes world matrices
+    only of the nodes whose local transformations changed and of their subtrees, level by level, as linear passes.
+    Adding, removing or reparenting nodes rebuilds the order once at the next update()
+    */
+    class SceneGraph {
+    public:
+        static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+        /* Create a node as the last child of the parent (a root node if the parent is invalid) */
+        NodeHandle createNode(const NodeHandle parent = NodeHandle{}, const LocalTransform& localTransform = LocalTransform());
+        /* Destroy a node with its subtree */
+        bool destroyNode(const NodeHandle node);
+        /* Move a node with its subtree under another parent (to the roots if the parent is invalid) */
+        bool setParent(const NodeHandle node, const NodeHandle parent);
+        bool isAlive(const NodeHandle node) const { return m_nodes.contains(node); }
+
+        /* Local transformation of a node */
+        const LocalTransform* getLocalTransform(const NodeHandle node) const;
+        bool setLocalTransform(const NodeHandle node, const LocalTransform& localTransform);
+        bool setLocalPosition(const NodeHandle node, const glm::vec2& position);
+        bool setLocalRotation(const NodeHandle node, const float rotation);
+
+        /* Recompute the world matrices of changed subtrees */
+        void update();
+
+        /* World matrix of a node as of the last update(). Returns nullptr for stale handles */
+        const glm::mat3* getWorldMatrix(const NodeHandle node) const;
+        /* World transformation of a node as of the last update() */
+        WorldTransform getWorldTransform(const NodeHandle node) const;
+
+        /* Number of nodes */
+        size_t size() const { return m_nodes.size(); }
+        /* Number of world matrices recomputed by the last update() */
+        size_t updatedNodesCount() const { return m_updatedNodesCount; }
+
+    private:
+        /* Tree links of a node and its position in the breadth-first arrays */
+        struct NodeRecord {
+            NodeHandle parent;
+            NodeHandle firstChild;
+            NodeHandle lastChild;
+            NodeHandle previousSibling;
+            NodeHandle nextSibling;
+            uint32_t index = INVALID_INDEX;
+        };
+
+        /* Link a node as the last child of the parent or as the last root */
+        void link(const NodeHandle node, const NodeHandle parent);
+        /* Unlink a node from its parent or from the roots */
+        void unlink(const NodeHandle node);
+        /* Mark the node's local transformation changed */
+        void markDirty(const uint32_t index);
+        /* Put the nodes into breadth-first order */
+        void rebuildOrder();
+        /* Recompute the world matrix of the node at the index */
+        void updateWorldMatrix(const uint32_t index);
+
+        System::HandlePool <NodeRecord, SceneNodeTag> m_nodes;
+        NodeHandle m_firstRoot;
+        NodeHandle m_lastRoot;
+        bool m_isOrderDirty = false;
+
+        /* Breadth-first arrays */
+        std::vector <NodeHandle> m_handles;
+        std::vector <uint32_t> m_parents;
+        std::vector <uint32_t> m_firstChildren;     // Children of the node at i are [m_firstChildren[i], m_firstChildren[i] + m_childCounts[i])
+        std::vector <uint32_t> m_childCounts;
+        std::vector <LocalTransform> m_localTransforms;
+        std::vector <glm::mat3> m_worldMatrices;
+        std::vector <uint32_t> m_updateStamps;      // Last update that recomputed the node
+
+        /* Nodes changed since the last update */
+        std::vector <uint32_t> m_dirtyNodes;
+        std::vector <uint8_t> m_isDirty;
+
+        /* Scratch storage of rebuildOrder(), kept to avoid reallocations */
+        std::vector <NodeHandle> m_orderScratch;
+
+        uint32_t m_updateStamp = 0;
+        size_t m_updatedNodesCount = 0;
+    };
+}
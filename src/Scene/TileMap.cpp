@@ -0,0 +1,95 @@
+#include "TileMap.h"
+
+#include <glm/common.hpp>
+
+#include <algorithm>
+#include <random>
+
+namespace Scene {
+    /* Create an empty map */
+    TileMap::TileMap(const int columns, const int rows, const glm::vec2& tileSize, const glm::vec2& origin)
+        : m_columns(std::max(columns, 0))
+        , m_rows(std::max(rows, 0))
+        , m_tileSize(tileSize)
+        , m_origin(origin)
+        , m_tiles(static_cast<size_t>(m_columns) * m_rows, EMPTY_TILE)
+        , m_subCells(m_tiles.size(), 0) {
+    }
+
+    /* Set the tile of a cell with all of its sub-cells */
+    void TileMap::setTile(const int column, const int row, const TileType type) {
+        if (isInside(column, row)) {
+            const size_t index = static_cast<size_t>(row) * m_columns + column;
+            m_tiles[index] = type;
+            m_subCells[index] = type != EMPTY_TILE ? FULL_SUB_CELLS : 0;
+        }
+    }
+
+    /* Fill the map with walls and solid blocks of 3x3 cells */
+    void TileMap::fillWithBlocks(const uint32_t seed, const TileType wallType, const TileType blockType) {
+        /* The block kinds come from the raw generator output, std distributions differ between standard libraries */
+        std::mt19937 random(seed);
+        for (int blockRow = 0; blockRow < m_rows; blockRow += 4) {
+            for (int blockColumn = 0; blockColumn < m_columns; blockColumn += 4) {
+                const uint32_t kind = random() % 8;
+                const TileType type = kind < 4 ? wallType : (kind == 4 ? blockType : EMPTY_TILE);
+                for (int row = blockRow; row < blockRow + 3; ++row) {
+                    for (int column = blockColumn; column < blockColumn + 3; ++column) {
+                        setTile(column, row, type);
+                    }
+                }
+            }
+        }
+    }
+
+    /* Clear sub-cells of a cell */
+    bool TileMap::chipSubCells(const int column, const int row, const SubCellMask subCells) {
+        if (!isInside(column, row)) {
+            return false;
+        }
+        const size_t index = static_cast<size_t>(row) * m_columns + column;
+        const SubCellMask remainingSubCells = m_subCells[index] & ~subCells;
+        if (remainingSubCells == m_subCells[index]) {
+            return false;
+        }
+        m_subCells[index] = remainingSubCells;
+        if (remainingSubCells == 0) {
+            m_tiles[index] = EMPTY_TILE;
+        }
+        return true;
+    }
+
+    /* Cell that contains the point */
+    glm::ivec2 TileMap::cellAt(const glm::vec2& point) const {
+        return glm::ivec2(glm::floor((point - m_origin) / m_tileSize));
+    }
+
+    /* Cells overlapped by the rectangle, clamped to the map */
+    bool TileMap::getCellRange(const glm::vec2& min, const glm::vec2& max, glm::ivec2& first, glm::ivec2& last) const {
+        first = glm::max(cellAt(min), glm::ivec2(0));
+        last = glm::min(cellAt(max), glm::ivec2(m_columns - 1, m_rows - 1));
+        return first.x <= last.x && first.y <= last.y;
+    }
+
+    /* Sub-cells of a cell overlapped by a rectangle */
+    TileMap::SubCellMask TileMap::subCellsInRect(const int column, const int row, const glm::vec2& min, const glm::vec2& max) const {
+        const glm::vec2 cellMin = cellPosition(column, row);
+        const glm::vec2 scale = static_cast<float>(SUB_CELLS) / m_tileSize;
+        const glm::ivec2 first = glm::clamp(glm::ivec2(glm::floor((min - cellMin) * scale)), glm::ivec2(0), glm::ivec2(SUB_CELLS - 1));
+        const glm::ivec2 last = glm::clamp(glm::ivec2(glm::floor((max - cellMin) * scale)), glm::ivec2(0), glm::ivec2(SUB_CELLS - 1));
+        /* Bits of the overlapped columns in one row, repeated in every overlapped row */
+        const unsigned int rowBits = (2u << last.x) - (1u << first.x);
+        unsigned int subCells = 0;
+        for (int y = first.y; y <= last.y; ++y) {
+            subCells |= rowBits << (y * SUB_CELLS);
+        }
+        return static_cast<SubCellMask>(subCells);
+    }
+
+    /* Check whether a point is inside a solid sub-cell */
+    bool TileMap::isSolidAt(const glm::vec2& point) const {
+        const glm::ivec2 cell = cellAt(point);
+        const SubCellMask subCells = getSubCells(cell.x, cell.y);
+        return subCells != 0 && (subCells & subCellsInRect(cell.x, cell.y, point, point)) != 0;
+    }
+}
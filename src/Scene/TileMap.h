@@ -0,0 +1,97 @@
+#pragma once
+
+#include <glm/vec2.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Scene {
+    /*
+    Grid of static tiles. A cell holds the tile type and a 4x4 mask of its solid sub-cells, so a large map costs
+    three bytes per cell and queries read cells directly instead of going through per-tile objects.
+    Cell (0, 0) is at the origin and rows go up, as world coordinates do
+    */
+    class TileMap {
+    public:
+        /* Tile type of a cell. Type 0 is an empty cell, all other types are solid */
+        typedef uint8_t TileType;
+        static constexpr TileType EMPTY_TILE = 0;
+
+        /*
+        Solid sub-cells of a cell: sub-cell (x, y) counted from the lower left corner is bit y * SUB_CELLS + x.
+        Tiles are set whole, and chipping off their last sub-cell empties the cell
+        */
+        typedef uint16_t SubCellMask;
+        static constexpr int SUB_CELLS = 4;
+        static constexpr SubCellMask FULL_SUB_CELLS = 0xFFFF;
+
+        /* Create an empty map of columns x rows cells of tileSize world units with the lower left corner at the origin */
+        TileMap(const int columns, const int rows, const glm::vec2& tileSize, const glm::vec2& origin = glm::vec2(0.f));
+
+        int columns() const { return m_columns; }
+        int rows() const { return m_rows; }
+        const glm::vec2& tileSize() const { return m_tileSize; }
+        const glm::vec2& origin() const { return m_origin; }
+
+        /* Tile of a cell. Cells outside of the map are empty */
+        TileType getTile(const int column, const int row) const {
+            return isInside(column, row) ? m_tiles[static_cast<size_t>(row) * m_columns + column] : EMPTY_TILE;
+        }
+        /* Set the tile of a cell with all of its sub-cells. Cells outside of the map are ignored */
+        void setTile(const int column, const int row, const TileType type);
+        /*
+        Fill the map with walls in blocks of 3x3 cells on a grid of 4 cells, so most tiles have neighbours and edges are
+        common: half of the blocks are walls, an eighth are solid blocks and the rest are empty. The same seed gives the same map
+        */
+        void fillWithBlocks(const uint32_t seed, const TileType wallType, const TileType blockType);
+        /* Solid sub-cells of a cell. Cells outside of the map have none */
+        SubCellMask getSubCells(const int column, const int row) const {
+            return isInside(column, row) ? m_subCells[static_cast<size_t>(row) * m_columns + column] : 0;
+        }
+        /*
+        Clear sub-cells of a cell, the cell becomes empty when none are left.
+        Returns true if any sub-cell was cleared
+        */
+        bool chipSubCells(const int column, const int row, const SubCellMask subCells);
+        bool isSolid(const int column, const int row) const { return getTile(column, row) != EMPTY_TILE; }
+        bool isInside(const int column, const int row) const { return column >= 0 && row >= 0 && column < m_columns && row < m_rows; }
+
+        /* Cell that contains the point (may be outside of the map) */
+        glm::ivec2 cellAt(const glm::vec2& point) const;
+        /*
+        Cells overlapped by the rectangle, clamped to the map: first and last are inclusive.
+        Returns false if the rectangle is outside of the map
+        */
+        bool getCellRange(const glm::vec2& min, const glm::vec2& max, glm::ivec2& first, glm::ivec2& last) const;
+        /* Lower left corner of a cell in world coordinates */
+        glm::vec2 cellPosition(const int column, const int row) const { return m_origin + glm::vec2(column, row) * m_tileSize; }
+        /*
+        Sub-cells of a cell overlapped by a rectangle that overlaps the cell (solid or not). Like getCellRange(),
+        edges count as overlapping
+        */
+        SubCellMask subCellsInRect(const int column, const int row, const glm::vec2& min, const glm::vec2& max) const;
+        /* Check whether a rectangle that overlaps the cell overlaps a solid sub-cell of it */
+        bool overlapsSolid(const int column, const int row, const glm::vec2& min, const glm::vec2& max) const {
+            const SubCellMask subCells = getSubCells(column, row);
+            return subCells == FULL_SUB_CELLS || (subCells & subCellsInRect(column, row, min, max)) != 0;
+        }
+        /* Check whether a point is inside a solid sub-cell */
+        bool isSolidAt(const glm::vec2& point) const;
+
+        /* Tiles row by row from the bottom */
+        const TileType* data() const { return m_tiles.data(); }
+        /* Sub-cell masks row by row from the bottom */
+        const SubCellMask* subCells() const { return m_subCells.data(); }
+        /* System memory used by the tiles */
+        size_t sizeInBytes() const { return m_tiles.size() * sizeof(TileType) + m_subCells.size() * sizeof(SubCellMask); }
+
+    private:
+        int m_columns;
+        int m_rows;
+        glm::vec2 m_tileSize;
+        glm::vec2 m_origin;
+        std::vector <TileType> m_tiles;
+        std::vector <SubCellMask> m_subCells;
+    };
+}
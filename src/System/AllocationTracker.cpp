@@ -0,0 +1,327 @@
+#include "AllocationTracker.h"
+
+#include <ostream>
+
+#ifdef ALLOCATION_TRACKING
+
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define ALLOCATION_CALLER _ReturnAddress()
+#else
+#define ALLOCATION_CALLER __builtin_return_address(0)
+#endif
+
+#if defined(__has_include)
+#if __has_include(<dlfcn.h>) && __has_include(<cxxabi.h>)
+#include <dlfcn.h>
+#include <cxxabi.h>
+#define ALLOCATION_SYMBOLS
+#endif
+#endif
+
+namespace System {
+    namespace {
+        /*
+        All state is statically allocated: the tracker runs inside operator new and must not allocate itself.
+        Each counter is written by its own thread and read by the thread that closes the frame
+        */
+        struct ThreadCounters {
+            std::atomic<uint64_t> allocations{ 0 };
+            std::atomic<uint64_t> bytes{ 0 };
+            std::atomic<uint64_t> hotScopeAllocations{ 0 };
+        };
+        ThreadCounters s_threadCounters[AllocationTracker::MAX_THREADS];
+
+        /* Call sites are the return addresses of operator new, kept in an open-addressing table */
+        struct CallSite {
+            std::atomic<uintptr_t> address{ 0 };
+            std::atomic<uint64_t> allocations{ 0 };
+            std::atomic<uint64_t> bytes{ 0 };
+        };
+        CallSite s_callSites[AllocationTracker::MAX_CALL_SITES];
+        std::atomic<uint64_t> s_untrackedCallSiteAllocations{ 0 };  // Allocations from call sites that did not fit into the table
+
+        /* Cumulative values at the end of the previous frame and the differences for the last frame */
+        AllocationTracker::Counters s_previousThreadTotals[AllocationTracker::MAX_THREADS];
+        AllocationTracker::Counters s_lastFrameThreads[AllocationTracker::MAX_THREADS];
+        AllocationTracker::Counters s_lastFrame;
+        uint64_t s_previousCallSiteAllocations[AllocationTracker::MAX_CALL_SITES];
+        uint64_t s_lastFrameCallSiteAllocations[AllocationTracker::MAX_CALL_SITES];
+        uint64_t s_previousCallSiteBytes[AllocationTracker::MAX_CALL_SITES];
+        uint64_t s_lastFrameCallSiteBytes[AllocationTracker::MAX_CALL_SITES];
+
+        std::atomic<bool> s_isHotScopeAssertionEnabled{ false };
+
+        thread_local const char* t_hotScopeName = nullptr;
+        thread_local bool t_isInsideTracker = false;     // Allocations made by the tracker (e.g. while reporting) are not counted
+
+        /* Count an allocation */
+        void recordAllocation(const size_t size, const void* pCaller) {
+            if (t_isInsideTracker) {
+                return;
+            }
+            const unsigned int threadIndex = std::min(JobSystem::currentThreadIndex(), AllocationTracker::MAX_THREADS - 1);
+            ThreadCounters& counters = s_threadCounters[threadIndex];
+            counters.allocations.fetch_add(1, std::memory_order_relaxed);
+            counters.bytes.fetch_add(size, std::memory_order_relaxed);
+
+            const uintptr_t address = reinterpret_cast<uintptr_t>(pCaller);
+            size_t slot = static_cast<size_t>((address >> 4) * 0x9E3779B97F4A7C15ull) % AllocationTracker::MAX_CALL_SITES;
+            for (unsigned int probe = 0; probe < AllocationTracker::MAX_CALL_SITES; ++probe) {
+                CallSite& callSite = s_callSites[slot];
+                uintptr_t expected = 0;
+                if (callSite.address.load(std::memory_order_acquire) == address ||
+                    callSite.address.compare_exchange_strong(expected, address, std::memory_order_acq_rel) || expected == address) {
+                    callSite.allocations.fetch_add(1, std::memory_order_relaxed);
+                    callSite.bytes.fetch_add(size, std::memory_order_relaxed);
+                    break;
+                }
+                slot = (slot + 1) % AllocationTracker::MAX_CALL_SITES;
+                if (probe + 1 == AllocationTracker::MAX_CALL_SITES) {
+                    s_untrackedCallSiteAllocations.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+
+            if (t_hotScopeName) {
+                counters.hotScopeAllocations.fetch_add(1, std::memory_order_relaxed);
+                if (s_isHotScopeAssertionEnabled.load(std::memory_order_relaxed)) {
+                    t_isInsideTracker = true;
+                    std::fprintf(stderr, "Allocation of %zu bytes inside the hot scope %s (call site %p)\n", size, t_hotScopeName, pCaller);
+                    std::abort();
+                }
+            }
+        }
+
+        /* Allocate memory for operator new */
+        void* allocate(const size_t size, const void* pCaller) {
+            recordAllocation(size, pCaller);
+            return std::malloc(size ? size : 1);
+        }
+
+        /* Allocate aligned memory for operator new */
+        void* allocateAligned(const size_t size, const std::align_val_t alignment, const void* pCaller) {
+            recordAllocation(size, pCaller);
+            const size_t alignmentValue = static_cast<size_t>(alignment);
+#if defined(_MSC_VER)
+            return _aligned_malloc(size ? size : 1, alignmentValue);
+#else
+            /* aligned_alloc requires the size to be a multiple of the alignment */
+            return std::aligned_alloc(alignmentValue, ((size ? size : 1) + alignmentValue - 1) / alignmentValue * alignmentValue);
+#endif
+        }
+
+        /* Free aligned memory */
+        void freeAligned(void* pMemory) {
+#if defined(_MSC_VER)
+            _aligned_free(pMemory);
+#else
+            std::free(pMemory);
+#endif
+        }
+    }
+
+    /* Close the current frame */
+    void AllocationTracker::endFrame() {
+        s_lastFrame = Counters();
+        for (unsigned int i = 0; i < MAX_THREADS; ++i) {
+            const Counters totals = {
+                s_threadCounters[i].allocations.load(std::memory_order_relaxed),
+                s_threadCounters[i].bytes.load(std::memory_order_relaxed),
+                s_threadCounters[i].hotScopeAllocations.load(std::memory_order_relaxed)
+            };
+            Counters& frame = s_lastFrameThreads[i];
+            frame.allocations = totals.allocations - s_previousThreadTotals[i].allocations;
+            frame.bytes = totals.bytes - s_previousThreadTotals[i].bytes;
+            frame.hotScopeAllocations = totals.hotScopeAllocations - s_previousThreadTotals[i].hotScopeAllocations;
+            s_previousThreadTotals[i] = totals;
+
+            s_lastFrame.allocations += frame.allocations;
+            s_lastFrame.bytes += frame.bytes;
+            s_lastFrame.hotScopeAllocations += frame.hotScopeAllocations;
+        }
+        for (unsigned int i = 0; i < MAX_CALL_SITES; ++i) {
+            const uint64_t allocations = s_callSites[i].allocations.load(std::memory_order_relaxed);
+            const uint64_t bytes = s_callSites[i].bytes.load(std::memory_order_relaxed);
+            s_lastFrameCallSiteAllocations[i] = allocations - s_previousCallSiteAllocations[i];
+            s_lastFrameCallSiteBytes[i] = bytes - s_previousCallSiteBytes[i];
+            s_previousCallSiteAllocations[i] = allocations;
+            s_previousCallSiteBytes[i] = bytes;
+        }
+    }
+
+    /* Counters of the last closed frame for all threads */
+    const AllocationTracker::Counters& AllocationTracker::lastFrame() {
+        return s_lastFrame;
+    }
+
+    /* Counters of the last closed frame for one thread */
+    const AllocationTracker::Counters& AllocationTracker::lastFrame(const unsigned int threadIndex) {
+        return s_lastFrameThreads[std::min(threadIndex, MAX_THREADS - 1)];
+    }
+
+    /* Counters since the start of the program */
+    AllocationTracker::Counters AllocationTracker::total() {
+        Counters totals;
+        for (const ThreadCounters& counters : s_threadCounters) {
+            totals.allocations += counters.allocations.load(std::memory_order_relaxed);
+            totals.bytes += counters.bytes.load(std::memory_order_relaxed);
+            totals.hotScopeAllocations += counters.hotScopeAllocations.load(std::memory_order_relaxed);
+        }
+        return totals;
+    }
+
+    /* Abort on the first allocation inside a hot scope */
+    void AllocationTracker::setHotScopeAssertions(const bool enabled) {
+        s_isHotScopeAssertionEnabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    /* Write the counters of the last frame per thread and the call sites that allocated most during it */
+    void AllocationTracker::writeReport(std::ostream& stream, const unsigned int maxCallSites) {
+        t_isInsideTracker = true;
+        stream << "Allocations in the last frame: " << s_lastFrame.allocations << " (" << s_lastFrame.bytes << " bytes), "
+               << s_lastFrame.hotScopeAllocations << " in hot scopes\n";
+        for (unsigned int i = 0; i < MAX_THREADS; ++i) {
+            if (s_lastFrameThreads[i].allocations != 0) {
+                stream << "  thread " << i << ": " << s_lastFrameThreads[i].allocations << " (" << s_lastFrameThreads[i].bytes << " bytes), "
+                       << s_lastFrameThreads[i].hotScopeAllocations << " in hot scopes\n";
+            }
+        }
+
+        /* Partial selection of the busiest call sites, without allocating */
+        unsigned int order[MAX_CALL_SITES];
+        unsigned int usedCount = 0;
+        for (unsigned int i = 0; i < MAX_CALL_SITES; ++i) {
+            if (s_lastFrameCallSiteAllocations[i] != 0) {
+                order[usedCount++] = i;
+            }
+        }
+        const unsigned int shownCount = std::min(usedCount, maxCallSites);
+        std::partial_sort(order, order + shownCount, order + usedCount, [](const unsigned int a, const unsigned int b) {
+            return s_lastFrameCallSiteAllocations[a] > s_lastFrameCallSiteAllocations[b];
+        });
+        for (unsigned int i = 0; i < shownCount; ++i) {
+            const unsigned int slot = order[i];
+            const void* pAddress = reinterpret_cast<const void*>(s_callSites[slot].address.load(std::memory_order_relaxed));
+            stream << "  " << s_lastFrameCallSiteAllocations[slot] << " allocations (" << s_lastFrameCallSiteBytes[slot] << " bytes) from " << pAddress;
+#ifdef ALLOCATION_SYMBOLS
+            Dl_info info;
+            if (dladdr(pAddress, &info) && info.dli_sname) {
+                int status = 0;
+                char* pDemangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+                stream << " " << (status == 0 ? pDemangled : info.dli_sname);
+                std::free(pDemangled);
+            }
+#endif
+            stream << "\n";
+        }
+        const uint64_t untrackedAllocations = s_untrackedCallSiteAllocations.load(std::memory_order_relaxed);
+        if (untrackedAllocations != 0) {
+            stream << "  " << untrackedAllocations << " allocations since the start were not attributed, the call site table is full\n";
+        }
+        stream.flush();
+        t_isInsideTracker = false;
+    }
+
+    /* Enter a hot scope */
+    AllocationTracker::HotScope::HotScope(const char* name)
+        : m_previousName(t_hotScopeName) {
+        t_hotScopeName = name;
+    }
+
+    /* Leave a hot scope */
+    AllocationTracker::HotScope::~HotScope() {
+        t_hotScopeName = m_previousName;
+    }
+}
+
+/* Replacements of the global allocation functions */
+void* operator new(std::size_t size) {
+    void* pMemory = System::allocate(size, ALLOCATION_CALLER);
+    if (!pMemory) {
+        throw std::bad_alloc();
+    }
+    return pMemory;
+}
+
+void* operator new[](std::size_t size) {
+    void* pMemory = System::allocate(size, ALLOCATION_CALLER);
+    if (!pMemory) {
+        throw std::bad_alloc();
+    }
+    return pMemory;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return System::allocate(size, ALLOCATION_CALLER);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return System::allocate(size, ALLOCATION_CALLER);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    void* pMemory = System::allocateAligned(size, alignment, ALLOCATION_CALLER);
+    if (!pMemory) {
+        throw std::bad_alloc();
+    }
+    return pMemory;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    void* pMemory = System::allocateAligned(size, alignment, ALLOCATION_CALLER);
+    if (!pMemory) {
+        throw std::bad_alloc();
+    }
+    return pMemory;
+}
+
+void operator delete(void* pMemory) noexcept { std::free(pMemory); }
+void operator delete[](void* pMemory) noexcept { std::free(pMemory); }
+void operator delete(void* pMemory, std::size_t) noexcept { std::free(pMemory); }
+void operator delete[](void* pMemory, std::size_t) noexcept { std::free(pMemory); }
+void operator delete(void* pMemory, const std::nothrow_t&) noexcept { std::free(pMemory); }
+void operator delete[](void* pMemory, const std::nothrow_t&) noexcept { std::free(pMemory); }
+void operator delete(void* pMemory, std::align_val_t) noexcept { System::freeAligned(pMemory); }
+void operator delete[](void* pMemory, std::align_val_t) noexcept { System::freeAligned(pMemory); }
+void operator delete(void* pMemory, std::size_t, std::align_val_t) noexcept { System::freeAligned(pMemory); }
+void operator delete[](void* pMemory, std::size_t, std::align_val_t) noexcept { System::freeAligned(pMemory); }
+
+#else
+
+namespace System {
+    /* Without ALLOCATION_TRACKING nothing is counted */
+    void AllocationTracker::endFrame() {}
+
+    const AllocationTracker::Counters& AllocationTracker::lastFrame() {
+        static const Counters counters;
+        return counters;
+    }
+
+    const AllocationTracker::Counters& AllocationTracker::lastFrame(const unsigned int) {
+        return lastFrame();
+    }
+
+    AllocationTracker::Counters AllocationTracker::total() {
+        return Counters();
+    }
+
+    void AllocationTracker::setHotScopeAssertions(const bool) {}
+
+    void AllocationTracker::writeReport(std::ostream& stream, const unsigned int) {
+        stream << "Allocation tracking is disabled, configure with -DALLOCATION_TRACKING=ON" << std::endl;
+    }
+
+    AllocationTracker::HotScope::HotScope(const char*) : m_previousName(nullptr) {}
+
+    AllocationTracker::HotScope::~HotScope() {}
+}
+
+#endif
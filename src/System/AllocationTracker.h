@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+namespace System {
+    /*
+    Opt-in allocation instrumentation, enabled by configuring with -DALLOCATION_TRACKING=ON.
+    The global operator new/delete are replaced to count allocations and bytes per thread and per call site.
+    Allocations inside hot scopes (see ALLOCATION_HOT_SCOPE) are counted separately and, in assertion mode, abort the program.
+    Without the option the functions do nothing and hot scopes compile to nothing
+    */
+    class AllocationTracker {
+    public:
+        /* Counters of one frame or of the whole run */
+        struct Counters {
+            uint64_t allocations = 0;
+            uint64_t bytes = 0;
+            uint64_t hotScopeAllocations = 0;
+        };
+
+        /* Threads are identified by JobSystem::currentThreadIndex(), higher indices share the last slot */
+        static constexpr unsigned int MAX_THREADS = 64;
+        /* Call sites beyond this number are counted in the totals only */
+        static constexpr unsigned int MAX_CALL_SITES = 8192;
+
+        static constexpr bool isEnabled() {
+#ifdef ALLOCATION_TRACKING
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        /* Close the current frame: the counters of the frame become available through lastFrame() */
+        static void endFrame();
+        /* Counters of the last closed frame, for all threads or for one thread */
+        static const Counters& lastFrame();
+        static const Counters& lastFrame(const unsigned int threadIndex);
+        /* Counters since the start of the program */
+        static Counters total();
+
+        /* Abort on the first allocation inside a hot scope */
+        static void setHotScopeAssertions(const bool enabled);
+
+        /* Write the counters of the last frame per thread and the call sites that allocated most during it */
+        static void writeReport(std::ostream& stream, const unsigned int maxCallSites = 10);
+
+        /* Marks the lifetime of the object as a scope that must not allocate */
+        class HotScope {
+        public:
+            explicit HotScope(const char* name);
+            ~HotScope();
+
+            HotScope(const HotScope&) = delete;
+            HotScope& operator = (const HotScope&) = delete;
+
+        private:
+            const char* m_previousName;
+        };
+    };
+}
+
+#ifdef ALLOCATION_TRACKING
+#define ALLOCATION_HOT_SCOPE(name) System::AllocationTracker::HotScope allocationHotScope(name)
+#else
+#define ALLOCATION_HOT_SCOPE(name)
+#endif
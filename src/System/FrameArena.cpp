@@ -0,0 +1,87 @@
+#include "FrameArena.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+
+namespace System {
+    /* Allocate the main block */
+    FrameArena::FrameArena(const size_t capacity)
+        : m_block(new unsigned char[capacity])
+        , m_capacity(capacity) {
+    }
+
+    /* Take memory from an overflow block. This is the slow path, it only happens while the arena grows */
+    void* FrameArena::allocateOverflow(const size_t size, const size_t alignment) {
+        size_t alignedOffset = 0;
+        if (!m_overflowBlocks.empty()) {
+            const uintptr_t base = reinterpret_cast<uintptr_t>(m_overflowBlocks.back().get());
+            alignedOffset = ((base + m_overflowOffset + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1)) - base;
+        }
+        if (m_overflowBlocks.empty() || alignedOffset + size > m_overflowCapacity) {
+            /* Blocks come from operator new[], so they are aligned for any fundamental type */
+            m_overflowCapacity = std::max(size + alignment, m_capacity);
+            m_overflowBlocks.emplace_back(new unsigned char[m_overflowCapacity]);
+            ++m_overflowCount;
+            const uintptr_t base = reinterpret_cast<uintptr_t>(m_overflowBlocks.back().get());
+            alignedOffset = ((base + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1)) - base;
+        }
+        m_usedBytes += size;
+        m_overflowOffset = alignedOffset + size;
+        return m_overflowBlocks.back().get() + alignedOffset;
+    }
+
+    /* Release all allocations of the frame. After an overflow the main block grows to fit the whole frame */
+    void FrameArena::reset() {
+        m_highWaterMark = std::max(m_highWaterMark, m_usedBytes);
+        if (!m_overflowBlocks.empty()) {
+            m_overflowBlocks.clear();
+            m_overflowOffset = 0;
+            m_overflowCapacity = 0;
+            /* Leave room for alignment padding */
+            m_capacity = std::max(m_capacity * 2, m_highWaterMark + m_highWaterMark / 4);
+            m_block.reset(new unsigned char[m_capacity]);
+        }
+        m_offset = 0;
+        m_usedBytes = 0;
+    }
+
+    /* Set on the thread that created the arenas, unless it is a worker. Arena 0 belongs to that thread only */
+    static thread_local bool s_isMainThread = false;
+
+    /* Arenas of the main thread and of the workers of the shared job system, indexed by the thread index */
+    static std::vector <std::unique_ptr <FrameArena>>& threadArenas() {
+        static std::vector <std::unique_ptr <FrameArena>> arenas = []() {
+            std::vector <std::unique_ptr <FrameArena>> result(JobSystem::instance().threadCount() + 1);
+            for (auto& pArena : result) {
+                pArena = std::make_unique<FrameArena>();
+            }
+            s_isMainThread = JobSystem::currentJobSystem() == nullptr;
+            return result;
+        }();
+        return arenas;
+    }
+
+    /*
+    Arena of the calling thread. Thread indices of other job systems overlap those of the shared one, so the job system is checked too.
+    Other threads outside of job systems (e.g. the capture writer) also have index 0 and must not share the main thread's arena
+    */
+    FrameArena* FrameArena::forCurrentThread() {
+        std::vector <std::unique_ptr <FrameArena>>& arenas = threadArenas();
+        const JobSystem* pJobSystem = JobSystem::currentJobSystem();
+        if (!pJobSystem) {
+            return s_isMainThread ? arenas[0].get() : nullptr;
+        }
+        if (pJobSystem != &JobSystem::instance()) {
+            return nullptr;
+        }
+        const unsigned int threadIndex = JobSystem::currentThreadIndex();
+        return threadIndex < arenas.size() ? arenas[threadIndex].get() : nullptr;
+    }
+
+    /* Reset the arenas of all threads */
+    void FrameArena::resetAll() {
+        for (auto& pArena : threadArenas()) {
+            pArena->reset();
+        }
+    }
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace System {
+    /*
+    Linear (bump) allocator for data that lives no longer than one frame. Allocation is a pointer bump,
+    deallocation is a no-op and all memory is released at once by reset(). When the block is exhausted,
+    overflow blocks are taken from the heap and the block grows to the high-water mark on the next reset,
+    so a steady-state frame loop does not touch the heap
+    */
+    class FrameArena {
+    public:
+        static constexpr size_t DEFAULT_CAPACITY = 256 * 1024;
+
+        explicit FrameArena(const size_t capacity = DEFAULT_CAPACITY);
+
+        /* Prohibit copying and moving of arenas, allocations point into them */
+        FrameArena(const FrameArena&) = delete;
+        FrameArena& operator = (const FrameArena&) = delete;
+
+        /* Allocate uninitialized memory. Never returns nullptr */
+        void* allocate(const size_t size, const size_t alignment = alignof(std::max_align_t));
+        template <typename T>
+        T* allocate(const size_t count) { return static_cast<T*>(allocate(count * sizeof(T), alignof(T))); }
+
+        /* Release all allocations of the frame */
+        void reset();
+
+        /* Bytes allocated since the last reset */
+        size_t usedBytes() const { return m_usedBytes; }
+        /* Size of the main block */
+        size_t capacity() const { return m_capacity; }
+        /* Largest number of bytes used in one frame */
+        size_t highWaterMark() const { return m_highWaterMark; }
+        /* Number of heap blocks taken because the main block was exhausted (since creation) */
+        unsigned int overflowCount() const { return m_overflowCount; }
+
+        /*
+        Arena of the calling thread: one for the main thread (the thread that first takes an arena or resets them)
+        and one for every worker of JobSystem::instance(). Returns nullptr for any other thread.
+        Workers must not keep pointers into their arena after the job ends
+        */
+        static FrameArena* forCurrentThread();
+        /* Reset the arenas of all threads. Call once per frame while no jobs are running */
+        static void resetAll();
+
+    private:
+        /* Take memory from an overflow block */
+        void* allocateOverflow(const size_t size, const size_t alignment);
+
+        std::unique_ptr <unsigned char[]> m_block;
+        size_t m_capacity = 0;
+        size_t m_offset = 0;
+        size_t m_usedBytes = 0;
+        size_t m_highWaterMark = 0;
+        unsigned int m_overflowCount = 0;
+        std::vector <std::unique_ptr <unsigned char[]>> m_overflowBlocks;
+        size_t m_overflowOffset = 0;
+        size_t m_overflowCapacity = 0;
+    };
+
+    /* Inline fast path: bump the offset in the main block */
+    inline void* FrameArena::allocate(const size_t size, const size_t alignment) {
+        const uintptr_t base = reinterpret_cast<uintptr_t>(m_block.get());
+        const size_t alignedOffset = ((base + m_offset + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1)) - base;
+        if (alignedOffset + size <= m_capacity) {
+            m_usedBytes += alignedOffset + size - m_offset;
+            m_offset = alignedOffset + size;
+            return m_block.get() + alignedOffset;
+        }
+        return allocateOverflow(size, alignment);
+    }
+
+    /*
+    STL allocator that takes memory from a frame arena. Containers using it must not outlive the frame,
+    memory released by a container is only reclaimed by FrameArena::reset(). On threads without an arena
+    (workers of other job systems, other threads) it falls back to the heap
+    */
+    template <typename T>
+    class FrameAllocator {
+    public:
+        typedef T value_type;
+
+        FrameAllocator() : m_pArena(FrameArena::forCurrentThread()) {}
+        explicit FrameAllocator(FrameArena& arena) : m_pArena(&arena) {}
+        template <typename U>
+        FrameAllocator(const FrameAllocator<U>& other) : m_pArena(other.arena()) {}
+
+        T* allocate(const size_t count) { return m_pArena ? m_pArena->allocate<T>(count) : static_cast<T*>(::operator new(count * sizeof(T))); }
+        void deallocate(T* p, const size_t) {
+            if (!m_pArena) {
+                ::operator delete(p);
+            }
+        }
+
+        FrameArena* arena() const { return m_pArena; }
+
+        template <typename U>
+        bool operator == (const FrameAllocator<U>& other) const { return m_pArena == other.arena(); }
+        template <typename U>
+        bool operator != (const FrameAllocator<U>& other) const { return m_pArena != other.arena(); }
+
+    private:
+        FrameArena* m_pArena;
+    };
+
+    /* Transient vector allocated from the arena of the calling thread */
+    template <typename T>
+    using FrameVector = std::vector<T, FrameAllocator<T>>;
+}
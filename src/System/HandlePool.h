@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace System {
+    /*
+    Typed generational handle: an index into a dense slot array plus the generation of the slot.
+    A handle becomes stale when its slot is released, so it can never resolve to an object that reused the slot
+    */
+    template <typename Tag>
+    struct Handle {
+        static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+        uint32_t index = INVALID_INDEX;
+        uint32_t generation = 0;
+
+        bool isValid() const { return index != INVALID_INDEX; }
+
+        bool operator == (const Handle& other) const { return index == other.index && generation == other.generation; }
+        bool operator != (const Handle& other) const { return !(*this == other); }
+    };
+
+    /* Dense slot array addressed by generational handles. Resolving a handle is O(1) */
+    template <typename T, typename Tag>
+    class HandlePool {
+    public:
+        typedef Handle<Tag> HandleType;
+
+        /* Store a value and return its handle. Released slots are reused first */
+        HandleType insert(T value) {
+            HandleType handle;
+            if (!m_freeSlots.empty()) {
+                handle.index = m_freeSlots.back();
+                m_freeSlots.pop_back();
+                m_slots[handle.index] = std::move(value);
+                m_isAlive[handle.index] = 1;
+            }
+            else {
+                handle.index = static_cast<uint32_t>(m_slots.size());
+                m_slots.push_back(std::move(value));
+                m_generations.push_back(0);
+                m_isAlive.push_back(1);
+            }
+            handle.generation = m_generations[handle.index];
+            ++m_size;
+            return handle;
+        }
+
+        /* Release the slot of the handle. All copies of the handle become stale */
+        bool erase(const HandleType handle) {
+            if (!contains(handle)) {
+                return false;
+            }
+            m_slots[handle.index] = T{};
+            ++m_generations[handle.index];
+            m_isAlive[handle.index] = 0;
+            m_freeSlots.push_back(handle.index);
+            --m_size;
+            return true;
+        }
+
+        /* Check that the handle refers to a live slot */
+        bool contains(const HandleType handle) const {
+            return handle.index < m_slots.size() && m_isAlive[handle.index] && m_generations[handle.index] == handle.generation;
+        }
+
+        /* Resolve the handle. Returns nullptr for stale or invalid handles */
+        T* get(const HandleType handle) {
+            return contains(handle) ? &m_slots[handle.index] : nullptr;
+        }
+        const T* get(const HandleType handle) const {
+            return contains(handle) ? &m_slots[handle.index] : nullptr;
+        }
+
+        /* Number of live slots */
+        size_t size() const { return m_size; }
+
+        /* Call the function for every live slot */
+        template <typename Function>
+        void forEach(Function&& function) const {
+            for (size_t i = 0; i < m_slots.size(); ++i) {
+                if (m_isAlive[i]) {
+                    function(HandleType{ static_cast<uint32_t>(i), m_generations[i] }, m_slots[i]);
+                }
+            }
+        }
+
+    private:
+        std::vector<T> m_slots;
+        std::vector<uint32_t> m_generations;
+        std::vector<uint8_t> m_isAlive;
+        std::vector<uint32_t> m_freeSlots;
+        size_t m_size = 0;
+    };
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+
+namespace System {
+    /* 64-bit FNV-1a offset basis and prime */
+    constexpr uint64_t FNV1A_OFFSET_BASIS = 14695981039346656037ull;
+    constexpr uint64_t FNV1A_PRIME = 1099511628211ull;
+
+    /* Continue an FNV-1a hash over a block of bytes */
+    inline uint64_t hashBytes(const void* data, const size_t size, uint64_t hash = FNV1A_OFFSET_BASIS) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= FNV1A_PRIME;
+        }
+        return hash;
+    }
+
+    /* Hash a string with FNV-1a. Usable at compile time for string literals */
+    constexpr uint64_t hashString(const std::string_view string, uint64_t hash = FNV1A_OFFSET_BASIS) {
+        for (const char c : string) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= FNV1A_PRIME;
+        }
+        return hash;
+    }
+
+    namespace literals {
+        /* Compile-time hash of a string literal: "brick"_hash */
+        constexpr uint64_t operator "" _hash(const char* string, const size_t length) {
+            return hashString(std::string_view(string, length));
+        }
+    }
+}
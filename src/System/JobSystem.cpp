@@ -0,0 +1,131 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+namespace System {
+    static thread_local unsigned int s_threadIndex = 0;
+    static thread_local const JobSystem* s_pJobSystem = nullptr;
+
+    /* Start the worker threads */
+    JobSystem::JobSystem(const unsigned int threadCount) {
+        m_threads.reserve(threadCount);
+        for (unsigned int i = 0; i < threadCount; ++i) {
+            m_threads.emplace_back(&JobSystem::workerLoop, this, i + 1);
+        }
+    }
+
+    /* Finish the queued jobs and join the worker threads */
+    JobSystem::~JobSystem() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_isStopping = true;
+        }
+        m_condition.notify_all();
+        for (auto& thread : m_threads) {
+            thread.join();
+        }
+    }
+
+    /* Shared job system used by the engine modules */
+    JobSystem& JobSystem::instance() {
+        static JobSystem jobSystem;
+        return jobSystem;
+    }
+
+    /* One worker per hardware thread except the calling one */
+    unsigned int JobSystem::defaultThreadCount() {
+        const unsigned int hardwareThreads = std::thread::hardware_concurrency();
+        return hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    }
+
+    /* Index of the current thread */
+    unsigned int JobSystem::currentThreadIndex() {
+        return s_threadIndex;
+    }
+
+    /* Job system of the current worker thread */
+    const JobSystem* JobSystem::currentJobSystem() {
+        return s_pJobSystem;
+    }
+
+    /* Put a job into the queue and wake a worker */
+    void JobSystem::enqueue(std::function<void()> job) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_jobs.push_back(std::move(job));
+        }
+        m_condition.notify_one();
+    }
+
+    /* Take jobs from the queue until the job system is stopped */
+    void JobSystem::workerLoop(const unsigned int threadIndex) {
+        s_threadIndex = threadIndex;
+        s_pJobSystem = this;
+        while (true) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_condition.wait(lock, [this]() { return m_isStopping || !m_jobs.empty(); });
+                if (m_jobs.empty()) {
+                    return;     // Stopping and no work left
+                }
+                job = std::move(m_jobs.front());
+                m_jobs.pop_front();
+            }
+            job();
+        }
+    }
+
+    /* Run function(begin, end) over [0, count) split into chunks */
+    void JobSystem::parallelFor(const size_t count, const size_t minChunkSize, const std::function<void(size_t begin, size_t end)>& function) {
+        if (count == 0) {
+            return;
+        }
+
+        /* Split the range into a few chunks per thread so that uneven chunks balance out */
+        const size_t participants = m_threads.size() + 1;
+        const size_t chunkSize = std::max<size_t>(std::max<size_t>(minChunkSize, 1), (count + participants * 4 - 1) / (participants * 4));
+        const size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+        if (chunkCount == 1 || m_threads.empty()) {
+            function(0, count);
+            return;
+        }
+
+        /*
+        Chunks are claimed through a shared counter. Helper jobs that start after all chunks are claimed
+        only touch the shared state, which they keep alive, so the function is never called after return
+        */
+        struct State {
+            std::atomic<size_t> nextChunk{ 0 };
+            std::atomic<size_t> finishedChunks{ 0 };
+            const std::function<void(size_t, size_t)>* pFunction = nullptr;
+            size_t count = 0;
+            size_t chunkSize = 0;
+            size_t chunkCount = 0;
+        };
+        auto pState = std::make_shared<State>();
+        pState->pFunction = &function;
+        pState->count = count;
+        pState->chunkSize = chunkSize;
+        pState->chunkCount = chunkCount;
+
+        auto runChunks = [](State& state) {
+            for (size_t chunk = state.nextChunk++; chunk < state.chunkCount; chunk = state.nextChunk++) {
+                const size_t begin = chunk * state.chunkSize;
+                (*state.pFunction)(begin, std::min(begin + state.chunkSize, state.count));
+                ++state.finishedChunks;
+            }
+        };
+
+        const size_t helpers = std::min(m_threads.size(), chunkCount - 1);
+        for (size_t i = 0; i < helpers; ++i) {
+            enqueue([pState, runChunks]() { runChunks(*pState); });
+        }
+        runChunks(*pState);
+
+        /* Wait for chunks that are still being processed by the workers */
+        while (pState->finishedChunks.load() < chunkCount) {
+            std::this_thread::yield();
+        }
+    }
+}
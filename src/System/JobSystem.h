@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace System {
+    /* Pool of worker threads executing independent jobs */
+    class JobSystem {
+    public:
+        /* Start the worker threads */
+        explicit JobSystem(const unsigned int threadCount = defaultThreadCount());
+
+        /* Finish the queued jobs and join the worker threads */
+        ~JobSystem();
+
+        /* Prohibit copying and moving of job systems */
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator = (const JobSystem&) = delete;
+
+        /* Shared job system used by the engine modules */
+        static JobSystem& instance();
+
+        /* One worker per hardware thread except the calling one, but at least one worker */
+        static unsigned int defaultThreadCount();
+
+        /* Index of the current thread: 0 for threads outside of job systems, 1..threadCount() for workers */
+        static unsigned int currentThreadIndex();
+        /* Job system of the current worker thread, nullptr for threads outside of job systems */
+        static const JobSystem* currentJobSystem();
+
+        unsigned int threadCount() const { return static_cast<unsigned int>(m_threads.size()); }
+
+        /* Queue a job and get a future for its result */
+        template <typename Function>
+        std::future<std::invoke_result_t<Function>> submit(Function&& function) {
+            typedef std::invoke_result_t<Function> Result;
+            auto pTask = std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(function));
+            std::future<Result> result = pTask->get_future();
+            enqueue([pTask]() { (*pTask)(); });
+            return result;
+        }
+
+        /*
+        Run function(begin, end) over [0, count) split into chunks of at least minChunkSize elements.
+        The calling thread takes part in the work, so it is safe to call from inside a job
+        */
+        void parallelFor(const size_t count, const size_t minChunkSize, const std::function<void(size_t begin, size_t end)>& function);
+
+    private:
+        /* Put a job into the queue and wake a worker */
+        void enqueue(std::function<void()> job);
+        /* Take jobs from the queue until the job system is stopped */
+        void workerLoop(const unsigned int threadIndex);
+
+        std::vector <std::thread> m_threads;
+        std::deque <std::function<void()>> m_jobs;
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        bool m_isStopping = false;
+    };
+}
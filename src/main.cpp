@@ -5,11 +5,29 @@
 #include <glm/gtc/matrix_transform.hpp>
 
 #include <iostream>
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <memory>
 
 #include "Renderer/ShaderProgram.h"
 #include "Resources/ResourceManager.h"
 #include "Renderer/Texture2D.h"
 #include "Renderer/Sprite.h"
+#include "Renderer/SpriteBatch.h"
+#include "Renderer/ParticleEmitter.h"
+#include "Renderer/GpuParticleSystem.h"
+#include "Renderer/Font.h"
+#include "Renderer/TextBatch.h"
+#include "Renderer/TileMapRenderer.h"
+#include "Renderer/LayerStack.h"
+#include "Renderer/FrameCapture.h"
+#include "Scene/AutoTiler.h"
+#include "ECS/Systems.h"
+#include "Benchmarks/Benchmarks.h"
+#include "System/FrameArena.h"
+#include "System/AllocationTracker.h"
 
 /* Array of vertex coordinates in local space */
 GLfloat vertices[] = {
@@ -25,26 +43,58 @@ GLfloat texCoordinates[] = {
     0.0f, 0.0f  
 }; 
 
-/* Global variable for window size */
+/* Global variable for the initial window size */
 glm::ivec2 gWindowSize(640, 480);
+/* Global variable for the framebuffer size in pixels (differs from the window size on high-DPI screens) */
+glm::ivec2 gFramebufferSize(640, 480);
 
-/* Callback function for resize window */
-void glfwWindowSizeCallback(GLFWwindow* pWindow, int width, int height) {
-    gWindowSize.x = width;
-    gWindowSize.y = height;
+/* Callback function for resize framebuffer */
+void glfwFramebufferSizeCallback(GLFWwindow* pWindow, int width, int height) {
+    gFramebufferSize.x = width;
+    gFramebufferSize.y = height;
     /* Set the rendering area inside the window */
     glViewport(0, 0, width, height);
 }
 
+/* Global flag for the memory report requested from the keyboard */
+bool gIsMemoryReportRequested = false;
+/* Global flag for switching the caching of the static layer from the keyboard */
+bool gIsLayerCachingToggled = false;
+/* Global flags for the screenshot and the recording of frames requested from the keyboard */
+bool gIsScreenshotRequested = false;
+bool gIsRecordingToggled = false;
+
 /* Callback function for handling keyboard events */
 void glfwKeyCallback(GLFWwindow* pWindow, int key, int scancode, int action, int mode) {
     if (key == GLFW_KEY_ESCAPE and action == GLFW_PRESS) {
         glfwSetWindowShouldClose(pWindow, GL_TRUE);
     }
+    /* Print the memory used by resources */
+    if (key == GLFW_KEY_M and action == GLFW_PRESS) {
+        gIsMemoryReportRequested = true;
+    }
+    /* Switch between the cached and the directly drawn static layer */
+    if (key == GLFW_KEY_L and action == GLFW_PRESS) {
+        gIsLayerCachingToggled = true;
+    }
+    /* Save the next frame to a PNG file */
+    if (key == GLFW_KEY_P and action == GLFW_PRESS) {
+        gIsScreenshotRequested = true;
+    }
+    /* Start or stop recording the frames into a PPM stream */
+    if (key == GLFW_KEY_R and action == GLFW_PRESS) {
+        gIsRecordingToggled = true;
+    }
 }
 
 int main(int argc, char** argv)
 {   
+    /* Pack the resources directory into a single file next to the executable and exit */
+    if (argc > 1 && std::string(argv[1]) == "--build-pack") {
+        ResourceManager resourceManager(argv[0]);
+        return resourceManager.buildResourcePack("res.pack", "res") ? 0 : -1;
+    }
+
     /* Initialize the library */
     if (!glfwInit()) {
         std::cout << "glfwInit failed" << std::endl;
@@ -65,7 +115,8 @@ int main(int argc, char** argv)
     }
 
     /* Set a function that is called when the window is resized */
-    glfwSetWindowSizeCallback(pWindow, glfwWindowSizeCallback);
+    glfwSetFramebufferSizeCallback(pWindow, glfwFramebufferSizeCallback);
+    glfwGetFramebufferSize(pWindow, &gFramebufferSize.x, &gFramebufferSize.y);
     /* Set a function that is called on every keyboard event  */
     glfwSetKeyCallback(pWindow, glfwKeyCallback);
 
@@ -82,8 +133,20 @@ int main(int argc, char** argv)
     std::cout << "Renderer: " <<  glGetString(GL_RENDERER) << std::endl;
     std::cout << "OpenGL version: " << glGetString(GL_VERSION) << std::endl;
 
+    glViewport(0, 0, gFramebufferSize.x, gFramebufferSize.y);
     glClearColor(0, 1, 0, 1);
 
+    /* Run microbenchmarks of the engine modules and exit */
+    if (argc > 2 && std::string(argv[1]) == "--benchmark") {
+        bool isSuccessful = false;
+        {
+            ResourceManager resourceManager(argv[0]);
+            isSuccessful = Benchmarks::run(argv[2], resourceManager);
+        }
+        glfwTerminate();
+        return isSuccessful ? 0 : -1;
+    }
+
     /* 
     Resource Manager contains OpenGL context that should be deleted before finishing work with OpenGL (glfwTerminate() command).
     Therefore, all work with Resource Manager is allocated to a separate scope
@@ -91,35 +154,111 @@ int main(int argc, char** argv)
     {
         /* Create a resource manager object */
         ResourceManager resourceManager(argv[0]);
+        /* Use the resource pack if it was built, otherwise load resources from the directory */
+        resourceManager.mountResourcePack("res.pack");
 
-        /* Load shaders source code and create a shader program */
-        auto pDefaultShaderProgram = resourceManager.loadShaders("DefaultShaderProgram", "res/shaders/vertex_shader.txt", "res/shaders/fragment_shader.txt");
-        /* Check creation of the shader program for success */
-        if (!pDefaultShaderProgram) {
-            std::cerr << "Can not create shader program: " << "DefaultShaderProgram" << std::endl;
+        /* Load shaders, textures and sprites listed in the manifest */
+        if (!resourceManager.loadManifest("res/manifest.txt")) {
+            std::cerr << "Can not load resources from the manifest: " << "res/manifest.txt" << std::endl;
             return -1;
         }
+        resourceManager.logTextureStatistics();
 
-        /* Load sprite shaders source code and create a shader program for sprites */
-        auto pSpriteShaderProgram = resourceManager.loadShaders("SpriteShaderProgram", "res/shaders/vSprite_shader.txt", "res/shaders/fSprite_shader.txt");
-        if (!pDefaultShaderProgram) {
-            std::cerr << "Can not create shader program: " << "SpriteShaderProgram" << std::endl;
-            return -1;
-        }
-
-        /* Load a texture */
-        auto pDefaultTexture = resourceManager.loadTexture("DefaultTexture", "res/textures/map_16x16.png");
-
-        /* Load a texture atlas */
-        std::vector <std::string> subTextureNames = { "brick", "topBrick", "bottomBrick", "leftBrick", "rightBrick", "topLeftBrick", "topRightBrick", "bottomLeftBrick", "bottomRightBrick", "concrete" };
-        auto pTextureAtlas = resourceManager.loadTextureAtlas("DefaultTextureAtlas", "res/textures/map_16x16.png", std::move(subTextureNames), 16, 16);
-
-        /* Load a sprite */
-        auto pSprite = resourceManager.loadSprite("Sprite", "DefaultTextureAtlas", "SpriteShaderProgram", 100, 100, "brick");
+        auto pDefaultShaderProgram = resourceManager.getShaderProgram("DefaultShaderProgram");
+        auto pSpriteShaderProgram = resourceManager.getShaderProgram("SpriteShaderProgram");
+        auto pDefaultTexture = resourceManager.getTexture("DefaultTexture");
+        auto pTextureAtlas = resourceManager.getTexture("DefaultTextureAtlas");
+        auto pSprite = resourceManager.getSprite("Sprite");
 
         /* Set sprite position */
         pSprite->setPosition(glm::vec2(300, 100));
 
+        /* Entities drawn by the sprite batch: a row of atlas tiles spinning in place and cycling through the animation with a phase shift */
+        auto pSpriteBatchShaderProgram = resourceManager.getShaderProgram("SpriteBatchShaderProgram");
+        Renderer::SpriteBatch spriteBatch(pSpriteBatchShaderProgram);
+        ECS::World world;
+        const Renderer::AnimationClipId brickCycleClipId = resourceManager.getAnimationLibrary().getClipId("BrickCycle");
+        for (Renderer::Texture2D::SubTextureId tile = 0; tile < 10; ++tile) {
+            world.create(ECS::Transform{ glm::vec2(40.f + 56.f * tile, 360.f), glm::vec2(40.f), 0.f },
+                         ECS::SpriteRef{ pTextureAtlas.get(), tile },
+                         ECS::Velocity{ glm::vec2(0.f), 45.f },
+                         ECS::Animation{ brickCycleClipId, 0.1f * tile, 1.f });
+        }
+
+        /* Fountain of fading concrete chips */
+        auto pParticleShaderProgram = resourceManager.getShaderProgram("ParticleShaderProgram");
+        Renderer::ParticleEmitterSettings fountainSettings;
+        fountainSettings.position = glm::vec2(560.f, 160.f);
+        fountainSettings.spawnRate = 1500.f;
+        fountainSettings.directionSpread = 20.f;
+        fountainSettings.minSpeed = 200.f;
+        fountainSettings.maxSpeed = 320.f;
+        fountainSettings.minLifetime = 1.f;
+        fountainSettings.maxLifetime = 2.f;
+        fountainSettings.gravity = glm::vec2(0.f, -300.f);
+        fountainSettings.drag = 0.5f;
+        fountainSettings.startSize = 10.f;
+        fountainSettings.endSize = 3.f;
+        fountainSettings.startColor = glm::vec4(1.f, 0.8f, 0.4f, 1.f);
+        fountainSettings.endColor = glm::vec4(1.f, 0.2f, 0.1f, 0.f);
+        fountainSettings.maxParticles = 4000;
+        Renderer::ParticleEmitter fountain(pTextureAtlas, pTextureAtlas->getSubTextureId("concrete"), pParticleShaderProgram, fountainSettings);
+
+        /* Smoke simulated on the GPU with transform feedback. The simulation captures its outputs, so it can not come from the manifest */
+        auto pGpuParticleSimulationShaderProgram = resourceManager.loadShaders("GpuParticleSimulationShaderProgram",
+            "res/shaders/vGpuParticleSimulation_shader.txt", "res/shaders/fGpuParticleSimulation_shader.txt", { "out_positionVelocity", "out_ageLifetime" });
+        auto pGpuParticleShaderProgram = resourceManager.loadShaders("GpuParticleShaderProgram", "res/shaders/vGpuParticle_shader.txt", "res/shaders/fParticle_shader.txt");
+        if (!pGpuParticleSimulationShaderProgram || !pGpuParticleShaderProgram) {
+            std::cerr << "Can not load the GPU particle shader programs" << std::endl;
+            return -1;
+        }
+        Renderer::ParticleEmitterSettings smokeSettings;
+        smokeSettings.position = glm::vec2(120.f, 200.f);
+        smokeSettings.positionSpread = glm::vec2(20.f, 4.f);
+        smokeSettings.directionSpread = 15.f;
+        smokeSettings.minSpeed = 30.f;
+        smokeSettings.maxSpeed = 60.f;
+        smokeSettings.minLifetime = 2.f;
+        smokeSettings.maxLifetime = 4.f;
+        smokeSettings.gravity = glm::vec2(10.f, 0.f);
+        smokeSettings.startSize = 6.f;
+        smokeSettings.endSize = 24.f;
+        smokeSettings.startColor = glm::vec4(0.6f, 0.6f, 0.6f, 0.6f);
+        smokeSettings.endColor = glm::vec4(0.3f, 0.3f, 0.3f, 0.f);
+        smokeSettings.maxParticles = 20000;
+        Renderer::GpuParticleSystem smoke(pTextureAtlas, pTextureAtlas->getSubTextureId("concrete"), pGpuParticleSimulationShaderProgram, pGpuParticleShaderProgram, smokeSettings);
+
+        /* Brick fort with concrete corners, auto-tiled by its neighbours. Quarters of bricks are chipped off and bricks are rebuilt at random */
+        const Scene::TileMap::TileType BRICK = 1;
+        const Scene::TileMap::TileType CONCRETE = 2;
+        Scene::TileMap fortMap(20, 6, glm::vec2(16.f), glm::vec2(160.f, 220.f));
+        for (int row = 0; row < fortMap.rows(); ++row) {
+            for (int column = 0; column < fortMap.columns(); ++column) {
+                const bool isCorner = (column < 2 || column >= fortMap.columns() - 2) && (row < 2 || row >= fortMap.rows() - 2);
+                const bool isInside = column >= 3 && column < fortMap.columns() - 3 && row >= 2 && row < fortMap.rows() - 2;
+                fortMap.setTile(column, row, isCorner ? CONCRETE : (isInside ? Scene::TileMap::EMPTY_TILE : BRICK));
+            }
+        }
+        Scene::AutoTiler fortTiler(fortMap);
+        fortTiler.setEdgeImages(BRICK, Scene::AutoTiler::EdgeImages::fromAtlas(*pTextureAtlas, "brick"));
+        fortTiler.setImage(CONCRETE, static_cast<Scene::AutoTiler::CellImage>(pTextureAtlas->getSubTextureId("concrete")));
+        fortTiler.retileAll();
+        Renderer::TileMapRenderer fortRenderer(pTextureAtlas, resourceManager.getShaderProgram("TileMapShaderProgram"),
+                                               fortMap.columns(), fortMap.rows(), fortMap.tileSize(), fortMap.origin());
+        std::mt19937 fortRandom(1);
+        std::uniform_int_distribution<int> fortColumn(0, fortMap.columns() - 1);
+        std::uniform_int_distribution<int> fortRow(0, fortMap.rows() - 1);
+        std::uniform_int_distribution<int> fortQuarter(0, 3);
+        float fortHitTimer = 0.f;
+
+        /* Overlay text, refreshed once per second */
+        auto pFont = resourceManager.getFont("DefaultFont");
+        auto pTextShaderProgram = resourceManager.getShaderProgram("TextShaderProgram");
+        Renderer::TextBatch textBatch(pTextShaderProgram);
+        std::string overlayText = "OpenGL Training";
+        auto overlayStartTime = std::chrono::steady_clock::now();
+        unsigned int overlayFrames = 0;
+
         /* Create a Vertex Buffer Object with vertex coordinate data in video card memory */
         GLuint vertices_vbo = 0;    
         glGenBuffers(1, &vertices_vbo);     // Generate and return one unique identifier for a buffer
@@ -155,6 +294,10 @@ int main(int argc, char** argv)
         pSpriteShaderProgram->use();    // Activate shader program (make it current)
         pSpriteShaderProgram->setTexture("tex", 0);     // Link the texture stored in texture unit 0 to the shader program 
 
+        /* Link a texture to the sprite batch shader program */
+        pSpriteBatchShaderProgram->use();
+        pSpriteBatchShaderProgram->setTexture("tex", 0);
+
         /*  
         Create model matrices for transformation coordinates from local space to world space.
         Model matrix determines where the shape is located in OpenGL window
@@ -167,43 +310,230 @@ int main(int argc, char** argv)
 
         /*  
         Create a projection matrix for transormation coordinates from world space to clip space.
-        Projection matrix defines visible area(frustrum) in the space
+        Projection matrix defines visible area(frustrum) in the space: one unit per framebuffer pixel, like the cached layers
         */
-        glm::mat4x4 projectionMatrix = glm::ortho(0.f, static_cast<float>(gWindowSize.x), 0.f, static_cast<float>(gWindowSize.y), -100.f, 100.f);
-        
-        /* Link the projection matrix to the shader program */
-        pDefaultShaderProgram->use();
-        pDefaultShaderProgram->setMatrix4("projectionMat", projectionMatrix);
-
-        /* Link the projection matrix to the sprite shader program */
-        pSpriteShaderProgram->use();
-        pSpriteShaderProgram->setMatrix4("projectionMat", projectionMatrix);
-
-        /* Loop until the user closes the window */
-        while (!glfwWindowShouldClose(pWindow))
-        {
-            /* Render here */
-            glClear(GL_COLOR_BUFFER_BIT);
+        auto pTileMapShaderProgram = resourceManager.getShaderProgram("TileMapShaderProgram");
+        glm::ivec2 projectionSize = gFramebufferSize;
+        auto linkProjectionMatrix = [&](const glm::ivec2& size) {
+            const glm::mat4x4 projectionMatrix = glm::ortho(0.f, static_cast<float>(size.x), 0.f, static_cast<float>(size.y), -100.f, 100.f);
+
+            /* Link the projection matrix to the shader program */
+            pDefaultShaderProgram->use();
+            pDefaultShaderProgram->setMatrix4("projectionMat", projectionMatrix);
+
+            /* Link the projection matrix to the sprite shader program */
+            pSpriteShaderProgram->use();
+            pSpriteShaderProgram->setMatrix4("projectionMat", projectionMatrix);
+
+            /* Link the projection matrix to the sprite batch shader program */
+            pSpriteBatchShaderProgram->use();
+            pSpriteBatchShaderProgram->setMatrix4("projectionMat", projectionMatrix);
+
+            /* Link the projection matrix to the particle shader program */
+            pParticleShaderProgram->use();
+            pParticleShaderProgram->setMatrix4("projectionMat", projectionMatrix);
+            pGpuParticleShaderProgram->use();
+            pGpuParticleShaderProgram->setMatrix4("projectionMat", projectionMatrix);
+
+            /* Link the projection matrix to the tile map shader program */
+            pTileMapShaderProgram->use();
+            pTileMapShaderProgram->setMatrix4("projectionMat", projectionMatrix);
+
+            /* Link the projection matrix to the text shader program */
+            pTextShaderProgram->use();
+            pTextShaderProgram->setMatrix4("projectionMat", projectionMatrix);
+        };
+        linkProjectionMatrix(projectionSize);
+
+        /* The model matrix changes for every object, so its location is looked up once */
+        const GLint modelMatrixLocation = pDefaultShaderProgram->getUniformLocation("modelMat");
+
+        /*
+        The fort, the triangles and the sprite do not move: they form a static layer that is drawn into a cache once
+        and redrawn only where the fort changes. Its draw function sets the projection, as the cache has its own
+        */
+        Renderer::LayerStack layerStack(resourceManager.getShaderProgram("LayerCompositeShaderProgram"), gFramebufferSize);
+        const size_t staticLayer = layerStack.addLayer([&](const glm::mat4& layerProjectionMatrix) {
+            pTileMapShaderProgram->use();
+            pTileMapShaderProgram->setMatrix4("projectionMat", layerProjectionMatrix);
+            fortRenderer.render();
 
             /* Render an object */
             pDefaultShaderProgram->use();   // Activate shader program (make it current)
+            pDefaultShaderProgram->setMatrix4("projectionMat", layerProjectionMatrix);
             glBindVertexArray(vao);     // Make the vertex array current
             pDefaultTexture->bind();    // Make the texture bound to the texture unit current
 
-            pDefaultShaderProgram->setMatrix4("modelMat", modelMatrix_1);   // Link the model matrix to the shader program
+            pDefaultShaderProgram->setMatrix4(modelMatrixLocation, modelMatrix_1);   // Link the model matrix to the shader program
             glDrawArrays(GL_TRIANGLES, 0, 3);   // Render an object
 
-            pDefaultShaderProgram->setMatrix4("modelMat", modelMatrix_2);   // Link the model matrix to the shader program
+            pDefaultShaderProgram->setMatrix4(modelMatrixLocation, modelMatrix_2);   // Link the model matrix to the shader program
             glDrawArrays(GL_TRIANGLES, 0, 3);   // Rener an object
+            glBindVertexArray(0);
 
             /* Render a sprite */
+            pSpriteShaderProgram->use();
+            pSpriteShaderProgram->setMatrix4("projectionMat", layerProjectionMatrix);
             pSprite->render();
+            return 4u;
+        }, true);
+
+        /* Frames are read back asynchronously and written by the writer threads of the captures */
+        Renderer::FrameCapture screenshots("screenshot", Renderer::FrameCapture::Format::PNG_FILES, gFramebufferSize, 2);
+        std::unique_ptr <Renderer::FrameCapture> pRecording;
+
+        /* Frame time and allocation statistics, printed once per second in builds with allocation tracking */
+        auto statisticsStartTime = std::chrono::steady_clock::now();
+        unsigned int statisticsFrames = 0;
+        uint64_t statisticsAllocations = 0;
+        /* With --assert-no-allocations any allocation inside the frame aborts the program after the warm-up frames */
+        const bool isAllocationAssertionRequested = argc > 1 && std::string(argv[1]) == "--assert-no-allocations";
+        const unsigned int ALLOCATION_WARMUP_FRAMES = 60;
+        unsigned int frame = 0;
+        auto lastFrameTime = std::chrono::steady_clock::now();
+
+        /* Loop until the user closes the window */
+        while (!glfwWindowShouldClose(pWindow))
+        {
+            if (isAllocationAssertionRequested && ++frame == ALLOCATION_WARMUP_FRAMES) {
+                System::AllocationTracker::setHotScopeAssertions(true);
+            }
+            if (gIsMemoryReportRequested) {
+                resourceManager.writeMemoryReport(std::cout);
+                System::AllocationTracker::writeReport(std::cout);
+                gIsMemoryReportRequested = false;
+            }
+
+            /* New overlay text is laid out outside of the hot scope, as laying out new text allocates */
+            ++overlayFrames;
+            const double overlayMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - overlayStartTime).count();
+            if (overlayMilliseconds >= 1000.0) {
+                overlayText = "OpenGL Training\n" + std::to_string(static_cast<unsigned int>(overlayFrames * 1000.0 / overlayMilliseconds + 0.5)) + " FPS, "
+                            + std::to_string(fountain.size() + smoke.size()) + " particles\n"
+                            + (layerStack.isStatic(staticLayer) ? "Static layer cached (L), " : "Static layer drawn directly (L), ")
+                            + std::to_string(layerStack.lastFrame().savedDrawCalls) + " draw calls saved";
+                overlayStartTime = std::chrono::steady_clock::now();
+                overlayFrames = 0;
+            }
+            textBatch.add(*pFont, overlayText, glm::vec2(8.f, static_cast<float>(gFramebufferSize.y) - 8.f), glm::vec4(1.f, 1.f, 0.6f, 1.f));
+
+            /* Recreating the layer caches allocates, so it is done outside of the hot scope */
+            if (gIsLayerCachingToggled) {
+                layerStack.setStatic(staticLayer, !layerStack.isStatic(staticLayer));
+                gIsLayerCachingToggled = false;
+            }
+            /* After a resize the world keeps one unit per pixel, so the cached layers and the rest of the frame stay aligned */
+            if (projectionSize != gFramebufferSize) {
+                projectionSize = gFramebufferSize;
+                linkProjectionMatrix(projectionSize);
+            }
+            layerStack.setViewportSize(gFramebufferSize);
+
+            /* Creating, resizing and stopping captures allocates or waits for the writer, so it is done outside of the hot scope too */
+            screenshots.setFrameSize(gFramebufferSize);
+            if (gIsRecordingToggled) {
+                if (pRecording) {
+                    pRecording->finish();
+                    const Renderer::FrameCapture::Statistics statistics = pRecording->statistics();
+                    std::cout << "Recorded " << statistics.writtenFrames << " frames into capture.ppm, " << statistics.droppedFrames << " dropped" << std::endl;
+                    pRecording.reset();
+                }
+                else {
+                    pRecording = std::make_unique<Renderer::FrameCapture>("capture.ppm", Renderer::FrameCapture::Format::PPM_STREAM, gFramebufferSize);
+                }
+                gIsRecordingToggled = false;
+            }
+            if (pRecording) {
+                pRecording->setFrameSize(gFramebufferSize);
+            }
+
+            /* Steady-state frame work must not allocate */
+            {
+                ALLOCATION_HOT_SCOPE("frame");
+
+                /* Release the transient memory of the previous frame */
+                System::FrameArena::resetAll();
+                /* Start a new frame for the resource manager (texture residency bookkeeping) */
+                resourceManager.beginFrame();
+
+                /* Render here */
+                glClear(GL_COLOR_BUFFER_BIT);
+
+                /*
+                Hit a random cell of the fort: a quarter of a brick is chipped off, an empty cell gets a new brick. Only the cells
+                whose image or sub-cells changed are uploaded
+                */
+                const auto currentFrameTime = std::chrono::steady_clock::now();
+                const float deltaTime = std::chrono::duration<float>(currentFrameTime - lastFrameTime).count();
+                lastFrameTime = currentFrameTime;
+                for (fortHitTimer += deltaTime; fortHitTimer >= 0.1f; fortHitTimer -= 0.1f) {
+                    const int column = fortColumn(fortRandom);
+                    const int row = fortRow(fortRandom);
+                    const Scene::TileMap::TileType type = fortMap.getTile(column, row);
+                    if (type == BRICK) {
+                        const int quarter = fortQuarter(fortRandom);
+                        fortTiler.chipSubCells(column, row, static_cast<Scene::TileMap::SubCellMask>(0x0033 << ((quarter & 1) * 2 + (quarter >> 1) * 8)));
+                    }
+                    else if (type == Scene::TileMap::EMPTY_TILE) {
+                        fortTiler.setTile(column, row, BRICK);
+                    }
+                }
+                glm::ivec2 dirtyFirst, dirtyLast;
+                while (fortTiler.takeDirtyRect(dirtyFirst, dirtyLast)) {
+                    fortRenderer.uploadRegion(fortTiler.images(), dirtyFirst, dirtyLast);
+                    fortRenderer.uploadSubCellsRegion(fortMap.subCells(), dirtyFirst, dirtyLast);
+                    layerStack.invalidate(staticLayer, fortMap.cellPosition(dirtyFirst.x, dirtyFirst.y), fortMap.cellPosition(dirtyLast.x + 1, dirtyLast.y + 1));
+                }
+                /* Draw the static layer from its cache, only the changed part of the fort is redrawn into it */
+                layerStack.render(glm::vec2(0.f));
+
+                /* Move and animate the entities and render them with one draw call per texture */
+                ECS::integrateMotion(world, deltaTime);
+                ECS::updateAnimations(world, resourceManager.getAnimationLibrary(), deltaTime);
+                ECS::extractSprites(world, spriteBatch);
+                spriteBatch.render();
+
+                /* Simulate and render the particles */
+                fountain.update(deltaTime);
+                fountain.render();
+                smoke.update(deltaTime);
+                smoke.render();
+
+                /* Render the overlay text with one draw call per font page */
+                textBatch.render();
+
+                /* Start the readbacks of the frame, the ones finished since the previous frames go to the writers */
+                if (gIsScreenshotRequested) {
+                    screenshots.capture();
+                    gIsScreenshotRequested = false;
+                }
+                else {
+                    screenshots.update();
+                }
+                if (pRecording) {
+                    pRecording->capture();
+                }
+            }
 
             /* Swap front and back buffers */
             glfwSwapBuffers(pWindow);
 
             /* Poll for and process events */
             glfwPollEvents();
+
+            System::AllocationTracker::endFrame();
+            if (System::AllocationTracker::isEnabled()) {
+                ++statisticsFrames;
+                statisticsAllocations += System::AllocationTracker::lastFrame().allocations;
+                const double elapsedMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - statisticsStartTime).count();
+                if (elapsedMilliseconds >= 1000.0) {
+                    std::cout << "Frame time: " << elapsedMilliseconds / statisticsFrames << " ms, "
+                              << static_cast<double>(statisticsAllocations) / statisticsFrames << " allocations per frame\n";
+                    statisticsStartTime = std::chrono::steady_clock::now();
+                    statisticsFrames = 0;
+                    statisticsAllocations = 0;
+                }
+            }
         }
     }
     